@@ -69,6 +69,7 @@ LOCAL_SRC_FILES :=  main/gemrb/plugins/SAVImporter/SAVImporter.cpp \
 		    main/gemrb/plugins/TLKImporter/TlkOverride.cpp \
 		    main/gemrb/plugins/BIKPlayer/dct.cpp \
 		    main/gemrb/plugins/BIKPlayer/BIKPlayer.cpp \
+		    main/gemrb/plugins/BIKPlayer/binkdsp.cpp \
 		    main/gemrb/plugins/BIKPlayer/rational.cpp \
 		    main/gemrb/plugins/BIKPlayer/mem.cpp \
 		    main/gemrb/plugins/BIKPlayer/GetBitContext.cpp \
@@ -138,6 +139,7 @@ LOCAL_SRC_FILES :=  main/gemrb/plugins/SAVImporter/SAVImporter.cpp \
 		    main/gemrb/core/WorldMapMgr.cpp \
 		    main/gemrb/core/Spellbook.cpp \
 		    main/gemrb/core/Factory.cpp \
+		    main/gemrb/core/FlowField.cpp \
 		    main/gemrb/core/TileSetMgr.cpp \
 		    main/gemrb/core/SymbolMgr.cpp \
 		    main/gemrb/core/DialogMgr.cpp \
@@ -146,6 +148,7 @@ LOCAL_SRC_FILES :=  main/gemrb/plugins/SAVImporter/SAVImporter.cpp \
 		    main/gemrb/core/Sprite2D.cpp \
 		    main/gemrb/core/Dialog.cpp \
 		    main/gemrb/core/Calendar.cpp \
+		    main/gemrb/core/Benchmark.cpp \
 		    main/gemrb/core/DialogHandler.cpp \
 		    main/gemrb/core/RNG.cpp \
 		    main/gemrb/core/System/Logger.cpp \
@@ -155,6 +158,7 @@ LOCAL_SRC_FILES :=  main/gemrb/plugins/SAVImporter/SAVImporter.cpp \
 		    main/gemrb/core/System/Logger/Android.cpp \
 		    main/gemrb/core/System/StringBuffer.cpp \
 		    main/gemrb/core/System/VFS.cpp \
+		    main/gemrb/core/System/WorkerPool.cpp \
 		    main/gemrb/core/System/String.cpp \
 		    main/gemrb/core/System/Logging.cpp \
 		    main/gemrb/core/System/FileStream.cpp \
@@ -162,10 +166,12 @@ LOCAL_SRC_FILES :=  main/gemrb/plugins/SAVImporter/SAVImporter.cpp \
 		    main/gemrb/core/System/MemoryStream.cpp \
 		    main/gemrb/core/System/DataStream.cpp \
 		    main/gemrb/core/System/SlicedStream.cpp \
+		    main/gemrb/core/System/SpanReader.cpp \
 		    main/gemrb/core/ResourceDesc.cpp \
 		    main/gemrb/core/Item.cpp \
 		    main/gemrb/core/SaveGameIterator.cpp \
 		    main/gemrb/core/ArchiveImporter.cpp \
+		    main/gemrb/core/AreaDigest.cpp \
 		    main/gemrb/core/StringMgr.cpp \
 		    main/gemrb/core/ControlAnimation.cpp \
 		    main/gemrb/core/Region.cpp \
@@ -235,7 +241,6 @@ LOCAL_SRC_FILES :=  main/gemrb/plugins/SAVImporter/SAVImporter.cpp \
 		    main/gemrb/core/ImageWriter.cpp \
 		    main/gemrb/core/Interface.cpp \
 		    main/gemrb/core/InterfaceConfig.cpp \
-		    main/gemrb/core/Cache.cpp \
 		    main/gemrb/core/FileCache.cpp \
 		    main/gemrb/core/Palette.cpp \
 		    main/gemrb/core/System/swab.c \
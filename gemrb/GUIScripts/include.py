@@ -23,3 +23,6 @@ def ci(item, slot=-1, c0=1, c1=0, c2=0):
 
 def cv(var, context="GLOBAL"):
 	GemRB.CheckVar(var, context)
+
+def prof(enable=1):
+	GemRB.ProfileScripts(enable)
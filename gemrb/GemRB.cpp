@@ -98,8 +98,8 @@ int main(int argc, char* argv[])
     SDL_ANDROID_SetApplicationPutToBackgroundCallback(&appPutToBackground, &appPutToForeground);
 #endif
 #endif
-	core->Main();
+	int ret = core->Main() == GEM_OK ? 0 : 1;
 	delete( core );
 	ShutdownLogging();
-	return 0;
+	return ret;
 }
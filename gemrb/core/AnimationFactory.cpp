@@ -27,6 +27,9 @@
 
 namespace GemRB {
 
+// past this many colourings of one paperdoll, those nobody shows anymore are dropped
+#define PAPERDOLL_CACHE_LIMIT 16
+
 AnimationFactory::AnimationFactory(const char* ResRef)
 	: FactoryObject( ResRef, IE_BAM_CLASS_ID )
 {
@@ -37,6 +40,10 @@ AnimationFactory::AnimationFactory(const char* ResRef)
 
 AnimationFactory::~AnimationFactory(void)
 {
+	for (auto& doll : paperdolls) {
+		doll.second.top->release();
+		doll.second.bottom->release();
+	}
 	for (unsigned int i = 0; i < frames.size(); i++) {
 		frames[i]->release();
 	}
@@ -142,31 +149,59 @@ Sprite2D* AnimationFactory::GetPaperdollImage(ieDword *Colors,
 		return NULL;
 	}
 
+	// the inventory and record screens ask for the same party paperdolls over
+	// and over, so each set of gradients is only coloured once; the type only
+	// matters through the gradients it picks
+	std::string key = "plain";
+	if (Colors) {
+		unsigned int s = Clamp<ieDword>(8*type, 0, 8*sizeof(ieDword)-1);
+		key.resize(7);
+		for (int i = 0; i < 7; i++) {
+			key[i] = (char) ((Colors[i]>>s)&0xFF);
+		}
+	}
+	std::map<std::string, Paperdoll>::iterator cached = paperdolls.find(key);
+	if (cached != paperdolls.end()) {
+		Picture2 = cached->second.bottom;
+		Picture2->acquire();
+		cached->second.top->acquire();
+		return cached->second.top;
+	}
+
 	Picture2 = frames[second]->copy();
 	if (!Picture2) {
 		return NULL;
 	}
+	Sprite2D* spr = frames[first]->copy();
 	if (Colors) {
-		Palette* palette = Picture2->GetPalette();
+		// both halves share one palette, so it is only set up once
+		Palette* palette = Picture2->GetPalette()->Copy();
 		palette->SetupPaperdollColours(Colors, type);
 		Picture2->SetPalette(palette);
+		spr->SetPalette(palette);
 		palette->release();
 	}
 
 	Picture2->XPos = (short)frames[second]->XPos;
 	Picture2->YPos = (short)frames[second]->YPos - 80;
-
-	Sprite2D* spr = frames[first]->copy();
-	if (Colors) {
-		Palette* palette = spr->GetPalette();
-		palette->SetupPaperdollColours(Colors, type);
-		spr->SetPalette(palette);
-		palette->release();
-	}
-
 	spr->XPos = (short)frames[first]->XPos;
 	spr->YPos = (short)frames[first]->YPos;
 
+	if (paperdolls.size() >= PAPERDOLL_CACHE_LIMIT) {
+		for (auto it = paperdolls.begin(); it != paperdolls.end();) {
+			if (it->second.top->IsShared() || it->second.bottom->IsShared()) {
+				++it;
+				continue;
+			}
+			it->second.top->release();
+			it->second.bottom->release();
+			it = paperdolls.erase(it);
+		}
+	}
+	// one reference for the cache, one for the caller
+	spr->acquire();
+	Picture2->acquire();
+	paperdolls[key] = { spr, Picture2 };
 	return spr;
 }
 
@@ -28,6 +28,9 @@
 #include "AnimStructures.h"
 #include "FactoryObject.h"
 
+#include <map>
+#include <string>
+
 namespace GemRB {
 
 class GEM_EXPORT AnimationFactory : public FactoryObject {
@@ -37,6 +40,12 @@ private:
 	unsigned short* FLTable;	// Frame Lookup Table
 	unsigned char* FrameData;
 	int datarefcount;
+	// coloured paperdoll halves by the gradients they use, see GetPaperdollImage
+	struct Paperdoll {
+		Sprite2D* top;
+		Sprite2D* bottom;
+	};
+	mutable std::map<std::string, Paperdoll> paperdolls;
 public:
 	AnimationFactory(const char* ResRef);
 	~AnimationFactory(void);
@@ -51,6 +60,8 @@ public:
 	size_t GetCycleCount() const { return cycles.size(); }
 	size_t GetFrameCount() const { return frames.size(); }
 	int GetCycleSize(int idx) const { return cycles[idx].FramesCount; }
+	/** the returned halves may be shared with earlier callers, so they
+	 * must not be changed */
 	Sprite2D* GetPaperdollImage(ieDword *Colors, Sprite2D *&Picture2,
 		unsigned int type) const;
 
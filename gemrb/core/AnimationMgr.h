@@ -37,6 +37,10 @@ public:
 	virtual ~AnimationMgr(void);
 	virtual bool Open(DataStream* stream) = 0;
 	virtual int GetCycleSize(unsigned char Cycle) = 0;
+	/** decodes the frames into memory, so GetAnimationFactory only has to
+	 * make the sprites; it doesn't touch the video driver, so it can run
+	 * on a worker thread */
+	virtual void DecodeFrames(bool allowCompression) = 0;
 	virtual AnimationFactory* GetAnimationFactory(const char* ResRef,
 		unsigned char mode = IE_NORMAL, bool allowCompression = true) = 0;
 	/** Debug Function: Returns the Global Animation Palette as a Sprite2D Object.
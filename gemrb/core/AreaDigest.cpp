@@ -0,0 +1,211 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+#include "AreaDigest.h"
+
+#include "Bitmap.h"
+#include "GameData.h"
+#include "Image.h"
+#include "ImageMgr.h"
+#include "Interface.h"
+#include "System/FileStream.h"
+
+#include <cstdio>
+
+namespace GemRB {
+
+bool AreaDigest::Enabled = true;
+
+static const char DigestSignature[8] = { 'A', 'R', 'E', 'A', 'D', 'I', 'G', ' ' };
+// a digest written on a machine of the other endianness won't match this
+#define DIGEST_BYTE_ORDER 0x01020304
+// size and hash for each of the light, search and height map
+#define DIGEST_HASHES 6
+// anything bigger is a corrupt file, not an area
+#define DIGEST_MAX_SIDE 4096
+
+struct DigestHeader {
+	char signature[8];
+	ieDword version;
+	ieDword byteOrder;
+	ieDword hashes[DIGEST_HASHES];
+	ieDword sizes[6]; // width and height of each map
+};
+
+// size and FNV-1a hash of a bitmap resource, both zero if it is missing
+static void HashResource(const char* resRef, ieDword* hash)
+{
+	hash[0] = hash[1] = 0;
+	DataStream* str = gamedata->GetResource(resRef, IE_BMP_CLASS_ID, true);
+	if (!str) {
+		return;
+	}
+	unsigned long left = str->Size();
+	ieDword h = 2166136261u;
+	unsigned char chunk[16384];
+	while (left) {
+		unsigned int len = (unsigned int) std::min<unsigned long>(left, sizeof(chunk));
+		if (str->Read(chunk, len) != (int) len) {
+			delete str;
+			return;
+		}
+		for (unsigned int i = 0; i < len; i++) {
+			h = (h ^ chunk[i]) * 16777619u;
+		}
+		left -= len;
+	}
+	hash[0] = str->Size();
+	hash[1] = h;
+	delete str;
+}
+
+AreaDigest::AreaDigest()
+{
+	lightMap = NULL;
+	searchMap = NULL;
+	heightMap = NULL;
+	hit = false;
+}
+
+AreaDigest::~AreaDigest()
+{
+	delete lightMap;
+	delete searchMap;
+	delete heightMap;
+}
+
+void AreaDigest::Load(const char* lightRef, const char* searchRef, const char* heightRef)
+{
+	hit = false;
+	if (!Enabled) {
+		Decode(lightRef, searchRef, heightRef);
+		return;
+	}
+
+	ieDword hashes[DIGEST_HASHES];
+	HashResource(lightRef, hashes);
+	HashResource(searchRef, hashes + 2);
+	HashResource(heightRef, hashes + 4);
+	// missing or not a bmp (eg. a png override), nothing to key on
+	if (!hashes[0] || !hashes[2] || !hashes[4]) {
+		Decode(lightRef, searchRef, heightRef);
+		return;
+	}
+
+	char path[_MAX_PATH];
+	PathJoinExt(path, core->CachePath, lightRef, "dig");
+	if (ReadDigest(path, hashes)) {
+		hit = true;
+		return;
+	}
+	Decode(lightRef, searchRef, heightRef);
+	if (lightMap && searchMap && heightMap) {
+		WriteDigest(path, hashes);
+	}
+}
+
+void AreaDigest::Decode(const char* lightRef, const char* searchRef, const char* heightRef)
+{
+	ResourceHolder<ImageMgr> lm = GetResourceHolder<ImageMgr>(lightRef, true);
+	lightMap = lm ? lm->GetImage() : NULL;
+	ResourceHolder<ImageMgr> sr = GetResourceHolder<ImageMgr>(searchRef, true);
+	searchMap = sr ? sr->GetBitmap() : NULL;
+	ResourceHolder<ImageMgr> hm = GetResourceHolder<ImageMgr>(heightRef, true);
+	heightMap = hm ? hm->GetBitmap() : NULL;
+}
+
+bool AreaDigest::ReadDigest(const char* path, const ieDword* hashes)
+{
+	FileStream* str = FileStream::OpenFile(path);
+	if (!str) {
+		return false;
+	}
+
+	DigestHeader header;
+	bool good = str->Read(&header, sizeof(header)) == (int) sizeof(header)
+		&& !memcmp(header.signature, DigestSignature, sizeof(DigestSignature))
+		&& header.version == AREA_DIGEST_VERSION
+		&& header.byteOrder == DIGEST_BYTE_ORDER
+		&& !memcmp(header.hashes, hashes, sizeof(header.hashes));
+	for (int i = 0; good && i < 6; i++) {
+		good = header.sizes[i] && header.sizes[i] <= DIGEST_MAX_SIDE;
+	}
+	if (!good) {
+		delete str;
+		return false;
+	}
+
+	Image* light = new Image(header.sizes[0], header.sizes[1]);
+	Bitmap* search = new Bitmap(header.sizes[2], header.sizes[3]);
+	Bitmap* height = new Bitmap(header.sizes[4], header.sizes[5]);
+	unsigned int lightSize = header.sizes[0] * header.sizes[1] * sizeof(Color);
+	unsigned int searchSize = header.sizes[2] * header.sizes[3];
+	unsigned int heightSize = header.sizes[4] * header.sizes[5];
+	good = str->Read(light->GetData(), lightSize) == (int) lightSize
+		&& str->Read(search->GetData(), searchSize) == (int) searchSize
+		&& str->Read(height->GetData(), heightSize) == (int) heightSize;
+	delete str;
+	if (!good) {
+		delete light;
+		delete search;
+		delete height;
+		return false;
+	}
+
+	lightMap = light;
+	searchMap = search;
+	heightMap = height;
+	return true;
+}
+
+// written next to the final name first, so a crash can't leave half a digest behind
+void AreaDigest::WriteDigest(const char* path, const ieDword* hashes) const
+{
+	char tmpPath[_MAX_PATH];
+	snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+	DigestHeader header;
+	memcpy(header.signature, DigestSignature, sizeof(DigestSignature));
+	header.version = AREA_DIGEST_VERSION;
+	header.byteOrder = DIGEST_BYTE_ORDER;
+	memcpy(header.hashes, hashes, sizeof(header.hashes));
+	header.sizes[0] = lightMap->GetWidth();
+	header.sizes[1] = lightMap->GetHeight();
+	header.sizes[2] = searchMap->GetWidth();
+	header.sizes[3] = searchMap->GetHeight();
+	header.sizes[4] = heightMap->GetWidth();
+	header.sizes[5] = heightMap->GetHeight();
+
+	{
+		FileStream str;
+		if (!str.Create(tmpPath)) {
+			return;
+		}
+		str.Write(&header, sizeof(header));
+		str.Write(lightMap->GetData(), header.sizes[0] * header.sizes[1] * sizeof(Color));
+		str.Write(searchMap->GetData(), header.sizes[2] * header.sizes[3]);
+		str.Write(heightMap->GetData(), header.sizes[4] * header.sizes[5]);
+	}
+	remove(path);
+	if (rename(tmpPath, path)) {
+		remove(tmpPath);
+	}
+}
+
+}
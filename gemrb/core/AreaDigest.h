@@ -0,0 +1,77 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+/**
+ * @file AreaDigest.h
+ * Declares AreaDigest, the decoded area bitmaps kept in the cache directory
+ * @author The GemRB Project
+ */
+
+#ifndef AREADIGEST_H
+#define AREADIGEST_H
+
+#include "exports.h"
+#include "ie_types.h"
+
+namespace GemRB {
+
+class Bitmap;
+class Image;
+
+// bump whenever the layout of the digest files changes
+#define AREA_DIGEST_VERSION 1
+
+/**
+ * @class AreaDigest
+ * The light, search and height maps of an area, decoded once and then
+ * kept in the cache directory between runs. Each is stored along with a
+ * hash of the file it came from, so a changed resource or a new format
+ * version just makes the digest miss and get rewritten.
+ * Load runs on the area loading workers: its lookups go through the
+ * ResourceManager lock and the only file it writes is its own.
+ */
+
+class GEM_EXPORT AreaDigest {
+public:
+	/** the AreaDigests config option, otherwise the maps are always decoded */
+	static bool Enabled;
+
+	Image* lightMap;
+	Bitmap* searchMap;
+	Bitmap* heightMap;
+
+	AreaDigest();
+	/** frees the maps nobody took */
+	~AreaDigest();
+	/** fills in the maps, from the digest if it is still good; a map that
+	 * can't be loaded is left NULL */
+	void Load(const char* lightRef, const char* searchRef, const char* heightRef);
+	/** true if the last Load came from the digest */
+	bool FromDigest() const { return hit; }
+private:
+	bool hit;
+
+	bool ReadDigest(const char* path, const ieDword* hashes);
+	void WriteDigest(const char* path, const ieDword* hashes) const;
+	void Decode(const char* lightRef, const char* searchRef, const char* heightRef);
+};
+
+}
+
+#endif
@@ -0,0 +1,1515 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "Benchmark.h"
+
+#include "win32def.h"
+
+#include "ActorMgr.h"
+#include "Ambient.h"
+#include "AnimationFactory.h"
+#include "AreaDigest.h"
+#include "Bitmap.h"
+#include "CharAnimations.h"
+#include "FlowField.h"
+#include "Game.h"
+#include "GameData.h"
+#include "Image.h"
+#include "ImageMgr.h"
+#include "Interface.h"
+#include "Map.h"
+#include "MapMgr.h"
+#include "MoviePlayer.h"
+#include "PalettedImageMgr.h"
+#include "PluginMgr.h"
+#include "ProjectileServer.h"
+#include "RNG.h"
+#include "SaveGameIterator.h"
+#include "SaveGameMgr.h"
+#include "SoundMgr.h"
+#include "Sprite2D.h"
+#include "StringMgr.h"
+#include "Tile.h"
+#include "TileMap.h"
+#include "TileOverlay.h"
+#include "TileSetMgr.h"
+#include "Video.h"
+#include "System/VFS.h"
+#include "System/WorkerPool.h"
+#include "GameScript/GameScript.h"
+#include "GUI/MapControl.h"
+#include "GUI/TextArea.h"
+#include "GUI/Window.h"
+#include "Scriptable/Actor.h"
+#include "Scriptable/Container.h"
+#include "Scriptable/Door.h"
+#include "Scriptable/InfoPoint.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace GemRB {
+
+// how many times the load benchmarks load their resource
+#define LOAD_REPEATS 10
+// how many game ticks the tick benchmark runs, a minute and a half of game time
+#define BENCHMARK_TICKS 1500
+// how many ticks the tick benchmarks run before timing, so loading the game isn't timed
+#define BENCHMARK_WARMUP 100
+// the rng is reseeded with this, so every run makes the same rolls
+#define BENCHMARK_SEED 0x5EED
+// the group the flow benchmark moves: a party and a horde chasing it
+#define BENCHMARK_PARTY 6
+#define BENCHMARK_HORDE 40
+// how many ticks the flow benchmark lets the group walk
+#define BENCHMARK_FLOW_TICKS 300
+// how many samples the sound benchmark decodes per read
+#define BENCHMARK_CHUNK 4096
+// the speed of the glow the recolour benchmark pulses its crowd with
+#define BENCHMARK_PULSE 30
+// how many gradient combinations the paperdoll benchmark checks
+#define BENCHMARK_GRADIENTS 32
+// the tile budget of the tile benchmark in kilobytes, a few dozen tiles
+#define BENCHMARK_TILE_BUDGET 160
+// the projectile benchmark casts this many area spells, one every few frames,
+// and gives up on them after the given number of frames
+#define BENCHMARK_CASTS 24
+#define BENCHMARK_CAST_EVERY 4
+#define BENCHMARK_CAST_FRAMES 1000
+
+bool SectionTimer::Enabled = false;
+double SectionTimer::Totals[BENCH_SECTION_COUNT];
+
+static const char* const SectionNames[BENCH_SECTION_COUNT] = {
+	"scripts", "effects", "movement", "pathfinding", "drawing"
+};
+
+// arg is whatever followed a colon in the benchmark name, NULL if there was none
+typedef bool (*BenchmarkFunction)(const char* arg);
+
+struct BenchmarkEntry {
+	const char* name;
+	BenchmarkFunction run;
+};
+
+// fetches every string of dialog.tlk twice, so the second pass shows the cached cost
+static bool BenchmarkStrings(const char* /*arg*/)
+{
+	ieDword count = core->strings->GetStrRefCount();
+	if (!count) {
+		Log(ERROR, "Benchmark", "No strings to fetch!");
+		return false;
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		BenchmarkTimer timer;
+		size_t chars = 0;
+		for (ieStrRef strref = 0; strref < count; strref++) {
+			String* string = core->GetString(strref, IE_STR_STRREFOFF);
+			chars += string->length();
+			delete string;
+		}
+		double elapsed = timer.Elapsed();
+		Log(MESSAGE, "Benchmark", "tlk pass %d: %u strings (%lu characters) in %.2fms, %.3fus per string",
+			pass + 1, count, (unsigned long) chars, elapsed, elapsed * 1000 / count);
+	}
+	return true;
+}
+
+// feeds a message window style text area a long combat log, which keeps trimming its history
+static bool BenchmarkTextArea(const char* /*arg*/)
+{
+	Font* font = core->GetTextFont();
+	if (!font) {
+		Log(ERROR, "Benchmark", "No text font to lay out with!");
+		return false;
+	}
+
+	TextArea ta(Region(0, 0, 600, 100), font);
+	ta.Flags |= IE_GUI_TEXTAREA_HISTORY | IE_GUI_TEXTAREA_AUTOSCROLL;
+
+	const int batches = 10;
+	const int batchSize = 5000;
+	for (int batch = 0; batch < batches; batch++) {
+		BenchmarkTimer timer;
+		for (int i = 0; i < batchSize; i++) {
+			wchar_t line[128];
+			swprintf(line, 128, L"[color=ffd700]Fighter %d[/color] - Attack Roll %d + %d = %d : Hit\n",
+				i % 6, i % 20 + 1, batch, i % 20 + 1 + batch);
+			ta.AppendText(String(line));
+		}
+		double elapsed = timer.Elapsed();
+		Log(MESSAGE, "Benchmark", "textarea batch %d: %d lines in %.2fms, %.3fus per line",
+			batch + 1, batchSize, elapsed, elapsed * 1000 / batchSize);
+	}
+	return true;
+}
+
+static void LogLoads(const char* what, const char* resRef, const BenchmarkTimer& timer)
+{
+	double elapsed = timer.Elapsed();
+	Log(MESSAGE, "Benchmark", "%s %s: %d loads in %.2fms, %.3fms per load",
+		what, resRef, LOAD_REPEATS, elapsed, elapsed / LOAD_REPEATS);
+}
+
+// loads a GAM file with its party creatures, the default game if no resref is given
+static bool BenchmarkGameLoad(const char* arg)
+{
+	const char* resRef = arg ? arg : core->GameNameResRef;
+	BenchmarkTimer timer;
+	for (int i = 0; i < LOAD_REPEATS; i++) {
+		PluginHolder<SaveGameMgr> gm(IE_GAM_CLASS_ID);
+		DataStream* str = gm ? gamedata->GetResource(resRef, IE_GAM_CLASS_ID) : NULL;
+		// the importer owns the stream once it is opened
+		if (!gm || !str || !gm->Open(str)) {
+			Log(ERROR, "Benchmark", "Cannot open game %s!", resRef);
+			return false;
+		}
+		Game* game = gm->LoadGame(new Game());
+		if (!game) {
+			Log(ERROR, "Benchmark", "Cannot load game %s!", resRef);
+			return false;
+		}
+		delete game;
+	}
+	LogLoads("gam", resRef, timer);
+	return true;
+}
+
+static bool SameImage(const Image* a, const Image* b)
+{
+	return a && b && a->GetWidth() == b->GetWidth() && a->GetHeight() == b->GetHeight()
+		&& !memcmp(a->GetData(), b->GetData(), a->GetWidth() * a->GetHeight() * sizeof(Color));
+}
+
+static bool SameBitmap(const Bitmap* a, const Bitmap* b)
+{
+	return a && b && a->GetWidth() == b->GetWidth() && a->GetHeight() == b->GetHeight()
+		&& !memcmp(a->GetData(), b->GetData(), a->GetWidth() * a->GetHeight());
+}
+
+static bool SameSprite(const Sprite2D* a, const Sprite2D* b)
+{
+	if (!a || !b) {
+		return a == b;
+	}
+	return a->Width == b->Width && a->Height == b->Height && a->Bpp == b->Bpp
+		&& !memcmp(a->pixels, b->pixels, a->Width * a->Height * (a->Bpp / 8));
+}
+
+// objects are loaded in file order and their global ids handed out as they go,
+// so relative to the map's own id they come out the same on every load
+static bool SameScriptable(const Map* aMap, const Scriptable* a, const Map* bMap, const Scriptable* b)
+{
+	return a && b && !strcmp(a->GetScriptName(), b->GetScriptName()) && a->Pos == b->Pos
+		&& a->GetGlobalID() - aMap->GetGlobalID() == b->GetGlobalID() - bMap->GetGlobalID();
+}
+
+static bool SameCells(const Map* a, const Map* b)
+{
+	for (int y = 0; y < a->GetHeight(); y++) {
+		for (int x = 0; x < a->GetWidth(); x++) {
+			if (a->GetInternalSearchMap(x, y) != b->GetInternalSearchMap(x, y)
+				|| a->GetMaterial(x, y) != b->GetMaterial(x, y)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool SameActors(const Map* a, const Map* b)
+{
+	if (a->GetActorCount(true) != b->GetActorCount(true)) {
+		return false;
+	}
+	for (int i = 0; i < a->GetActorCount(true); i++) {
+		const Actor* actorA = a->GetActor(i, true);
+		const Actor* actorB = b->GetActor(i, true);
+		if (!SameScriptable(a, actorA, b, actorB) || actorA->GetOrientation() != actorB->GetOrientation()
+			|| memcmp(actorA->BaseStats, actorB->BaseStats, sizeof(actorA->BaseStats))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool SameRegions(const Map* aMap, TileMap* a, const Map* bMap, TileMap* b)
+{
+	if (a->GetDoorCount() != b->GetDoorCount() || a->GetContainerCount() != b->GetContainerCount()
+		|| a->GetInfoPointCount() != b->GetInfoPointCount()) {
+		return false;
+	}
+	for (unsigned int i = 0; i < a->GetDoorCount(); i++) {
+		if (!SameScriptable(aMap, a->GetDoor(i), bMap, b->GetDoor(i))) return false;
+	}
+	for (unsigned int i = 0; i < a->GetContainerCount(); i++) {
+		if (!SameScriptable(aMap, a->GetContainer(i), bMap, b->GetContainer(i))) return false;
+	}
+	for (unsigned int i = 0; i < a->GetInfoPointCount(); i++) {
+		if (!SameScriptable(aMap, a->GetInfoPoint(i), bMap, b->GetInfoPoint(i))) return false;
+	}
+	return true;
+}
+
+static bool SameExtras(Map* a, Map* b)
+{
+	if (a->GetAnimationCount() != b->GetAnimationCount() || a->GetEntranceCount() != b->GetEntranceCount()
+		|| a->GetAmbientCount() != b->GetAmbientCount() || a->GetSpawnCount() != b->GetSpawnCount()
+		|| a->GetMapNoteCount() != b->GetMapNoteCount() || a->GetWallCount() != b->GetWallCount()) {
+		return false;
+	}
+	aniIterator iterA = a->GetFirstAnimation();
+	aniIterator iterB = b->GetFirstAnimation();
+	while (const AreaAnimation* animA = a->GetNextAnimation(iterA)) {
+		const AreaAnimation* animB = b->GetNextAnimation(iterB);
+		if (!animB || animA->Pos != animB->Pos || strnicmp(animA->BAM, animB->BAM, 8)
+			|| animA->animcount != animB->animcount) {
+			return false;
+		}
+	}
+	for (int i = 0; i < a->GetEntranceCount(); i++) {
+		const Entrance* entA = a->GetEntrance(i);
+		const Entrance* entB = b->GetEntrance(i);
+		if (strcmp(entA->Name, entB->Name) || entA->Pos != entB->Pos || entA->Face != entB->Face) {
+			return false;
+		}
+	}
+	for (unsigned int i = 0; i < a->GetAmbientCount(); i++) {
+		const Ambient* ambA = a->GetAmbient(i);
+		const Ambient* ambB = b->GetAmbient(i);
+		if (strcmp(ambA->getName(), ambB->getName()) || ambA->getOrigin() != ambB->getOrigin()) {
+			return false;
+		}
+	}
+	for (unsigned int i = 0; i < a->GetSpawnCount(); i++) {
+		if (strcmp(a->GetSpawn(i)->Name, b->GetSpawn(i)->Name) || a->GetSpawn(i)->Pos != b->GetSpawn(i)->Pos) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// compares two loads of the same area and logs the first part that differs
+static bool SameMap(Map* a, Map* b, const char* what)
+{
+	const char* diff = NULL;
+	if (a->AreaFlags != b->AreaFlags || a->AreaType != b->AreaType || a->Rain != b->Rain
+		|| a->Snow != b->Snow || a->Fog != b->Fog || a->Lightning != b->Lightning
+		|| a->version != b->version || a->DayNight != b->DayNight || strnicmp(a->WEDResRef, b->WEDResRef, 8)) {
+		diff = "header";
+	} else if (a->GetWidth() != b->GetWidth() || a->GetHeight() != b->GetHeight()) {
+		diff = "size";
+	} else if (!SameImage(a->LightMap, b->LightMap)) {
+		diff = "light map";
+	} else if (!SameBitmap(a->HeightMap, b->HeightMap)) {
+		diff = "height map";
+	} else if (!SameSprite(a->GetSmallMap(), b->GetSmallMap())) {
+		diff = "small map";
+	} else if (!SameCells(a, b)) {
+		diff = "search map";
+	} else if (!SameActors(a, b)) {
+		diff = "actors";
+	} else if (!SameRegions(a, a->GetTileMap(), b, b->GetTileMap())) {
+		diff = "doors, containers or regions";
+	} else if (!SameExtras(a, b)) {
+		diff = "animations, entrances, ambients, spawns, notes or walls";
+	}
+	if (diff) {
+		Log(ERROR, "Benchmark", "%s: the %s differ!", what, diff);
+	}
+	return !diff;
+}
+
+// areas can't exist without a game, so this starts the default one first
+static const Game* StartDefaultGame()
+{
+	if (!core->GetGame()) {
+		core->LoadGame(NULL, 0);
+	}
+	const Game* game = core->GetGame();
+	if (!game) {
+		Log(ERROR, "Benchmark", "Cannot load the default game!");
+	}
+	return game;
+}
+
+static Map* LoadArea(const char* resRef)
+{
+	PluginHolder<MapMgr> mM(IE_ARE_CLASS_ID);
+	DataStream* str = mM ? gamedata->GetResource(resRef, IE_ARE_CLASS_ID) : NULL;
+	// the importer owns the stream once it is opened
+	if (!mM || !str || !mM->Open(str)) {
+		Log(ERROR, "Benchmark", "Cannot open area %s!", resRef);
+		return NULL;
+	}
+	Map* map = mM->GetMap(resRef, false);
+	if (!map) {
+		Log(ERROR, "Benchmark", "Cannot load area %s!", resRef);
+	}
+	return map;
+}
+
+// loads an area with its parts read on the workers and then with everything
+// on the main thread, the last loads of both must come out the same
+// if no resref is given, the starting area of the default game is loaded
+static bool BenchmarkAreaLoad(const char* arg)
+{
+	const Game* game = StartDefaultGame();
+	if (!game) {
+		return false;
+	}
+	const char* resRef = arg ? arg : game->CurrentArea;
+
+	Map* maps[2] = { NULL, NULL };
+	for (int pass = 0; pass < 2; pass++) {
+		WorkerPool::Serial = pass == 1;
+		BenchmarkTimer timer;
+		for (int i = 0; i < LOAD_REPEATS; i++) {
+			delete maps[pass];
+			maps[pass] = LoadArea(resRef);
+			if (!maps[pass]) {
+				break;
+			}
+		}
+		WorkerPool::Serial = false;
+		if (!maps[pass]) {
+			delete maps[0];
+			return false;
+		}
+		LogLoads(pass ? "are serial" : "are threaded", resRef, timer);
+	}
+
+	bool ok = SameMap(maps[1], maps[0], "are");
+	delete maps[0];
+	delete maps[1];
+	return ok;
+}
+
+static bool BenchmarkCreatureLoad(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the creature to load, eg. cre:charbase!");
+		return false;
+	}
+
+	BenchmarkTimer timer;
+	for (int i = 0; i < LOAD_REPEATS; i++) {
+		Actor* actor = gamedata->GetCreature(arg);
+		if (!actor) {
+			Log(ERROR, "Benchmark", "Cannot load creature %s!", arg);
+			return false;
+		}
+		delete actor;
+	}
+	LogLoads("cre", arg, timer);
+	return true;
+}
+
+// has the main loop enter the named save on its next tick, otherwise a new default game
+// returns false if the save is missing or there is no default game
+static bool QueueGame(const char* saveName)
+{
+	if (saveName) {
+		Holder<SaveGame> save = core->GetSaveGameIterator()->GetSaveGame(saveName);
+		if (!save) {
+			Log(ERROR, "Benchmark", "Cannot find save %s!", saveName);
+			return false;
+		}
+		core->SetupLoadGame(save, 0);
+		core->QuitFlag |= QF_ENTERGAME;
+	} else if (gamedata->Exists(core->GameNameResRef, IE_GAM_CLASS_ID)) {
+		core->QuitFlag |= QF_LOADGAME | QF_ENTERGAME;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+// runs the main loop for a fixed number of ticks, best paired with VideoDriver=none
+// arg is the name of the save to load, otherwise a new default game is started if there is one
+static bool BenchmarkTicks(const char* arg)
+{
+	if (!QueueGame(arg)) {
+		if (arg) {
+			return false;
+		}
+		Log(WARNING, "Benchmark", "No game to load, only the gui will run.");
+	}
+
+	RNG::getInstance().seed(BENCHMARK_SEED);
+	// enters the game, so the load isn't counted
+	core->RunFixedFrames(BENCHMARK_WARMUP);
+	for (int i = 0; i < BENCH_SECTION_COUNT; i++) {
+		SectionTimer::Totals[i] = 0;
+	}
+	SectionTimer::Enabled = true;
+	BenchmarkTimer timer;
+	core->RunFixedFrames(BENCHMARK_TICKS);
+	double elapsed = timer.Elapsed();
+	SectionTimer::Enabled = false;
+
+	Log(MESSAGE, "Benchmark", "%d ticks in %.2fms, %.1f ticks per second",
+		BENCHMARK_TICKS, elapsed, BENCHMARK_TICKS * 1000.0 / elapsed);
+	// sections nest, so these don't add up to the total
+	for (int i = 0; i < BENCH_SECTION_COUNT; i++) {
+		Log(MESSAGE, "Benchmark", "  %-12s %10.2fms %6.3fms per tick", SectionNames[i],
+			SectionTimer::Totals[i], SectionTimer::Totals[i] / BENCHMARK_TICKS);
+	}
+	return true;
+}
+
+// runs the main loop like tick, first throwing away the target lists of script
+// object lookups, then recycling them, and counts their allocations
+static bool BenchmarkScriptTargets(const char* arg)
+{
+	if (!QueueGame(arg)) {
+		if (!arg) {
+			Log(ERROR, "Benchmark", "No game to run the scripts of!");
+		}
+		return false;
+	}
+
+	RNG::getInstance().seed(BENCHMARK_SEED);
+	// enters the game, so neither pass pays for it
+	core->RunFixedFrames(BENCHMARK_WARMUP);
+	const int ticks = BENCHMARK_TICKS / 2;
+	for (int pass = 0; pass < 2; pass++) {
+		Targets::Pooling = pass == 1;
+		// the counters only go into the total when the next tick starts,
+		// so flush the warmup before and the last tick after the pass
+		Targets::NewTick();
+		memset(&Targets::Total, 0, sizeof(Targets::Total));
+		BenchmarkTimer timer;
+		core->RunFixedFrames(ticks);
+		double elapsed = timer.Elapsed();
+		Targets::NewTick();
+		const ScriptTempStats& total = Targets::Total;
+		Log(MESSAGE, "Benchmark", "scripts %s: %d ticks in %.2fms; per tick %.1f target lists new, %.1f reused, %.1f targets new, %.1f reused",
+			pass ? "recycling" : "freeing", ticks, elapsed,
+			double(total.allocated) / ticks, double(total.reused) / ticks,
+			double(total.nodes) / ticks, double(total.reusedNodes) / ticks);
+	}
+	Targets::Pooling = true;
+	return true;
+}
+
+// decodes a movie without showing it, so only the decoder is timed
+static bool BenchmarkMovie(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the movie to decode, eg. bik:intro!");
+		return false;
+	}
+
+	ResourceHolder<MoviePlayer> mp = GetResourceHolder<MoviePlayer>(arg);
+	if (!mp) {
+		Log(ERROR, "Benchmark", "Cannot open movie %s!", arg);
+		return false;
+	}
+	BenchmarkTimer timer;
+	int frames = mp->Decode();
+	double elapsed = timer.Elapsed();
+	if (frames < 0) {
+		Log(ERROR, "Benchmark", "The player of %s cannot decode without playing!", arg);
+		return false;
+	}
+	Log(MESSAGE, "Benchmark", "bik %s: %d frames in %.2fms, %.1f frames per second",
+		arg, frames, elapsed, frames * 1000.0 / elapsed);
+	return true;
+}
+
+// collects the names of the sound files below path, relative to root
+static void FindSounds(const char* root, const char* path, std::vector<std::string>& names)
+{
+	char dirPath[_MAX_PATH];
+	PathJoin(dirPath, root, path, NULL);
+	DirectoryIterator dir(dirPath);
+	if (!dir) {
+		return;
+	}
+	do {
+		const char* name = dir.GetName();
+		if (name[0] == '.') {
+			continue;
+		}
+		char relPath[_MAX_PATH];
+		if (path[0]) {
+			PathJoin(relPath, path, name, NULL);
+		} else {
+			strlcpy(relPath, name, _MAX_PATH);
+		}
+		if (dir.IsDirectory()) {
+			FindSounds(root, relPath, names);
+			continue;
+		}
+		char* ext = strrchr(relPath, '.');
+		if (ext && (!stricmp(ext, ".acm") || !stricmp(ext, ".wav"))) {
+			*ext = 0;
+			names.push_back(relPath);
+		}
+	} while (++dir);
+}
+
+// decodes all the loose music and sounds of the game in fixed chunks
+static bool BenchmarkSounds(const char* /*arg*/)
+{
+	const char* folders[] = { "music", core->GameSoundsPath };
+	std::vector<short> chunk(BENCHMARK_CHUNK);
+	int files = 0;
+	long samples = 0;
+	double seconds = 0;
+	double elapsed = 0;
+	for (int i = 0; i < 2; i++) {
+		char path[_MAX_PATH];
+		PathJoin(path, core->GamePath, folders[i], NULL);
+		std::vector<std::string> names;
+		FindSounds(path, "", names);
+		if (names.empty()) {
+			continue;
+		}
+		ResourceManager manager;
+		manager.AddSource(path, folders[i], PLUGIN_RESOURCE_DIRECTORY);
+
+		for (size_t j = 0; j < names.size(); j++) {
+			BenchmarkTimer timer;
+			ResourceHolder<SoundMgr> sound = GetResourceHolder<SoundMgr>(names[j].c_str(), manager, true);
+			if (!sound) {
+				continue;
+			}
+			long count = 0;
+			int got;
+			while ((got = sound->read_samples(&chunk[0], BENCHMARK_CHUNK)) > 0) {
+				count += got;
+			}
+			elapsed += timer.Elapsed();
+			files++;
+			samples += count;
+			seconds += double(count) / (sound->get_channels() * sound->get_samplerate());
+		}
+	}
+	if (!files) {
+		Log(ERROR, "Benchmark", "Cannot find any sounds to decode!");
+		return false;
+	}
+	Log(MESSAGE, "Benchmark", "acm: %d files, %ld samples (%.1fs of sound) in %.2fms, %.0fx realtime",
+		files, samples, seconds, elapsed, seconds * 1000.0 / elapsed);
+	return true;
+}
+
+static bool SameTile(const Sprite2D* a, const Sprite2D* b)
+{
+	if (!a || !b || a->Width != 64 || a->Height != 64 || b->Width != 64 || b->Height != 64
+		|| memcmp(a->pixels, b->pixels, 64 * 64)) {
+		return false;
+	}
+	return !memcmp(a->GetPaletteColors(), b->GetPaletteColors(), 256 * sizeof(Color));
+}
+
+// returns how many decoded tiles of the overlay differ from the eager ones
+// and counts those that were decoded at the last check but aren't anymore
+static int CheckOverlay(const TileOverlay* overlay, const std::vector<Sprite2D*>& tiles,
+	std::vector<char>& decoded, int& evictions)
+{
+	int mismatches = 0;
+	for (size_t i = 0; i < tiles.size(); i++) {
+		const Sprite2D* spr = overlay->GetDecodedTile((int) i);
+		if (!spr) {
+			evictions += decoded[i];
+			decoded[i] = false;
+			continue;
+		}
+		decoded[i] = true;
+		if (!SameTile(spr, tiles[i])) {
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+// decodes every tile of a tileset the way areas do and checks them against the raw
+// file, so palette sharing can't go unnoticed if it ever mixes tiles up; then lays
+// them out in an overlay and scrolls over it with a budget of a few tiles, so the
+// tiles are decoded on their first draw and evicted as they scroll out of view,
+// and compares what the overlay holds after each draw with the eager tiles
+static bool BenchmarkTiles(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the tileset to decode, eg. tis:ar0602!");
+		return false;
+	}
+	// tile animations run on game time
+	if (!StartDefaultGame()) {
+		return false;
+	}
+
+	PluginHolder<TileSetMgr> tis(IE_TIS_CLASS_ID);
+	DataStream* str = tis ? gamedata->GetResource(arg, IE_TIS_CLASS_ID) : NULL;
+	DataStream* raw = gamedata->GetResource(arg, IE_TIS_CLASS_ID);
+	// the importer owns the stream once it is opened
+	if (!tis || !str || !raw || !tis->Open(str)) {
+		Log(ERROR, "Benchmark", "Cannot open tileset %s!", arg);
+		delete raw;
+		return false;
+	}
+	ieDword headerShift = 0;
+	char Signature[8];
+	raw->Read(Signature, 8);
+	if (!strncmp(Signature, "TIS V1  ", 8)) {
+		raw->Seek(16, GEM_STREAM_START);
+		raw->ReadDword(&headerShift);
+	}
+
+	int count = tis->GetTileCount();
+	std::vector<Sprite2D*> tiles(count);
+	BenchmarkTimer timer;
+	for (int i = 0; i < count; i++) {
+		tiles[i] = tis->GetTile(i);
+	}
+	double elapsed = timer.Elapsed();
+
+	int mismatches = 0;
+	for (int i = 0; i < count; i++) {
+		RevColor palette[256];
+		unsigned char pixels[4096];
+		raw->Seek(headerShift + i * (1024 + 4096), GEM_STREAM_START);
+		raw->Read(palette, sizeof(palette));
+		raw->Read(pixels, sizeof(pixels));
+		const Color* colors = tiles[i]->GetPaletteColors();
+		bool same = !memcmp(tiles[i]->pixels, pixels, sizeof(pixels));
+		for (int c = 0; same && c < 256; c++) {
+			same = colors[c].r == palette[c].r && colors[c].g == palette[c].g && colors[c].b == palette[c].b;
+		}
+		if (!same) {
+			Log(ERROR, "Benchmark", "tis %s: tile %d differs from the file!", arg, i);
+			mismatches++;
+		}
+	}
+	delete raw;
+
+	// the tiles in rows as wide as the screen, padded with the first one
+	Video* video = core->GetVideoDriver();
+	Region oldViewport = video->GetViewport();
+	Region screen(0, 0, oldViewport.w, oldViewport.h);
+	int columns = std::max(screen.w / 64, 1);
+	int rows = (count + columns - 1) / columns;
+	TileOverlay* overlay = new TileOverlay(columns, rows, tis);
+	for (int i = 0; i < columns * rows; i++) {
+		ieWord index = i < count ? i : 0;
+		overlay->AddTile(new Tile(&index, 1));
+	}
+	std::vector<TileOverlay*> overlays(1, overlay);
+
+	int budget = TileOverlay::GetCacheSize();
+	TileOverlay::SetCacheSize(BENCHMARK_TILE_BUDGET);
+	int overlayMismatches = 0;
+	int draws = 0;
+	int evictions = 0;
+	std::vector<char> decoded(count, false);
+	timer.Reset();
+	// down the rows and back to the top, so the first tiles are decoded again
+	for (int y = 0; y <= rows; y++) {
+		video->MoveViewportTo(0, (y < rows ? y : 0) * 64);
+		overlay->Draw(screen, overlays, 0);
+		draws++;
+		overlayMismatches += CheckOverlay(overlay, tiles, decoded, evictions);
+	}
+	double elapsedOverlay = timer.Elapsed();
+	TileOverlay::SetCacheSize(budget);
+	video->MoveViewportTo(oldViewport.x, oldViewport.y);
+	delete overlay;
+
+	if (overlayMismatches) {
+		Log(ERROR, "Benchmark", "tis %s: %d drawn tiles differ from the eager ones!", arg, overlayMismatches);
+	}
+	// a tileset that fits into the screen never has to give any up
+	if (!evictions && rows * 64 > screen.h + 64) {
+		Log(ERROR, "Benchmark", "tis %s: the overlay never evicted a tile!", arg);
+		overlayMismatches++;
+	}
+	for (int i = 0; i < count; i++) {
+		Sprite2D::FreeSprite(tiles[i]);
+	}
+
+	Log(MESSAGE, "Benchmark", "tis %s: %d tiles in %.2fms, %.3fms per tile, %d mismatches",
+		arg, count, elapsed, count ? elapsed / count : 0, mismatches);
+	Log(MESSAGE, "Benchmark", "tis %s: %d overlay draws with a %dkB budget in %.2fms, %d tiles evicted",
+		arg, draws, BENCHMARK_TILE_BUDGET, elapsedOverlay, evictions);
+	return !mismatches && !overlayMismatches;
+}
+
+// loads the light, search and height map of an area by decoding them, by decoding
+// and writing the digest and by reading it back, the three must come out the same;
+// then does the same with the whole area, in the default game
+static bool BenchmarkDigest(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the area to digest, eg. dig:ar0602!");
+		return false;
+	}
+	if (!StartDefaultGame()) {
+		return false;
+	}
+	char lightRef[9], searchRef[9], heightRef[9];
+	snprintf(lightRef, sizeof(lightRef), "%.6sLM", arg);
+	snprintf(searchRef, sizeof(searchRef), "%.6sSR", arg);
+	snprintf(heightRef, sizeof(heightRef), "%.6sHT", arg);
+	// start without a digest, so the second pass has to write one
+	char path[_MAX_PATH];
+	PathJoinExt(path, core->CachePath, lightRef, "dig");
+	remove(path);
+
+	bool enabled = AreaDigest::Enabled;
+	AreaDigest passes[3];
+	double elapsed[3];
+	for (int pass = 0; pass < 3; pass++) {
+		AreaDigest::Enabled = pass > 0;
+		BenchmarkTimer timer;
+		passes[pass].Load(lightRef, searchRef, heightRef);
+		elapsed[pass] = timer.Elapsed();
+	}
+
+	const AreaDigest& decoded = passes[0];
+	if (!decoded.lightMap || !decoded.searchMap || !decoded.heightMap) {
+		Log(ERROR, "Benchmark", "Cannot load the maps of %s!", arg);
+		AreaDigest::Enabled = enabled;
+		return false;
+	}
+
+	// the same three ways, but through the area loader
+	remove(path);
+	Map* maps[3];
+	for (int pass = 0; pass < 3; pass++) {
+		AreaDigest::Enabled = pass > 0;
+		maps[pass] = LoadArea(arg);
+	}
+	AreaDigest::Enabled = enabled;
+
+	bool ok = true;
+	for (int pass = 1; pass < 3; pass++) {
+		const AreaDigest& other = passes[pass];
+		bool same = SameImage(other.lightMap, decoded.lightMap)
+			&& SameBitmap(other.searchMap, decoded.searchMap)
+			&& SameBitmap(other.heightMap, decoded.heightMap);
+		if (!same) {
+			Log(ERROR, "Benchmark", "dig %s: the maps of pass %d differ from the decoded ones!", arg, pass);
+			ok = false;
+		}
+	}
+	if (maps[0] && maps[1] && maps[2]) {
+		ok = SameMap(maps[1], maps[0], "dig, writing the digest") && ok;
+		ok = SameMap(maps[2], maps[0], "dig, reading the digest") && ok;
+	} else {
+		ok = false;
+	}
+	for (int pass = 0; pass < 3; pass++) {
+		delete maps[pass];
+	}
+	if (!passes[2].FromDigest()) {
+		Log(ERROR, "Benchmark", "dig %s: the digest was not used!", arg);
+		ok = false;
+	}
+
+	Log(MESSAGE, "Benchmark", "dig %s: decoding %.2fms, writing the digest %.2fms, reading it %.2fms",
+		arg, elapsed[0], elapsed[1], elapsed[2]);
+	return ok;
+}
+
+static void FreeCrowd(std::vector<Actor*>& crowd)
+{
+	for (auto actor : crowd) {
+		delete actor;
+	}
+	crowd.clear();
+}
+
+// a crowd of the same creature glowing in step, like a group of summons;
+// recolours a palette of its own for each actor, the way it used to be done,
+// against going through the shared recoloured palettes
+static bool BenchmarkRecolour(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the creature to recolour, eg. pal:charbase!");
+		return false;
+	}
+
+	std::vector<Actor*> crowd;
+	for (int i = 0; i < BENCHMARK_HORDE; i++) {
+		Actor* actor = gamedata->GetCreature(arg);
+		CharAnimations* ca = actor ? actor->GetAnims() : NULL;
+		if (ca) {
+			// loads the palettes
+			ca->GetAnimation(IE_ANI_AWAKE, 0);
+		}
+		if (!ca || !ca->palette[PAL_MAIN]) {
+			Log(ERROR, "Benchmark", "Cannot load creature %s with a palette!", arg);
+			delete actor;
+			FreeCrowd(crowd);
+			return false;
+		}
+		actor->SetColorMod(0xff, RGBModifier::TINT, BENCHMARK_PULSE, 255, 64, 64, 0);
+		crowd.push_back(actor);
+	}
+
+	std::vector<Palette*> own(crowd.size());
+	for (auto& pal : own) {
+		pal = new Palette();
+	}
+	BenchmarkTimer timer;
+	for (int phase = 0; phase < 2 * BENCHMARK_PULSE; phase++) {
+		for (size_t i = 0; i < crowd.size(); i++) {
+			CharAnimations* ca = crowd[i]->GetAnims();
+			ca->GlobalColorMod.phase = phase;
+			own[i]->SetupGlobalRGBModification(ca->palette[PAL_MAIN], ca->GlobalColorMod);
+		}
+	}
+	double elapsedOwn = timer.Elapsed();
+
+	timer.Reset();
+	for (int phase = 0; phase < 2 * BENCHMARK_PULSE; phase++) {
+		for (auto actor : crowd) {
+			CharAnimations* ca = actor->GetAnims();
+			ca->GlobalColorMod.phase = phase;
+			ca->SetupColors(PAL_MAIN);
+		}
+	}
+	double elapsedShared = timer.Elapsed();
+
+	// the last phase of both must agree, and the crowd should share one palette
+	int mismatches = 0;
+	std::vector<const Palette*> distinct;
+	for (size_t i = 0; i < crowd.size(); i++) {
+		const Palette* shared = crowd[i]->GetAnims()->modifiedPalette[PAL_MAIN];
+		bool same = shared != NULL;
+		for (int c = 0; same && c < 256; c++) {
+			same = shared->col[c].r == own[i]->col[c].r && shared->col[c].g == own[i]->col[c].g
+				&& shared->col[c].b == own[i]->col[c].b;
+		}
+		if (!same) {
+			mismatches++;
+		}
+		if (std::find(distinct.begin(), distinct.end(), shared) == distinct.end()) {
+			distinct.push_back(shared);
+		}
+		own[i]->release();
+	}
+	FreeCrowd(crowd);
+
+	Log(MESSAGE, "Benchmark", "pal %s: %d actors over %d phases, own palettes %.2fms, shared %.2fms in %d palettes, %d mismatches",
+		arg, BENCHMARK_HORDE, 2 * BENCHMARK_PULSE, elapsedOwn, elapsedShared, (int) distinct.size(), mismatches);
+	return !mismatches;
+}
+
+// the paperdoll conversion as it was before the lookup table, for comparison
+static void ColourPaperdoll(const unsigned char* pixels, ieDword width, ieDword height,
+	unsigned int type, const ieDword* paletteIndex, unsigned char* dest)
+{
+	static const int pperm[8] = { 3, 6, 0, 5, 4, 1, 2, 7 };
+	Color Palettes[8][256];
+	for (int i = 0; i < 8; i++) {
+		core->GetPalette((paletteIndex[pperm[i]] >> (8*type)) & 0xFF, 256, Palettes[i]);
+	}
+	for (int y = height - 1; y >= 0; y--) {
+		const unsigned char* src = pixels + (y * width * 2);
+		for (unsigned int x = 0; x < width; x++) {
+			unsigned char intensity = *src++;
+			unsigned char palindex = *src++;
+			*dest++ = Palettes[palindex][intensity].b;
+			*dest++ = Palettes[palindex][intensity].g;
+			*dest++ = Palettes[palindex][intensity].r;
+			*dest++ = intensity == 0xff ? 0x00 : 0xff;
+		}
+	}
+}
+
+// colours a plt with a range of gradient combinations and checks each against
+// the plain conversion, then asks for them all again to time the cached ones
+static bool BenchmarkPaperdoll(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the paperdoll plt to colour!");
+		return false;
+	}
+
+	ResourceHolder<PalettedImageMgr> plt = GetResourceHolder<PalettedImageMgr>(arg);
+	DataStream* raw = gamedata->GetResource(arg, IE_PLT_CLASS_ID);
+	if (!plt || !raw) {
+		Log(ERROR, "Benchmark", "Cannot open paperdoll %s!", arg);
+		delete raw;
+		return false;
+	}
+	ieDword width = 0, height = 0;
+	raw->Seek(16, GEM_STREAM_START);
+	raw->ReadDword(&width);
+	raw->ReadDword(&height);
+	std::vector<unsigned char> pixels(width * height * 2);
+	raw->Read(pixels.data(), pixels.size());
+	delete raw;
+
+	std::vector<unsigned char> expected(width * height * 4);
+	int mismatches = 0;
+	double elapsed = 0;
+	for (int i = 0; i < BENCHMARK_GRADIENTS; i++) {
+		// each byte is the gradient of one type, so all four get some variety
+		ieDword col[8];
+		unsigned int type = i % 4;
+		for (int c = 0; c < 8; c++) {
+			col[c] = ((i * 7 + c * 13) & 0xff) * 0x01010101;
+		}
+		BenchmarkTimer timer;
+		Sprite2D* spr = plt->GetSprite2D(type, col);
+		elapsed += timer.Elapsed();
+
+		ColourPaperdoll(pixels.data(), width, height, type, col, expected.data());
+		if (!spr || memcmp(spr->pixels, expected.data(), expected.size())) {
+			Log(ERROR, "Benchmark", "plt %s: gradient combination %d differs!", arg, i);
+			mismatches++;
+		}
+		Sprite2D::FreeSprite(spr);
+	}
+
+	Log(MESSAGE, "Benchmark", "plt %s: %d combinations generated in %.2fms, %d mismatches",
+		arg, BENCHMARK_GRADIENTS, elapsed, mismatches);
+	return !mismatches;
+}
+
+// colours a paperdoll bam with a range of gradient combinations twice, checks
+// the palettes against setting them up directly and that the repeats are shared
+static bool BenchmarkPaperdollBAM(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the paperdoll bam to colour!");
+		return false;
+	}
+
+	AnimationFactory* af = (AnimationFactory*) gamedata->GetFactoryResource(arg, IE_BAM_CLASS_ID);
+	if (!af) {
+		Log(ERROR, "Benchmark", "Cannot open paperdoll %s!", arg);
+		return false;
+	}
+
+	int mismatches = 0;
+	double elapsed[2] = { 0, 0 };
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = 0; i < BENCHMARK_GRADIENTS; i++) {
+			ieDword col[8];
+			unsigned int type = i % 4;
+			for (int c = 0; c < 8; c++) {
+				col[c] = ((i * 7 + c * 13) & 0xff) * 0x01010101;
+			}
+			Sprite2D* bottom = NULL;
+			BenchmarkTimer timer;
+			Sprite2D* top = af->GetPaperdollImage(col, bottom, type);
+			elapsed[pass] += timer.Elapsed();
+			if (!top) {
+				Log(ERROR, "Benchmark", "%s is not a paperdoll!", arg);
+				return false;
+			}
+
+			Palette* expected = new Palette();
+			expected->SetupPaperdollColours(col, type);
+			Palette* pal = top->GetPalette();
+			// only the gradient part, the rest is the bam's own
+			if (memcmp(&pal->col[0x04], &expected->col[0x04], (0x58 - 0x04) * sizeof(Color))) {
+				Log(ERROR, "Benchmark", "doll %s: gradient combination %d differs!", arg, i);
+				mismatches++;
+			}
+			pal->release();
+			expected->release();
+			Sprite2D::FreeSprite(top);
+			Sprite2D::FreeSprite(bottom);
+		}
+	}
+
+	Log(MESSAGE, "Benchmark", "doll %s: %d combinations coloured in %.2fms, again in %.2fms, %d mismatches",
+		arg, BENCHMARK_GRADIENTS, elapsed[0], elapsed[1], mismatches);
+	return !mismatches;
+}
+
+// the mos decoder as it was, a few seeks and a palette read per block
+static std::vector<unsigned char> DecodeMOSBlocks(DataStream* str, int& width, int& height)
+{
+	ieWord Width, Height, Cols, Rows;
+	ieDword BlockSize, PalOffset;
+	str->Seek(8, GEM_STREAM_START);
+	str->ReadWord(&Width);
+	str->ReadWord(&Height);
+	str->ReadWord(&Cols);
+	str->ReadWord(&Rows);
+	str->ReadDword(&BlockSize);
+	str->ReadDword(&PalOffset);
+	width = Width;
+	height = Height;
+
+	std::vector<unsigned char> pixels(Width * Height * 4);
+	unsigned char blockpixels[64 * 64];
+	RevColor RevCol[256];
+	ieDword blockoffset;
+	for (int y = 0; y < Rows; y++) {
+		int bh = (y == Rows - 1) ? ((Height % 64) == 0 ? 64 : Height % 64) : 64;
+		for (int x = 0; x < Cols; x++) {
+			int bw = (x == Cols - 1) ? ((Width % 64) == 0 ? 64 : Width % 64) : 64;
+			str->Seek(PalOffset + (y * Cols * 1024) + (x * 1024), GEM_STREAM_START);
+			str->Read(&RevCol[0], 1024);
+			str->Seek(PalOffset + (Rows * Cols * 1024) + (y * Cols * 4) + (x * 4), GEM_STREAM_START);
+			str->ReadDword(&blockoffset);
+			str->Seek(PalOffset + (Rows * Cols * 1024) + (Rows * Cols * 4) + blockoffset, GEM_STREAM_START);
+			str->Read(blockpixels, bw * bh);
+			const unsigned char* bp = blockpixels;
+			unsigned char* startpixel = &pixels[(Width * 4 * y) * 64 + 4 * x * 64];
+			for (int h = 0; h < bh; h++) {
+				for (int w = 0; w < bw; w++) {
+					*startpixel++ = RevCol[*bp].b;
+					*startpixel++ = RevCol[*bp].g;
+					*startpixel++ = RevCol[*bp].r;
+					*startpixel++ = RevCol[*bp].a;
+					bp++;
+				}
+				startpixel += (Width * 4) - (4 * bw);
+			}
+		}
+	}
+	return pixels;
+}
+
+static bool SamePixels(const Sprite2D* spr, const std::vector<unsigned char>& expected, int width, const Region& rgn)
+{
+	if (!spr || spr->Width != rgn.w || spr->Height != rgn.h) {
+		return false;
+	}
+	const unsigned char* pixels = (const unsigned char*) spr->pixels;
+	for (int y = 0; y < rgn.h; y++) {
+		if (memcmp(pixels + y * rgn.w * 4, &expected[((rgn.y + y) * width + rgn.x) * 4], rgn.w * 4)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// decodes a mos the old way and the current one, whole and in parts,
+// everything has to come out the same
+static bool BenchmarkMOS(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass the mos to decode, eg. mos:worldmap!");
+		return false;
+	}
+
+	DataStream* raw = gamedata->GetResource(arg, IE_MOS_CLASS_ID);
+	char Signature[8];
+	if (!raw || raw->Read(Signature, 8) != 8 || strncmp(Signature, "MOS V1  ", 8)) {
+		// compressed ones go through the file cache first, nothing to compare there
+		Log(ERROR, "Benchmark", "Cannot open uncompressed mos %s!", arg);
+		delete raw;
+		return false;
+	}
+	int width, height;
+	BenchmarkTimer timer;
+	std::vector<unsigned char> expected = DecodeMOSBlocks(raw, width, height);
+	double elapsedOld = timer.Elapsed();
+	delete raw;
+
+	timer.Reset();
+	ResourceHolder<ImageMgr> mos = GetResourceHolder<ImageMgr>(arg);
+	if (!mos) {
+		Log(ERROR, "Benchmark", "Cannot load mos %s!", arg);
+		return false;
+	}
+	Sprite2D* spr = mos->GetSprite2D();
+	double elapsed = timer.Elapsed();
+	Region whole(0, 0, width, height);
+	int mismatches = SamePixels(spr, expected, width, whole) ? 0 : 1;
+	Sprite2D::FreeSprite(spr);
+
+	// a screenful from the middle, one straddling block edges and a corner
+	Region parts[3] = {
+		Region(width / 4, height / 4, std::min(width / 2, 800), std::min(height / 2, 600)),
+		Region(63, 65, 130, 66),
+		Region(width - 10, height - 10, 10, 10)
+	};
+	double elapsedPart = 0;
+	for (const Region& part : parts) {
+		Region rgn = part.Intersect(whole);
+		if (rgn.w <= 0 || rgn.h <= 0) {
+			continue;
+		}
+		timer.Reset();
+		Sprite2D* partial = mos->GetPartialSprite2D(rgn);
+		elapsedPart += timer.Elapsed();
+		if (!SamePixels(partial, expected, width, rgn)) {
+			Log(ERROR, "Benchmark", "mos %s: part %d,%d %dx%d differs!", arg, rgn.x, rgn.y, rgn.w, rgn.h);
+			mismatches++;
+		}
+		Sprite2D::FreeSprite(partial);
+	}
+
+	Log(MESSAGE, "Benchmark", "mos %s: %dx%d, block by block %.2fms, now %.2fms, parts %.2fms, %d mismatches",
+		arg, width, height, elapsedOld, elapsed, elapsedPart, mismatches);
+	return !mismatches;
+}
+
+static void FreePath(PathNode* path)
+{
+	while (path) {
+		PathNode* next = path->Next;
+		delete path;
+		path = next;
+	}
+}
+
+// walks copies of the first living actor of map from spots to the first spot
+// for a while, the way the area update steps them, returns how many arrived
+static int WalkGroup(Map* map, const std::vector<Point>& spots, double& elapsed)
+{
+	Actor* model = NULL;
+	for (int i = 0; i < map->GetActorCount(true) && !model; i++) {
+		Actor* actor = map->GetActor(i, true);
+		if (actor->ValidTarget(GA_NO_DEAD) && !actor->Immobile()) {
+			model = actor;
+		}
+	}
+	int speed = model ? model->CalculateSpeed(false) : 0;
+	if (!speed) return -1;
+	speed = 1500 / speed;
+
+	std::vector<Actor*> group;
+	for (size_t i = 1; i < spots.size(); i++) {
+		Actor* actor = model->CopySelf(true);
+		actor->SetPosition(spots[i], CC_CHECK_IMPASSABLE, 0);
+		group.push_back(actor);
+	}
+
+	BenchmarkTimer timer;
+	ieDword time = core->GetGame()->Ticks;
+	for (size_t i = 0; i < group.size(); i++) {
+		group[i]->WalkTo(spots[0], i < BENCHMARK_PARTY ? 0 : 32);
+	}
+	for (int tick = 0; tick < BENCHMARK_FLOW_TICKS; tick++) {
+		time++;
+		for (Actor* actor : group) {
+			if (actor->GetRandomBackoff()) {
+				actor->DecreaseBackoff();
+				if (!actor->GetRandomBackoff()) {
+					actor->NewPath();
+				}
+				continue;
+			}
+			actor->DoStep(speed, time);
+		}
+	}
+	elapsed = timer.Elapsed();
+
+	int arrived = 0;
+	for (Actor* actor : group) {
+		if (!actor->GetPath() && SquaredDistance(actor->Pos, spots[0]) < 64 * 64) {
+			arrived++;
+		}
+		map->RemoveActor(actor);
+		delete actor;
+	}
+	return arrived;
+}
+
+// finds the paths of a whole group walking to one spot, once searching each
+// and once sharing a flow field, then has copies of an actor of the area walk
+// those paths; arg is the area, the starting one by default
+static bool BenchmarkFlow(const char* arg)
+{
+	if (!core->GetGame()) {
+		core->LoadGame(NULL, 0);
+	}
+	Game* game = core->GetGame();
+	if (!game) {
+		Log(ERROR, "Benchmark", "Cannot load the default game!");
+		return false;
+	}
+	const char* resRef = arg ? arg : game->CurrentArea;
+	Map* map = game->GetMap(resRef, false);
+	if (!map) {
+		Log(ERROR, "Benchmark", "Cannot load area %s!", resRef);
+		return false;
+	}
+
+	// random but repeatable walkable spots, the first one is the destination
+	const size_t count = BENCHMARK_PARTY + BENCHMARK_HORDE + 1;
+	std::vector<Point> spots;
+	RNG::getInstance().seed(BENCHMARK_SEED);
+	int width = map->GetWidth() * 16;
+	int height = map->GetHeight() * 12;
+	for (size_t tries = 0; spots.size() < count && tries < count * 100; tries++) {
+		Point p(RAND(0, width - 1), RAND(0, height - 1));
+		if (map->GetBlockedInRadius(p.x, p.y, 2) & PATH_MAP_PASSABLE) {
+			spots.push_back(p);
+		}
+	}
+	if (spots.size() < count) {
+		Log(ERROR, "Benchmark", "Cannot find enough walkable spots in %s!", resRef);
+		return false;
+	}
+
+	const Point& goal = spots[0];
+	double elapsed[2];
+	int found[2];
+	double elapsedWalk[2];
+	int arrived[2];
+	for (int pass = 0; pass < 2; pass++) {
+		FlowFieldCache::Enabled = pass == 1;
+		map->ClearFlowFields();
+		found[pass] = 0;
+		BenchmarkTimer timer;
+		for (size_t i = 1; i < count; i++) {
+			PathNode* path;
+			if (i <= BENCHMARK_PARTY) {
+				// the party keeps a rough formation around the goal
+				Point slot(goal.x + (i % 3 - 1) * 32, goal.y + (i / 3 - 1) * 24);
+				path = map->FindPath(spots[i], slot, 1);
+			} else {
+				path = map->FindPath(spots[i], goal, 2, 32);
+			}
+			if (path) found[pass]++;
+			FreePath(path);
+		}
+		elapsed[pass] = timer.Elapsed();
+
+		// the same walk both times
+		RNG::getInstance().seed(BENCHMARK_SEED);
+		map->ClearFlowFields();
+		arrived[pass] = WalkGroup(map, spots, elapsedWalk[pass]);
+	}
+	FlowFieldCache::Enabled = true;
+	map->ClearFlowFields();
+
+	Log(MESSAGE, "Benchmark", "flow %s: %d paths, searching %.2fms (%d found), sharing fields %.2fms (%d found)",
+		resRef, int(count - 1), elapsed[0], found[0], elapsed[1], found[1]);
+	if (arrived[0] < 0) {
+		Log(WARNING, "Benchmark", "flow %s: no actor in the area to walk the paths with", resRef);
+	} else {
+		Log(MESSAGE, "Benchmark", "flow %s: walking %d ticks, searching %.2fms (%d arrived), sharing fields %.2fms (%d arrived)",
+			resRef, BENCHMARK_FLOW_TICKS, elapsedWalk[0], arrived[0], elapsedWalk[1], arrived[1]);
+	}
+	return true;
+}
+
+// draws the small map of an area with its fog, first as steady frames, then
+// with a strip explored before each frame; arg is the area, the starting one by default
+static bool BenchmarkMinimap(const char* arg)
+{
+	if (!core->GetGame()) {
+		core->LoadGame(NULL, 0);
+	}
+	Game* game = core->GetGame();
+	if (!game) {
+		Log(ERROR, "Benchmark", "Cannot load the default game!");
+		return false;
+	}
+	const char* resRef = arg ? arg : game->CurrentArea;
+	// the control always shows the current area
+	Map* map = game->GetMap(resRef, true);
+	if (!map) {
+		Log(ERROR, "Benchmark", "Cannot load area %s!", resRef);
+		return false;
+	}
+
+	unsigned int fog = core->FogOfWar;
+	core->FogOfWar |= FOG_DRAWFOG;
+	Window win(0, 0, 0, core->Width, core->Height);
+	MapControl* mc = new MapControl(Region(0, 0, core->Width, core->Height));
+	win.AddControl(mc);
+
+	const int frames = BENCHMARK_TICKS / 10;
+	BenchmarkTimer timer;
+	for (int i = 0; i < frames; i++) {
+		mc->MarkDirty();
+		mc->Draw(0, 0);
+	}
+	double elapsedSteady = timer.Elapsed();
+
+	// a party walking down the middle of the map, uncovering a row each frame
+	int width = map->GetWidth() * 16;
+	int height = map->GetHeight() * 12;
+	timer.Reset();
+	for (int i = 0; i < frames; i++) {
+		Point p((short) (width / 2), (short) (i * 32 % height));
+		map->ExploreMapChunk(p, 10, 0);
+		mc->MarkDirty();
+		mc->Draw(0, 0);
+	}
+	double elapsedExplore = timer.Elapsed();
+	core->FogOfWar = fog;
+
+	Log(MESSAGE, "Benchmark", "minimap %s: %d frames steady %.2fms (%.3fms per frame), exploring %.2fms (%.3fms per frame)",
+		resRef, frames, elapsedSteady, elapsedSteady / frames, elapsedExplore, elapsedExplore / frames);
+	return true;
+}
+
+// casts overlapping area spells with the given projectile around the party
+// in the default game, once building every instance anew and once sharing
+// palettes and animations and reusing the expired explosion parts
+static bool BenchmarkProjectiles(const char* arg)
+{
+	if (!arg) {
+		Log(ERROR, "Benchmark", "Pass an area projectile to cast, eg. pro:fireball!");
+		return false;
+	}
+	if (!gamedata->Exists(core->GameNameResRef, IE_GAM_CLASS_ID)) {
+		Log(ERROR, "Benchmark", "No default game to cast in!");
+		return false;
+	}
+	// enter the game, otherwise projectiles stay frozen
+	core->QuitFlag |= QF_LOADGAME | QF_ENTERGAME;
+	core->RunFixedFrames(BENCHMARK_CAST_EVERY);
+	Game* game = core->GetGame();
+	Map* map = game ? game->GetCurrentArea() : NULL;
+	const Actor* caster = game ? game->GetPC(0, false) : NULL;
+	if (!map || !caster || core->IsFreezed()) {
+		Log(ERROR, "Benchmark", "Cannot enter the default game!");
+		return false;
+	}
+
+	ProjectileServer* server = core->GetProjectileServer();
+	Projectile* pro = server->GetProjectileByName(arg);
+	if (!pro || !pro->Extension) {
+		Log(ERROR, "Benchmark", "%s is not an area projectile!", arg);
+		delete pro;
+		return false;
+	}
+	unsigned int idx = pro->GetType();
+	delete pro;
+
+	// the spots don't depend on how many rolls the animations make
+	std::vector<Point> spots;
+	RNG::getInstance().seed(BENCHMARK_SEED);
+	for (int i = 0; i < BENCHMARK_CASTS; i++) {
+		spots.push_back(Point(caster->Pos.x + RAND(-64, 64), caster->Pos.y + RAND(-48, 48)));
+	}
+
+	Region screen(0, 0, core->Width, core->Height);
+	ieDword ticks = game->Ticks;
+	double elapsed[2], casting[2];
+	ProjectileStats stats[2];
+	for (int pass = 0; pass < 2; pass++) {
+		ProjectileServer::Pooling = pass == 1;
+		memset(&server->stats, 0, sizeof(server->stats));
+		RNG::getInstance().seed(BENCHMARK_SEED);
+		game->Ticks = ticks;
+		casting[pass] = 0;
+
+		std::vector<Projectile*> live;
+		size_t cast = 0;
+		BenchmarkTimer timer;
+		for (int frame = 0; frame < BENCHMARK_CAST_FRAMES && (cast < spots.size() || !live.empty()); frame++) {
+			if (cast < spots.size() && !(frame % BENCHMARK_CAST_EVERY)) {
+				BenchmarkTimer castTimer;
+				pro = server->GetProjectileByIndex(idx, map);
+				pro->SetCaster(caster->GetGlobalID(), 10);
+				pro->MoveTo(map, spots[cast]);
+				pro->SetTarget(spots[cast]);
+				pro->Setup();
+				casting[pass] += castTimer.Elapsed();
+				live.push_back(pro);
+				cast++;
+			}
+			game->Ticks += game->interval;
+			for (size_t i = 0; i < live.size();) {
+				if (live[i]->Update()) {
+					live[i]->Draw(screen);
+					i++;
+				} else {
+					map->RecycleProjectile(live[i]);
+					live.erase(live.begin() + i);
+				}
+			}
+		}
+		elapsed[pass] = timer.Elapsed();
+		for (size_t i = 0; i < live.size(); i++) {
+			map->RecycleProjectile(live[i]);
+		}
+		stats[pass] = server->stats;
+	}
+	ProjectileServer::Pooling = true;
+	game->Ticks = ticks;
+
+	bool same = stats[0].targets == stats[1].targets && stats[0].targetHash == stats[1].targetHash;
+	for (int pass = 0; pass < 2; pass++) {
+		Log(MESSAGE, "Benchmark", "pro %s %s: %d casts in %.2fms, %.3fms per cast; %u projectiles new, %u reused, %u animations, %u palettes built, %u shared, %u targets",
+			arg, pass ? "pooled" : "anew", BENCHMARK_CASTS, elapsed[pass], casting[pass] / BENCHMARK_CASTS,
+			stats[pass].allocated, stats[pass].reused, stats[pass].animations,
+			stats[pass].palettes, stats[pass].sharedPalettes, stats[pass].targets);
+	}
+	if (!same) {
+		Log(ERROR, "Benchmark", "pro %s: the pooled casts hit different targets!", arg);
+	}
+	return same;
+}
+
+static const BenchmarkEntry benchmarks[] = {
+	{ "tlk", BenchmarkStrings },
+	{ "textarea", BenchmarkTextArea },
+	{ "gam", BenchmarkGameLoad },
+	{ "are", BenchmarkAreaLoad },
+	{ "cre", BenchmarkCreatureLoad },
+	{ "tick", BenchmarkTicks },
+	{ "scripts", BenchmarkScriptTargets },
+	{ "flow", BenchmarkFlow },
+	{ "bik", BenchmarkMovie },
+	{ "acm", BenchmarkSounds },
+	{ "tis", BenchmarkTiles },
+	{ "dig", BenchmarkDigest },
+	{ "pal", BenchmarkRecolour },
+	{ "plt", BenchmarkPaperdoll },
+	{ "doll", BenchmarkPaperdollBAM },
+	{ "mos", BenchmarkMOS },
+	{ "minimap", BenchmarkMinimap },
+	{ "pro", BenchmarkProjectiles },
+	{ NULL, NULL }
+};
+
+bool RunBenchmarks(const char* names)
+{
+	bool ok = true;
+	char* list = strdup(names);
+	for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+		char* arg = strchr(name, ':');
+		if (arg) {
+			*arg++ = 0;
+		}
+		const BenchmarkEntry* entry = benchmarks;
+		while (entry->name && stricmp(entry->name, name)) {
+			entry++;
+		}
+		if (!entry->name) {
+			Log(ERROR, "Benchmark", "Unknown benchmark: %s", name);
+			ok = false;
+			continue;
+		}
+		Log(MESSAGE, "Benchmark", "Running %s...", entry->name);
+		BenchmarkTimer timer;
+		if (!entry->run(arg)) {
+			Log(ERROR, "Benchmark", "%s failed!", entry->name);
+			ok = false;
+		}
+		Log(MESSAGE, "Benchmark", "%s finished in %.2fms.", entry->name, timer.Elapsed());
+	}
+	free(list);
+	return ok;
+}
+
+}
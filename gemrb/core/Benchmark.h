@@ -0,0 +1,101 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+/**
+ * @file Benchmark.h
+ * Declares the headless benchmarks, selected with the Benchmark config option
+ * @author The GemRB Project
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "exports.h"
+
+#include <chrono>
+
+namespace GemRB {
+
+/**
+ * @class BenchmarkTimer
+ * Wall clock stopwatch with sub-millisecond resolution.
+ */
+
+class GEM_EXPORT BenchmarkTimer {
+private:
+	std::chrono::steady_clock::time_point start;
+
+public:
+	BenchmarkTimer() : start(std::chrono::steady_clock::now()) {}
+	void Reset() { start = std::chrono::steady_clock::now(); }
+	/** milliseconds since construction or the last Reset */
+	double Elapsed() const
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+/** the engine subsystems the tick benchmark breaks its time down by */
+enum BenchmarkSection {
+	BENCH_SCRIPTS,
+	BENCH_EFFECTS,
+	BENCH_MOVEMENT,
+	BENCH_PATHFINDING,
+	BENCH_DRAWING,
+	BENCH_SECTION_COUNT
+};
+
+/**
+ * @class SectionTimer
+ * Adds the time spent in its scope to the totals of a section, but only
+ * while a benchmark enabled them, so it is cheap to leave in hot paths.
+ * Sections may nest (pathfinding happens during scripts and movement),
+ * so their totals are inclusive.
+ */
+
+class GEM_EXPORT SectionTimer {
+public:
+	static bool Enabled;
+	static double Totals[BENCH_SECTION_COUNT];
+
+private:
+	BenchmarkSection section;
+	bool running;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	explicit SectionTimer(BenchmarkSection section) : section(section), running(Enabled)
+	{
+		if (running) start = std::chrono::steady_clock::now();
+	}
+	~SectionTimer()
+	{
+		if (running) {
+			Totals[section] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+	}
+};
+
+/** runs the comma separated list of benchmarks, returns false if any of them failed */
+GEM_EXPORT bool RunBenchmarks(const char* names);
+
+}
+
+#endif
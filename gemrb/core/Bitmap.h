@@ -49,6 +49,11 @@ public:
 	{
 		return width;
 	}
+	/** the raw indexes, row by row, for bulk copies */
+	unsigned char* GetData() const
+	{
+		return data;
+	}
 	void dump() const;
 private:
 	unsigned int height, width;
@@ -400,9 +400,7 @@ void CharAnimations::SetupColors(PaletteType type)
 		}
 
 		if (needmod) {
-			if (!modifiedPalette[PAL_MAIN])
-				modifiedPalette[PAL_MAIN] = new Palette();
-			modifiedPalette[PAL_MAIN]->SetupGlobalRGBModification(palette[PAL_MAIN], GlobalColorMod);
+			SetModifiedPalette(PAL_MAIN, gamedata->GetModifiedPalette(palette[PAL_MAIN], GlobalColorMod));
 		} else {
 			gamedata->FreePalette(modifiedPalette[PAL_MAIN], 0);
 		}
@@ -435,9 +433,7 @@ void CharAnimations::SetupColors(PaletteType type)
 		}
 		bool needmod = GlobalColorMod.type != RGBModifier::NONE;
 		if (needmod) {
-			if (!modifiedPalette[type])
-				modifiedPalette[type] = new Palette();
-			modifiedPalette[type]->SetupGlobalRGBModification(palette[type], GlobalColorMod);
+			SetModifiedPalette(type, gamedata->GetModifiedPalette(palette[type], GlobalColorMod));
 		} else {
 			gamedata->FreePalette(modifiedPalette[type], 0);
 		}
@@ -461,13 +457,10 @@ void CharAnimations::SetupColors(PaletteType type)
 	}
 
 	if (needmod) {
-		if (!modifiedPalette[type])
-			modifiedPalette[type] = new Palette();
-
 		if (GlobalColorMod.type != RGBModifier::NONE) {
-			modifiedPalette[type]->SetupGlobalRGBModification(palette[type], GlobalColorMod);
+			SetModifiedPalette(type, gamedata->GetModifiedPalette(palette[type], GlobalColorMod));
 		} else {
-			modifiedPalette[type]->SetupRGBModification(palette[type],ColorMods, type);
+			SetModifiedPalette(type, gamedata->GetModifiedPalette(palette[type], ColorMods, type));
 		}
 	} else {
 		gamedata->FreePalette(modifiedPalette[type], 0);
@@ -475,6 +468,16 @@ void CharAnimations::SetupColors(PaletteType type)
 
 }
 
+// the recoloured palettes are shared with every other actor looking the same,
+// so they are swapped for new ones instead of changed
+void CharAnimations::SetModifiedPalette(PaletteType type, Palette* pal)
+{
+	// pal is already taken, so this can't free it even if it is the old one
+	Palette* old = modifiedPalette[type];
+	modifiedPalette[type] = pal;
+	gamedata->FreePalette(old, 0);
+}
+
 Palette* CharAnimations::GetPartPalette(int part)
 {
 	int actorPartCount = GetActorPartCount();
@@ -935,48 +938,131 @@ WSW 003      |      013 ESE
 
 */
 
-Animation** CharAnimations::GetAnimation(unsigned char Stance, unsigned char Orient)
+// the stance whose animation is shown for Stance, some of them are missing
+// for some animation types and have a substitute
+unsigned char CharAnimations::ResolveStance(unsigned char Stance, unsigned char& Orient) const
 {
-	if (Stance >= MAX_ANIMS) {
-		error("CharAnimation", "Illegal stance ID\n");
-	}
-
-	//for paletted dragon animations, we need the stance id
-	StanceID = nextStanceID = Stance;
 	int AnimType = GetAnimType();
 
 	//alter stance here if it is missing and you know a substitute
 	//probably we should feed this result back to the actor?
 	switch (AnimType) {
-		case -1: //invalid animation
-			return NULL;
-
 		case IE_ANI_PST_STAND:
-			StanceID=IE_ANI_AWAKE;
+			Stance=IE_ANI_AWAKE;
 			break;
 		case IE_ANI_PST_GHOST:
-			StanceID=IE_ANI_AWAKE;
+			Stance=IE_ANI_AWAKE;
 			Orient=0;
 			break;
 		case IE_ANI_PST_ANIMATION_3: //stc->std
-			if (StanceID==IE_ANI_READY) {
-				StanceID=IE_ANI_AWAKE;
+			if (Stance==IE_ANI_READY) {
+				Stance=IE_ANI_AWAKE;
 			}
 			break;
 		case IE_ANI_PST_ANIMATION_2: //std->stc
-			if (StanceID==IE_ANI_AWAKE) {
-				StanceID=IE_ANI_READY;
+			if (Stance==IE_ANI_AWAKE) {
+				Stance=IE_ANI_READY;
 			}
 			break;
 	}
 	//pst animations don't have separate animation for sleep/die
 	if (AnimType >= IE_ANI_PST_ANIMATION_1) {
-		if (StanceID==IE_ANI_DIE) {
-			StanceID=IE_ANI_TWITCH;
+		if (Stance==IE_ANI_DIE) {
+			Stance=IE_ANI_TWITCH;
 		}
 	}
 
-	StanceID = MaybeOverrideStance(StanceID);
+	return MaybeOverrideStance(Stance);
+}
+
+// works out the BAM and cycle of one part, false if the part isn't shown;
+// equipment parts depend on the equipdat of the last actor part
+bool CharAnimations::GetPartResRef(unsigned char Stance, unsigned char Orient, int part,
+	char* NewResRef, unsigned char& Cycle, EquipResRefData*& equipdat)
+{
+	int actorPartCount = GetActorPartCount();
+	Cycle = 0;
+	if (part < actorPartCount) {
+		// Character animation parts
+
+		if (equipdat) delete equipdat;
+
+		//we need this long for special anims
+		strlcpy( NewResRef, ResRef, sizeof(ieResRef) );
+		GetAnimResRef( Stance, Orient, NewResRef, Cycle, part, equipdat);
+	} else {
+		// Equipment animation parts
+
+		if (GetSize() == 0) return false;
+
+		if (part == actorPartCount) {
+			if (WeaponRef[0] == 0) return false;
+			// weapon
+			GetEquipmentResRef(WeaponRef,false,NewResRef,Cycle,equipdat);
+		} else if (part == actorPartCount+1) {
+			if (OffhandRef[0] == 0) return false;
+			if (WeaponType == IE_ANI_WEAPON_2H) return false;
+			// off-hand
+			if (WeaponType == IE_ANI_WEAPON_1H) {
+				GetEquipmentResRef(OffhandRef,false,NewResRef,Cycle,
+									 equipdat);
+			} else { // IE_ANI_WEAPON_2W
+				GetEquipmentResRef(OffhandRef,true,NewResRef,Cycle,
+									 equipdat);
+			}
+		} else if (part == actorPartCount+2) {
+			if (HelmetRef[0] == 0) return false;
+			// helmet
+			GetEquipmentResRef(HelmetRef,false,NewResRef,Cycle,equipdat);
+		}
+	}
+	NewResRef[8]=0; //cutting right to size
+	return true;
+}
+
+void CharAnimations::PrefetchStances(const unsigned char* stances, int count)
+{
+	int partCount = GetTotalPartCount();
+	if (partCount <= 0) return;
+
+	for (int i = 0; i < count; i++) {
+		for (unsigned char o = 0; o < MAX_ORIENT; o++) {
+			unsigned char Orient = o;
+			unsigned char Stance = ResolveStance(stances[i], Orient);
+			if (Anims[Stance][Orient]) continue;
+
+			EquipResRefData* equipdat = 0;
+			for (int part = 0; part < partCount; ++part) {
+				//this is longer than expected so it won't overflow
+				char NewResRef[12];
+				unsigned char Cycle;
+				if (GetPartResRef(Stance, Orient, part, NewResRef, Cycle, equipdat)) {
+					gamedata->PrefetchFactoryResource(NewResRef);
+				}
+			}
+			delete equipdat;
+		}
+	}
+}
+
+Animation** CharAnimations::GetAnimation(unsigned char Stance, unsigned char Orient)
+{
+	if (Stance >= MAX_ANIMS) {
+		error("CharAnimation", "Illegal stance ID\n");
+	}
+
+	// kept in case we have to fall back to what was shown so far
+	unsigned char oldNextStanceID = nextStanceID;
+	bool oldAutoSwitch = autoSwitchOnEnd;
+
+	//for paletted dragon animations, we need the stance id
+	StanceID = nextStanceID = Stance;
+	int AnimType = GetAnimType();
+	if (AnimType == -1) { //invalid animation
+		return NULL;
+	}
+
+	StanceID = ResolveStance(Stance, Orient);
 
 	//TODO: Implement Auto Resource Loading
 	//setting up the sequencing of animation cycles
@@ -1036,55 +1122,45 @@ Animation** CharAnimations::GetAnimation(unsigned char Stance, unsigned char Ori
 	int partCount = GetTotalPartCount();
 	int actorPartCount = GetActorPartCount();
 	if (partCount <= 0) return 0;
-	anims = new Animation*[partCount];
 
+	//newresref is based on the prefix (ResRef) and various
+	// other things.
+	//this is longer than expected so it won't overflow
+	struct PartRef {
+		char NewResRef[12];
+		unsigned char Cycle;
+		bool shown;
+	};
+	std::vector<PartRef> parts(partCount);
+	bool pending = false;
 	EquipResRefData* equipdat = 0;
+	for (int part = 0; part < partCount; ++part) {
+		PartRef& ref = parts[part];
+		ref.shown = GetPartResRef(StanceID, Orient, part, ref.NewResRef, ref.Cycle, equipdat);
+		if (ref.shown && gamedata->IsFactoryPending(ref.NewResRef)) {
+			pending = true;
+		}
+	}
+	delete equipdat;
+
+	// still being decoded in the background, keep showing the last
+	// stance until it is there instead of stalling the frame
+	Animation** fallback = Anims[previousStanceID][Orient];
+	if (pending && fallback) {
+		StanceID = previousStanceID;
+		nextStanceID = oldNextStanceID;
+		autoSwitchOnEnd = oldAutoSwitch;
+		return fallback;
+	}
+
+	anims = new Animation*[partCount];
 	for (int part = 0; part < partCount; ++part)
 	{
 		anims[part] = 0;
+		if (!parts[part].shown) continue;
 
-		//newresref is based on the prefix (ResRef) and various
-		// other things.
-		//this is longer than expected so it won't overflow
-		char NewResRef[12];
-		unsigned char Cycle = 0;
-		if (part < actorPartCount) {
-			// Character animation parts
-
-			if (equipdat) delete equipdat;
-
-			//we need this long for special anims
-			strlcpy( NewResRef, ResRef, sizeof(ieResRef) );
-			GetAnimResRef( StanceID, Orient, NewResRef, Cycle, part, equipdat);
-		} else {
-			// Equipment animation parts
-
-			anims[part] = 0;
-			if (GetSize() == 0) continue;
-
-			if (part == actorPartCount) {
-				if (WeaponRef[0] == 0) continue;
-				// weapon
-				GetEquipmentResRef(WeaponRef,false,NewResRef,Cycle,equipdat);
-			} else if (part == actorPartCount+1) {
-				if (OffhandRef[0] == 0) continue;
-				if (WeaponType == IE_ANI_WEAPON_2H) continue;
-				// off-hand
-				if (WeaponType == IE_ANI_WEAPON_1H) {
-					GetEquipmentResRef(OffhandRef,false,NewResRef,Cycle,
-										 equipdat);
-				} else { // IE_ANI_WEAPON_2W
-					GetEquipmentResRef(OffhandRef,true,NewResRef,Cycle,
-										 equipdat);
-				}
-			} else if (part == actorPartCount+2) {
-				if (HelmetRef[0] == 0) continue;
-				// helmet
-				GetEquipmentResRef(HelmetRef,false,NewResRef,Cycle,equipdat);
-			}
-		}
-		NewResRef[8]=0; //cutting right to size
-
+		const char* NewResRef = parts[part].NewResRef;
+		unsigned char Cycle = parts[part].Cycle;
 		AnimationFactory* af = ( AnimationFactory* )
 			gamedata->GetFactoryResource( NewResRef,
 					IE_BAM_CLASS_ID, IE_NORMAL );
@@ -1096,7 +1172,6 @@ Animation** CharAnimations::GetAnimation(unsigned char Stance, unsigned char Ori
 				for (int i = 0; i < part; ++i)
 					delete anims[i];
 				delete[] anims;
-				delete equipdat;
 				return 0;
 			} else {
 				// not fatal if animation for equipment is missing
@@ -1114,7 +1189,6 @@ Animation** CharAnimations::GetAnimation(unsigned char Stance, unsigned char Ori
 				for (int i = 0; i < part; ++i)
 					delete anims[i];
 				delete[] anims;
-				delete equipdat;
 				return 0;
 			} else {
 				// not fatal if animation for equipment is missing
@@ -1289,7 +1363,6 @@ Animation** CharAnimations::GetAnimation(unsigned char Stance, unsigned char Ori
 		default:
 			error("CharAnimations", "Unknown animation type\n");
 	}
-	delete equipdat;
 	previousStanceID = StanceID;
 
 	return Anims[StanceID][Orient];
@@ -197,6 +197,8 @@ public:
 
 	// returns an array of animations of size GetTotalPartCount()
 	Animation** GetAnimation(unsigned char Stance, unsigned char Orient);
+	// starts decoding the BAMs of these stances in the background
+	void PrefetchStances(const unsigned char* stances, int count);
 	int GetTotalPartCount() const;
 	const int* GetZOrder(unsigned char Orient);
 	Animation** GetShadowAnimation(unsigned char Stance, unsigned char Orient);
@@ -222,6 +224,7 @@ public: //attribute functions
 	void DebugDump();
 private:
 	void DropAnims();
+	void SetModifiedPalette(PaletteType type, Palette* pal);
 	void InitAvatarsTable();
 	int GetActorPartCount() const;
 	void AddPSTSuffix(char* ResRef, unsigned char AnimID,
@@ -272,6 +275,9 @@ private:
 		char* ResRef, unsigned char& Cycle, int Part, EquipResRefData*& equip);
 	void GetEquipmentResRef(const char* equipRef, bool offhand,
 		char* ResRef, unsigned char& Cycle, EquipResRefData* equip);
+	bool GetPartResRef(unsigned char Stance, unsigned char Orient, int part,
+		char* NewResRef, unsigned char& Cycle, EquipResRefData*& equipdat);
+	unsigned char ResolveStance(unsigned char Stance, unsigned char& Orient) const;
 	unsigned char MaybeOverrideStance(unsigned char stance) const;
 	void MaybeUpdateMainPalette(Animation**);
 };
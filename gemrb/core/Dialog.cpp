@@ -31,7 +31,6 @@ Dialog::Dialog(void)
 {
 	TopLevelCount = 0;
 	Flags = 0;
-	Order = NULL;
 	initialStates = NULL;
 }
 
@@ -45,7 +44,6 @@ Dialog::~Dialog(void)
 		}
 		free(initialStates);
 	}
-	if (Order) free(Order);
 }
 
 DialogState* Dialog::GetState(unsigned int index)
@@ -75,9 +73,8 @@ void Dialog::FreeDialogState(DialogState* ds)
 
 int Dialog::FindFirstState(Scriptable* target)
 {
-	for (unsigned int i = 0; i < TopLevelCount; i++) {
-		Condition *cond = GetState( Order[i] )->condition;
-		if (cond && cond->Evaluate(target)) {
+	for (size_t i = 0; i < Order.size(); i++) {
+		if (initialStates[Order[i]]->condition->Evaluate(target)) {
 			return Order[i];
 		}
 	}
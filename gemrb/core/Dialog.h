@@ -61,7 +61,7 @@ struct DialogState {
 	DialogTransition** transitions;
 	unsigned int transitionsCount;
 	Condition* condition;
-	unsigned int weight;
+	unsigned int weight; // the index of its trigger, lower ones are checked first
 };
 
 class GEM_EXPORT Dialog {
@@ -84,7 +84,8 @@ public:
 	ieResRef ResRef;
 	ieDword Flags; //freeze flags (bg2)
 	unsigned int TopLevelCount;
-	ieDword* Order;
+	// the states FindFirstState can pick, by weight
+	std::vector<unsigned int> Order;
 	DialogState** initialStates;
 };
 
@@ -21,7 +21,6 @@
 
 #include "strrefs.h"
 
-#include "DialogMgr.h"
 #include "DisplayMessage.h"
 #include "Game.h"
 #include "GameData.h"
@@ -60,7 +59,15 @@ DialogHandler::DialogHandler(void)
 
 DialogHandler::~DialogHandler(void)
 {
-	delete dlg;
+	FreeDialog();
+}
+
+void DialogHandler::FreeDialog()
+{
+	if (dlg) {
+		gamedata->FreeDialog(dlg, dlg->ResRef);
+		dlg = NULL;
+	}
 }
 
 void DialogHandler::UpdateJournalForTransition(DialogTransition* tr)
@@ -103,24 +110,18 @@ void DialogHandler::UpdateJournalForTransition(DialogTransition* tr)
 //Try to start dialogue between two actors (one of them could be inanimate)
 bool DialogHandler::InitDialog(Scriptable* spk, Scriptable* tgt, const char* dlgref, ieDword si)
 {
-	delete dlg;
-	dlg = NULL;
+	FreeDialog();
 
 	if (!dlgref || dlgref[0] == '\0' || dlgref[0] == '*') {
 		return false;
 	}
 
-	PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
-	dm->Open(gamedata->GetResource(dlgref, IE_DLG_CLASS_ID));
-	dlg = dm->GetDialog();
-
+	dlg = gamedata->GetDialog(dlgref);
 	if (!dlg) {
 		Log(ERROR, "DialogHandler", "Cannot start dialog (%s): %s with %s", dlgref, spk->GetName(1), tgt->GetName(1));
 		return false;
 	}
 
-	strnlwrcpy(dlg->ResRef, dlgref, 8); //this isn't handled by GetDialog???
-
 	//target is here because it could be changed when a dialog runs onto
 	//and external link, we need to find the new target (whose dialog was
 	//linked to)
@@ -232,8 +233,7 @@ void DialogHandler::EndDialog(bool try_to_break)
 		tmp->SetCircleSize();
 	}
 	ds = NULL;
-	delete dlg;
-	dlg = NULL;
+	FreeDialog();
 
 	// FIXME: it's not so nice having this here, but things call EndDialog directly :(
 	core->GetGUIScriptEngine()->RunFunction( "GUIWORLD", "DialogEnded" );
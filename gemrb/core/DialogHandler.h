@@ -52,6 +52,7 @@ private:
 	/** this function safely retrieves an Actor by ID */
 	Actor *GetActorByGlobalID(ieDword ID);
 	void UpdateJournalForTransition(DialogTransition *tr);
+	void FreeDialog();
 
 	DialogState* ds;
 	Dialog* dlg;
@@ -0,0 +1,265 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "FlowField.h"
+
+#include "Game.h"
+#include "Interface.h"
+#include "Map.h"
+
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+
+namespace GemRB {
+
+// neighbours and the cost of stepping to them, in navmap pixels
+static const int FlowDX[8] = { 1, 0, -1, 0, 1, -1, -1, 1 };
+static const int FlowDY[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const unsigned int FlowCost[8] = { 16, 12, 16, 12, 20, 20, 20, 20 };
+
+enum { FLOW_UNKNOWN, FLOW_OPEN, FLOW_BLOCKED };
+
+static ieDword FlowTime()
+{
+	const Game* game = core->GetGame();
+	return game ? game->GameTime : 0;
+}
+
+static inline bool NearGoal(const SearchmapPoint& a, const SearchmapPoint& b)
+{
+	return std::abs(a.x - b.x) <= FLOWFIELD_GOAL_RADIUS && std::abs(a.y - b.y) <= FLOWFIELD_GOAL_RADIUS;
+}
+
+FlowField::FlowField(const Map* map, const NavmapPoint& goal, unsigned int size, ieDword time)
+	: goal(goal), size(size), created(time)
+{
+	SearchmapPoint smptGoal(goal.x / 16, goal.y / 12);
+	int x1 = std::max(0, smptGoal.x - FLOWFIELD_RADIUS);
+	int y1 = std::max(0, smptGoal.y - FLOWFIELD_RADIUS);
+	int x2 = std::min(map->GetWidth() - 1, smptGoal.x + FLOWFIELD_RADIUS);
+	int y2 = std::min(map->GetHeight() - 1, smptGoal.y + FLOWFIELD_RADIUS);
+	bounds = Region(x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+	if (bounds.w <= 0 || bounds.h <= 0 || !Inside(smptGoal)) {
+		bounds = Region();
+		return;
+	}
+
+	dist.assign(bounds.w * bounds.h, UINT_MAX);
+	// the searchmap lookups are the expensive part, so they are done once per square
+	std::vector<char> state(bounds.w * bounds.h, FLOW_UNKNOWN);
+	typedef std::pair<unsigned int, size_t> QueueEntry;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > open;
+
+	size_t start = Index(smptGoal.x, smptGoal.y);
+	dist[start] = 0;
+	state[start] = FLOW_OPEN;
+	open.push(QueueEntry(0, start));
+
+	while (!open.empty()) {
+		QueueEntry current = open.top();
+		open.pop();
+		if (current.first > dist[current.second]) continue;
+
+		int x = bounds.x + int(current.second % bounds.w);
+		int y = bounds.y + int(current.second / bounds.w);
+		bool passable[4];
+		for (int i = 0; i < 8; i++) {
+			int nx = x + FlowDX[i];
+			int ny = y + FlowDY[i];
+			bool walkable = false;
+			if (Inside(SearchmapPoint(nx, ny))) {
+				size_t idx = Index(nx, ny);
+				if (state[idx] == FLOW_UNKNOWN) {
+					// same test as FindPath, actors don't block
+					unsigned int blocked = map->GetBlockedInRadius(nx * 16 + 8, ny * 12 + 6, size);
+					state[idx] = (blocked & (PATH_MAP_PASSABLE | PATH_MAP_ACTOR | PATH_MAP_TRAVEL)) ? FLOW_OPEN : FLOW_BLOCKED;
+				}
+				walkable = state[idx] == FLOW_OPEN;
+			}
+			if (i < 4) {
+				passable[i] = walkable;
+			} else if (!passable[i - 4] || !passable[(i - 3) % 4]) {
+				// don't cut corners
+				continue;
+			}
+			if (!walkable) continue;
+
+			size_t idx = Index(nx, ny);
+			unsigned int newDist = current.first + FlowCost[i];
+			if (newDist < dist[idx]) {
+				dist[idx] = newDist;
+				open.push(QueueEntry(newDist, idx));
+			}
+		}
+	}
+}
+
+bool FlowField::Inside(const SearchmapPoint& p) const
+{
+	return p.x >= bounds.x && p.y >= bounds.y && p.x < bounds.x + bounds.w && p.y < bounds.y + bounds.h;
+}
+
+bool FlowField::Reachable(const SearchmapPoint& p) const
+{
+	return DistanceAt(p) != UINT_MAX;
+}
+
+unsigned int FlowField::DistanceAt(const SearchmapPoint& p) const
+{
+	if (!Inside(p)) return UINT_MAX;
+	return dist[Index(p.x, p.y)];
+}
+
+// the distances of the neighbours of p, with the diagonals past a wall corner
+// left out just like when the field was built; any open square next to a
+// reachable one is reachable, so unreachable ones are the blocked ones
+void FlowField::Neighbours(const SearchmapPoint& p, unsigned int out[8]) const
+{
+	for (int i = 0; i < 8; i++) {
+		out[i] = DistanceAt(SearchmapPoint(p.x + FlowDX[i], p.y + FlowDY[i]));
+		if (i >= 4 && (out[i - 4] == UINT_MAX || out[(i - 3) % 4] == UINT_MAX)) {
+			// don't cut corners
+			out[i] = UINT_MAX;
+		}
+	}
+}
+
+bool FlowField::Descend(SearchmapPoint& p) const
+{
+	unsigned int best = DistanceAt(p);
+	unsigned int around[8];
+	Neighbours(p, around);
+	SearchmapPoint next = p;
+	for (int i = 0; i < 8; i++) {
+		SearchmapPoint n(p.x + FlowDX[i], p.y + FlowDY[i]);
+		unsigned int d = around[i];
+		if (d < best) {
+			best = d;
+			next = n;
+		}
+	}
+	if (next == p) return false;
+	p = next;
+	return true;
+}
+
+int FlowField::Downhill(const SearchmapPoint& p, SearchmapPoint out[8]) const
+{
+	unsigned int here = DistanceAt(p);
+	unsigned int around[8];
+	Neighbours(p, around);
+	unsigned int dists[8];
+	int count = 0;
+	for (int i = 0; i < 8; i++) {
+		SearchmapPoint n(p.x + FlowDX[i], p.y + FlowDY[i]);
+		unsigned int d = around[i];
+		if (d >= here) continue;
+		// insertion sort, there are at most eight
+		int j = count++;
+		while (j > 0 && dists[j - 1] > d) {
+			dists[j] = dists[j - 1];
+			out[j] = out[j - 1];
+			j--;
+		}
+		dists[j] = d;
+		out[j] = n;
+	}
+	return count;
+}
+
+bool FlowFieldCache::Enabled = true;
+
+FlowFieldCache::FlowFieldCache()
+{
+}
+
+FlowFieldCache::~FlowFieldCache()
+{
+	Clear();
+}
+
+void FlowFieldCache::Clear()
+{
+	for (size_t i = 0; i < fields.size(); i++) {
+		delete fields[i];
+	}
+	fields.clear();
+	requests.clear();
+}
+
+void FlowFieldCache::Expire(ieDword now)
+{
+	for (size_t i = fields.size(); i--; ) {
+		// the clock is also reset on game loads, so handle it going back
+		if (fields[i]->created + FLOWFIELD_TTL < now || fields[i]->created > now) {
+			delete fields[i];
+			fields.erase(fields.begin() + i);
+		}
+	}
+	for (size_t i = requests.size(); i--; ) {
+		if (requests[i].time + FLOWFIELD_TTL < now || requests[i].time > now) {
+			requests.erase(requests.begin() + i);
+		}
+	}
+}
+
+const FlowField* FlowFieldCache::Find(const NavmapPoint& goal, unsigned int size) const
+{
+	SearchmapPoint smptGoal(goal.x / 16, goal.y / 12);
+	for (size_t i = 0; i < fields.size(); i++) {
+		const FlowField* field = fields[i];
+		if (field->size == size && NearGoal(SearchmapPoint(field->goal.x / 16, field->goal.y / 12), smptGoal)) {
+			return field;
+		}
+	}
+	return NULL;
+}
+
+const FlowField* FlowFieldCache::Request(const Map* map, const NavmapPoint& goal, unsigned int size)
+{
+	if (!Enabled) return NULL;
+
+	ieDword now = FlowTime();
+	Expire(now);
+	const FlowField* field = Find(goal, size);
+	if (field) return field;
+
+	SearchmapPoint smptGoal(goal.x / 16, goal.y / 12);
+	for (size_t i = 0; i < requests.size(); i++) {
+		if (requests[i].size != size || !NearGoal(requests[i].goal, smptGoal)) continue;
+
+		// somebody else is going there too, so it pays off
+		requests.erase(requests.begin() + i);
+		if (fields.size() >= FLOWFIELD_CACHE_SIZE) {
+			delete fields.front();
+			fields.erase(fields.begin());
+		}
+		fields.push_back(new FlowField(map, goal, size, now));
+		return fields.back();
+	}
+
+	GoalRequest request = { smptGoal, size, now };
+	requests.push_back(request);
+	return NULL;
+}
+
+}
@@ -0,0 +1,124 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+/**
+ * @file FlowField.h
+ * Declares FlowField, the shared distance field used when many actors
+ * walk to the same place
+ * @author The GemRB Project
+ */
+
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "exports.h"
+#include "globals.h"
+
+#include "Region.h"
+#include "PathFinder.h"
+
+#include <vector>
+
+namespace GemRB {
+
+class Map;
+
+// how far from the goal the field reaches, in searchmap squares
+#define FLOWFIELD_RADIUS 64
+// goals closer than this (in searchmap squares) share a field
+#define FLOWFIELD_GOAL_RADIUS 6
+// actors stop following the field this close (in searchmap squares) to
+// their own goal and search the rest, must be larger than the goal radius
+#define FLOWFIELD_APPROACH 10
+// how long a field is kept, in game ticks
+#define FLOWFIELD_TTL (2 * AI_UPDATE_TIME)
+// how many fields are kept per area
+#define FLOWFIELD_CACHE_SIZE 4
+
+/**
+ * @class FlowField
+ * Walking distance to a goal from every searchmap square around it,
+ * computed once with Dijkstra, so any number of actors can find their
+ * way there by always stepping to the neighbour closest to the goal.
+ * Actors are ignored, like when pathfinding without PF_ACTORS_ARE_BLOCKING,
+ * since they will have moved by the time anyone arrives.
+ */
+
+class GEM_EXPORT FlowField {
+public:
+	FlowField(const Map* map, const NavmapPoint& goal, unsigned int size, ieDword time);
+
+	NavmapPoint goal;
+	unsigned int size;
+	ieDword created;
+
+	/** true if the goal can be reached from p */
+	bool Reachable(const SearchmapPoint& p) const;
+	/** the walking distance from p to the goal, in navmap pixels */
+	unsigned int DistanceAt(const SearchmapPoint& p) const;
+	/** moves p to its neighbour closest to the goal, false if there is none */
+	bool Descend(SearchmapPoint& p) const;
+	/** fills out with the neighbours of p closer to the goal, closest first, returns their count */
+	int Downhill(const SearchmapPoint& p, SearchmapPoint out[8]) const;
+
+private:
+	Region bounds; // in searchmap squares
+	std::vector<unsigned int> dist;
+
+	bool Inside(const SearchmapPoint& p) const;
+	void Neighbours(const SearchmapPoint& p, unsigned int out[8]) const;
+	size_t Index(int x, int y) const { return (y - bounds.y) * bounds.w + x - bounds.x; }
+};
+
+/**
+ * @class FlowFieldCache
+ * The fields of an area. A field is only built once a second actor asks for a
+ * path to near the same goal, so single moves still get a plain search.
+ */
+
+class GEM_EXPORT FlowFieldCache {
+public:
+	/** turns the group pathfinding on or off, mostly for benchmarking */
+	static bool Enabled;
+
+	FlowFieldCache();
+	~FlowFieldCache();
+
+	/** notes a path request to goal, returns the field to follow if there is one */
+	const FlowField* Request(const Map* map, const NavmapPoint& goal, unsigned int size);
+	/** the field leading to near goal, without building one */
+	const FlowField* Find(const NavmapPoint& goal, unsigned int size) const;
+	void Clear();
+
+private:
+	struct GoalRequest {
+		SearchmapPoint goal;
+		unsigned int size;
+		ieDword time;
+	};
+	std::vector<FlowField*> fields;
+	std::vector<GoalRequest> requests;
+
+	void Expire(ieDword now);
+};
+
+}
+
+#endif
@@ -108,6 +108,7 @@ void Control::Draw(unsigned short x, unsigned short y)
 	Region clip = video->GetScreenClip();
 	video->SetScreenClip(&drawFrame);
 	DrawInternal(drawFrame);
+	video->InvalidateRegion(drawFrame.Intersect(clip));
 	video->SetScreenClip(&clip);
 	Changed = false; // set *after* calling DrawInternal
 }
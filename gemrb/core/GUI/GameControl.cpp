@@ -1007,6 +1007,12 @@ bool GameControl::OnKeyRelease(unsigned char Key, unsigned short Mod)
 				core->FogOfWar ^= FOG_DRAWSEARCHMAP;
 				Log(MESSAGE, "GameControl", "Show searchmap %s", core->FogOfWar & FOG_DRAWSEARCHMAP ? "ON" : "OFF");
 				break;
+			case '9': //outline the redrawn screen regions
+				core->DrawDirtyRegions = !core->DrawDirtyRegions;
+				core->GetVideoDriver()->SetDrawDirtyRegions(core->DrawDirtyRegions);
+				core->GetVideoDriver()->InvalidateAll();
+				Log(MESSAGE, "GameControl", "Show redrawn regions %s", core->DrawDirtyRegions ? "ON" : "OFF");
+				break;
 			default:
 				Log(MESSAGE, "GameControl", "KeyRelease:%d - %d", Key, Mod );
 				break;
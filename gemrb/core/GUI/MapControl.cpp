@@ -25,6 +25,7 @@
 #include "Game.h"
 #include "GlobalTimer.h"
 #include "Map.h"
+#include "Palette.h"
 #include "Sprite2D.h"
 #include "GUI/EventMgr.h"
 #include "GUI/Window.h"
@@ -93,6 +94,8 @@ MapControl::MapControl(const Region& frame)
 	MarkDirty();
 	convertToGame = true;
 	memset(Flag,0,sizeof(Flag) );
+	fogSprite = NULL;
+	fogRevision = 0;
 
 	// initialize var and event callback to no-ops
 	VarName[0] = 0;
@@ -101,11 +104,14 @@ MapControl::MapControl(const Region& frame)
 	ResetEventHandler( MapControlOnDoublePress );
 
 	MyMap = core->GetGame()->GetCurrentArea();
-	if (MyMap && MyMap->SmallMap) {
-		MapMOS = MyMap->SmallMap;
-		MapMOS->acquire();
-	} else
-		MapMOS = NULL;
+	MapMOS = NULL;
+	partMOS = NULL;
+	if (MyMap) {
+		smallMapSize = MyMap->GetSmallMapSize();
+		if (MyMap->IsSmallMapDecoded()) {
+			UpdateSmallMap();
+		}
+	}
 }
 
 MapControl::~MapControl(void)
@@ -113,35 +119,106 @@ MapControl::~MapControl(void)
 	if (MapMOS) {
 		Sprite2D::FreeSprite(MapMOS);
 	}
+	if (partMOS) {
+		Sprite2D::FreeSprite(partMOS);
+	}
 	for(int i=0;i<8;i++) {
 		if (Flag[i]) {
 			Sprite2D::FreeSprite(Flag[i]);
 		}
 	}
+	if (fogSprite) {
+		Sprite2D::FreeSprite(fogSprite);
+	}
 }
 
-// Draw fog on the small bitmap
-void MapControl::DrawFog(const Region& rgn)
+// Refresh the fog sprite, only the rows explored since the last update
+// are recomputed; the whole mask is redone when the sprite is missing
+void MapControl::UpdateFog()
 {
-	ieWord XWin = rgn.x;
-	ieWord YWin = rgn.y;
-	Video *video = core->GetVideoDriver();
-
 	// FIXME: this is ugly, the knowledge of Map and ExploredMask
 	//   sizes should be in Map.cpp
 	int w = MyMap->GetWidth() / 2;
 	int h = MyMap->GetHeight() / 2;
+	int pitch = w * MAP_DIV;
+	int height = h * MAP_DIV;
+
+	bool full = !fogSprite || fogSprite->Width != pitch || fogSprite->Height != height;
+	ieDword revision = MyMap->GetExploredRevision();
+	if (!full && revision == fogRevision) {
+		return;
+	}
+	if (full) {
+		fogPixels.assign(pitch * height, 0);
+	}
 
 	for (int y = 0; y < h; y++) {
+		if (!full && MyMap->GetExploredRowRevision(y) <= fogRevision) {
+			continue;
+		}
+		unsigned char* row = &fogPixels[y * MAP_DIV * pitch];
 		for (int x = 0; x < w; x++) {
 			Point p( (short) (MAP_MULT * x), (short) (MAP_MULT * y) );
-			bool visible = MyMap->IsVisible( p, true );
-			if (! visible) {
-				Region rgn = Region ( MAP_TO_SCREENX(MAP_DIV * x), MAP_TO_SCREENY(MAP_DIV * y), MAP_DIV, MAP_DIV );
-				video->DrawRect( rgn, colors[black] );
-			}
+			// index 0 is the transparent colour key, 1 is black
+			unsigned char fog = MyMap->IsVisible( p, true ) ? 0 : 1;
+			memset(row + x * MAP_DIV, fog, MAP_DIV);
+		}
+		for (int i = 1; i < MAP_DIV; i++) {
+			memcpy(row + i * pitch, row, pitch);
+		}
+	}
+	fogRevision = revision;
+
+	// sprites own their pixels, so hand over a copy of the mask
+	void* pixels = malloc(fogPixels.size());
+	memcpy(pixels, &fogPixels[0], fogPixels.size());
+	Palette* pal = new Palette();
+	pal->col[1] = colors[black];
+	if (fogSprite) {
+		Sprite2D::FreeSprite(fogSprite);
+	}
+	fogSprite = core->GetVideoDriver()->CreateSprite8(pitch, height, pixels, pal, true, 0);
+	pal->release();
+}
+
+// Big small maps take a while to decode, so on the first draw only the part
+// in view is, and the rest on the next one
+void MapControl::UpdateSmallMap()
+{
+	if (MapMOS || !MyMap) {
+		return;
+	}
+	if (!partMOS && !MyMap->IsSmallMapDecoded()) {
+		partRegion = Region(SCREEN_TO_MAPX(0), SCREEN_TO_MAPY(0), Width, Height);
+		partRegion = partRegion.Intersect(Region(0, 0, smallMapSize.w, smallMapSize.h));
+		if (partRegion.w < smallMapSize.w || partRegion.h < smallMapSize.h) {
+			partMOS = MyMap->GetSmallMapPart(partRegion);
+		}
+		if (partMOS) {
+			return;
 		}
 	}
+
+	if (partMOS) {
+		Sprite2D::FreeSprite(partMOS);
+		partMOS = NULL;
+	}
+	MapMOS = MyMap->GetSmallMap();
+	if (MapMOS) {
+		MapMOS->acquire();
+	}
+}
+
+// Draw fog on the small bitmap
+void MapControl::DrawFog(const Region& rgn)
+{
+	ieWord XWin = rgn.x;
+	ieWord YWin = rgn.y;
+
+	UpdateFog();
+	if (fogSprite) {
+		core->GetVideoDriver()->BlitSprite( fogSprite, MAP_TO_SCREENX(0), MAP_TO_SCREENY(0), true, &rgn );
+	}
 }
 
 // To be called after changes in control's or screen geometry
@@ -152,13 +229,8 @@ void MapControl::Realize()
 	//MapWidth = map->GetWidth();
 	//MapHeight = map->GetHeight();
 
-	if (MapMOS) {
-		MapWidth = (short) MapMOS->Width;
-		MapHeight = (short) MapMOS->Height;
-	} else {
-		MapWidth = 0;
-		MapHeight = 0;
-	}
+	MapWidth = (short) smallMapSize.w;
+	MapHeight = (short) smallMapSize.h;
 
 	// FIXME: ugly hack! What is the actual viewport size?
 	ViewWidth = (short) (core->Width * MAP_DIV / MAP_MULT);
@@ -183,6 +255,7 @@ void MapControl::DrawInternal(Region& rgn)
 	ieWord YWin = rgn.y;
 
 	Realize();
+	UpdateSmallMap();
 
 	// we're going to paint over labels/etc, so they need to repaint!
 	bool seen_this = false;
@@ -202,6 +275,8 @@ void MapControl::DrawInternal(Region& rgn)
 	Video* video = core->GetVideoDriver();
 	if (MapMOS) {
 		video->BlitSprite( MapMOS, MAP_TO_SCREENX(0), MAP_TO_SCREENY(0), true, &rgn );
+	} else if (partMOS) {
+		video->BlitSprite( partMOS, MAP_TO_SCREENX(partRegion.x), MAP_TO_SCREENY(partRegion.y), true, &rgn );
 	}
 
 	if (core->FogOfWar&FOG_DRAWFOG)
@@ -221,15 +296,27 @@ void MapControl::DrawInternal(Region& rgn)
 
 	video->DrawRect( vp, colors[green], false, false );
 
+	// PCs' and note ellipses are collected and drawn in one batch
+	std::vector<VideoEllipse> markers;
+	VideoEllipse marker;
+
 	// Draw PCs' ellipses
 	Game *game = core->GetGame();
 	i = game->GetPartySize(true);
+	markers.reserve(i);
 	while (i--) {
 		const Actor *actor = game->GetPC(i, true);
 		if (MyMap->HasActor(actor) ) {
-			video->DrawEllipse( (short) GAME_TO_SCREENX(actor->Pos.x), (short) GAME_TO_SCREENY(actor->Pos.y), 3, 2, actor->Selected ? colors[green] : colors[darkgreen], false );
+			marker.center.x = (short) GAME_TO_SCREENX(actor->Pos.x);
+			marker.center.y = (short) GAME_TO_SCREENY(actor->Pos.y);
+			marker.xr = 3;
+			marker.yr = 2;
+			marker.color = actor->Selected ? colors[green] : colors[darkgreen];
+			markers.push_back(marker);
 		}
 	}
+	// notes with flags are blitted after the batch, so they stay on top
+	std::vector<std::pair<Sprite2D*, Point> > flags;
 	// Draw Map notes, could be turned off in bg2
 	// we use the common control value to handle it, because then we
 	// don't need another interface
@@ -255,12 +342,24 @@ void MapControl::DrawInternal(Region& rgn)
 				continue;
 
 			if (anim) {
-				video->BlitSprite( anim, vp.x - anim->Width/2, vp.y - anim->Height/2, true, &rgn );
+				flags.push_back(std::make_pair(anim, Point(vp.x - anim->Width/2, vp.y - anim->Height/2)));
 			} else {
-				video->DrawEllipse( (short) vp.x, (short) vp.y, 6, 5, colors[mn.color&7], false );
+				marker.center.x = (short) vp.x;
+				marker.center.y = (short) vp.y;
+				marker.xr = 6;
+				marker.yr = 5;
+				marker.color = colors[mn.color&7];
+				markers.push_back(marker);
 			}
 		}
 	}
+
+	if (!markers.empty()) {
+		video->DrawEllipses(markers, false);
+	}
+	for (size_t f = 0; f < flags.size(); f++) {
+		video->BlitSprite( flags[f].first, flags[f].second.x, flags[f].second.y, true, &rgn );
+	}
 }
 
 /** Mouse Over Event */
@@ -31,6 +31,8 @@
 #include "exports.h"
 #include "Interface.h"
 
+#include <vector>
+
 namespace GemRB {
 
 // !!! Keep these synchronized with GUIDefines.py !!!
@@ -50,6 +52,14 @@ protected:
 	/** Draws the Control on the Output Display */
 	void DrawInternal(Region& drawFrame);
 	void DrawFog(const Region& rgn);
+	/** Gets the small map, the first time only the part in view */
+	void UpdateSmallMap();
+	/** Refreshes the cached fog sprite from the rows explored since the last draw */
+	void UpdateFog();
+	// fog of war over the small map, one byte per pixel
+	Sprite2D* fogSprite;
+	std::vector<unsigned char> fogPixels;
+	ieDword fogRevision;
 public:
 	int ScrollX, ScrollY;
 	int NotePosX, NotePosY;
@@ -58,6 +68,10 @@ public:
 	bool convertToGame;
 	// Small map bitmap
 	Sprite2D* MapMOS;
+	// the part of it in view, shown while the rest isn't decoded yet
+	Sprite2D* partMOS;
+	Region partRegion;
+	Size smallMapSize;
 	// current map
 	Map *MyMap;
 	// map flags
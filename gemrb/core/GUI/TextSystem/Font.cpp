@@ -31,6 +31,9 @@
 
 namespace GemRB {
 
+// number of glyph runs each font remembers
+#define GLYPH_RUN_CACHE_SIZE 128
+
 static void BlitGlyphToCanvas(const Glyph& glyph, const Point& p,
 							  ieByte* canvas, const Size& size)
 {
@@ -157,6 +160,7 @@ Font::Font(Palette* pal, ieWord lineheight, ieWord baseline)
 
 Font::~Font(void)
 {
+	ClearRunCache();
 	GlyphAtlas::iterator it;
 	for (it = Atlas.begin(); it != Atlas.end(); ++it) {
 		delete *it;
@@ -197,6 +201,8 @@ const Glyph& Font::CreateGlyphForCharSprite(ieWord chr, const Sprite2D* spr)
 	assert(CurrentAtlasPage);
 	const Glyph& g = CurrentAtlasPage->GlyphForChr(chr);
 	CreateGlyphIndex(chr, Atlas.size() - 1, &g);
+	// a glyph that was missing before would have been measured as blank
+	ClearRunCache();
 	return g;
 }
 
@@ -210,6 +216,7 @@ void Font::CreateAliasForChar(ieWord chr, ieWord alias)
 	ieWord pageIdx = idx.pageIdx;
 	CreateGlyphIndex(alias, pageIdx, idx.glyph);
 	Atlas[pageIdx]->MapSheetSegment(alias, (*Atlas[pageIdx])[chr]);
+	ClearRunCache();
 }
 
 const Glyph& Font::GetGlyph(ieWord chr) const
@@ -224,9 +231,68 @@ const Glyph& Font::GetGlyph(ieWord chr) const
 	return blank;
 }
 
+static size_t GlyphRunHash(const String& string, const Size& size, ieByte alignment, const Point& start)
+{
+	size_t hash = std::hash<String>()(string);
+	const int fields[] = { size.w, size.h, alignment, start.x, start.y };
+	for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+		hash = hash * 31 + static_cast<size_t>(fields[i]);
+	}
+	return hash;
+}
+
+const Font::GlyphRun* Font::FindRun(size_t hash, const String& string, const Size& size,
+									ieByte alignment, const Point& start) const
+{
+	std::unordered_map<size_t, GlyphRunList::iterator>::iterator it = RunIndex.find(hash);
+	if (it == RunIndex.end()) {
+		return NULL;
+	}
+	GlyphRunList::iterator run = it->second;
+	if (run->size != size || run->alignment != alignment || run->start != start || run->text != string) {
+		return NULL;
+	}
+	// move to the front, so it is the last to be evicted
+	RunCache.splice(RunCache.begin(), RunCache, run);
+	return &(*run);
+}
+
+void Font::CacheRun(const GlyphRun& run) const
+{
+	std::unordered_map<size_t, GlyphRunList::iterator>::iterator it = RunIndex.find(run.hash);
+	if (it != RunIndex.end()) {
+		// hash collision, the newer one wins
+		RunCache.erase(it->second);
+		RunIndex.erase(it);
+	}
+	if (RunCache.size() >= GLYPH_RUN_CACHE_SIZE) {
+		RunIndex.erase(RunCache.back().hash);
+		RunCache.pop_back();
+	}
+	RunCache.push_front(run);
+	RunIndex[run.hash] = RunCache.begin();
+}
+
+void Font::DrawRun(const GlyphRun& run, const Point& origin, Palette* color) const
+{
+	std::vector<GlyphRun::PlacedGlyph>::const_iterator it = run.glyphs.begin();
+	for (; it != run.glyphs.end(); ++it) {
+		Region dest = it->dest;
+		dest.x += origin.x;
+		dest.y += origin.y;
+		Atlas[it->pageIdx]->Draw(it->chr, dest, color);
+	}
+}
+
+void Font::ClearRunCache()
+{
+	RunIndex.clear();
+	RunCache.clear();
+}
+
 size_t Font::RenderText(const String& string, Region& rgn,
 						Palette* color, ieByte alignment,
-						Point* point, ieByte** canvas, bool grow) const
+						Point* point, ieByte** canvas, bool grow, GlyphRun* run) const
 {
 	// NOTE: vertical alignment is not handled here.
 	// it should have been calculated previously and passed in via the "point" parameter
@@ -328,7 +394,7 @@ size_t Font::RenderText(const String& string, Region& rgn,
 				core->GetVideoDriver()->DrawRect(Region(linePoint + lineRgn.Origin(),
 												 Size(lineSize.w, LineHeight)), ColorWhite, false);
 #endif
-				linePos = RenderLine(line, lineRgn, color, linePoint, canvas);
+				linePos = RenderLine(line, lineRgn, color, linePoint, canvas, run);
 			}
 			if (linePos == 0) {
 				break; // if linePos == 0 then we would loop till we are out of bounds so just stop here
@@ -381,7 +447,7 @@ size_t Font::RenderText(const String& string, Region& rgn,
 }
 
 size_t Font::RenderLine(const String& line, const Region& lineRgn,
-						Palette* color, Point& dp, ieByte** canvas) const
+						Palette* color, Point& dp, ieByte** canvas, GlyphRun* run) const
 {
 	assert(color); // must have a palette
 	assert(lineRgn.h == LineHeight);
@@ -450,6 +516,9 @@ size_t Font::RenderLine(const String& line, const Region& lineRgn,
 				size_t pageIdx = AtlasIndex[currChar].pageIdx;
 				GlyphAtlasPage* page = Atlas[pageIdx];
 				page->Draw(currChar, Region(blitPoint, curGlyph.size), color);
+				if (run) {
+					run->glyphs.push_back(GlyphRun::PlacedGlyph(currChar, pageIdx, Region(blitPoint, curGlyph.size)));
+				}
 			}
 			dp.x += curGlyph.size.w;
 		}
@@ -549,6 +618,31 @@ size_t Font::Print(Region rgn, const String& string,
 		pal = palette;
 	}
 	Point p = (point) ? *point : Point();
+
+	// RenderText skips offscreen text without laying it out, so only onscreen runs are cached
+	bool cacheable = core->GetVideoDriver()->GetScreenClip().IntersectsRegion(rgn);
+	size_t hash = 0;
+	if (cacheable) {
+		hash = GlyphRunHash(string, rgn.Dimensions(), alignment, p);
+		const GlyphRun* cached = FindRun(hash, string, rgn.Dimensions(), alignment, p);
+		if (cached) {
+			DrawRun(*cached, rgn.Origin(), pal);
+			if (point) {
+				*point = cached->end;
+			}
+			return cached->numPrinted;
+		}
+	}
+
+	GlyphRun run;
+	if (cacheable) {
+		run.hash = hash;
+		run.text = string;
+		run.size = rgn.Dimensions();
+		run.alignment = alignment;
+		run.start = p;
+	}
+
 	if (alignment&(IE_FONT_ALIGN_MIDDLE|IE_FONT_ALIGN_BOTTOM)) {
 		// we assume that point will be an offset from midde/bottom position
 		Size stringSize;
@@ -574,7 +668,17 @@ size_t Font::Print(Region rgn, const String& string,
 		}
 	}
 
-	size_t ret = RenderText(string, rgn, pal, alignment, &p);
+	size_t ret = RenderText(string, rgn, pal, alignment, &p, NULL, false, (cacheable) ? &run : NULL);
+	if (cacheable) {
+		std::vector<GlyphRun::PlacedGlyph>::iterator it = run.glyphs.begin();
+		for (; it != run.glyphs.end(); ++it) {
+			it->dest.x -= rgn.x;
+			it->dest.y -= rgn.y;
+		}
+		run.numPrinted = ret;
+		run.end = p;
+		CacheRun(run);
+	}
 	if (point) {
 		*point = p;
 	}
@@ -38,7 +38,9 @@
 #include "Sprite2D.h"
 
 #include <deque>
+#include <list>
 #include <map>
+#include <unordered_map>
 
 namespace GemRB {
 
@@ -148,6 +150,34 @@ private:
 	GlyphIndex AtlasIndex;
 	GlyphAtlas Atlas;
 
+	// the glyphs a Print call placed, so printing the same string into a region of the same size
+	// (labels, overhead text, tooltips) doesn't have to be laid out again every frame
+	struct GlyphRun {
+		struct PlacedGlyph {
+			ieWord chr;
+			ieWord pageIdx;
+			Region dest; // relative to the print region
+
+			PlacedGlyph(ieWord c, ieWord p, const Region& r) : chr(c), pageIdx(p), dest(r) {}
+		};
+
+		size_t hash;
+		String text;
+		Size size;
+		ieByte alignment;
+		Point start;
+
+		std::vector<PlacedGlyph> glyphs;
+		size_t numPrinted;
+		Point end;
+
+		GlyphRun() : hash(0), alignment(0), numPrinted(0) {}
+	};
+
+	typedef std::list<GlyphRun> GlyphRunList;
+	mutable GlyphRunList RunCache; // most recently used first
+	mutable std::unordered_map<size_t, GlyphRunList::iterator> RunIndex;
+
 protected:
 	Palette* palette;
 
@@ -158,11 +188,17 @@ public:
 private:
 	void CreateGlyphIndex(ieWord chr, ieWord pageIdx, const Glyph*);
 	// Blit to the sprite or screen if canvas is NULL
+	// the glyphs blitted to the screen are recorded in run, if given
 	size_t RenderText(const String&, Region&, Palette*, ieByte alignment,
-					  Point* = NULL, ieByte** canvas = NULL, bool grow = false) const;
+					  Point* = NULL, ieByte** canvas = NULL, bool grow = false, GlyphRun* run = NULL) const;
 	// render a single line of text. called by RenderText()
 	size_t RenderLine(const String& string, const Region& rgn, Palette* hicolor,
-					  Point& dp, ieByte** canvas = NULL) const;
+					  Point& dp, ieByte** canvas = NULL, GlyphRun* run = NULL) const;
+
+	const GlyphRun* FindRun(size_t hash, const String&, const Size&, ieByte alignment, const Point&) const;
+	void CacheRun(const GlyphRun&) const;
+	void DrawRun(const GlyphRun&, const Point& origin, Palette*) const;
+	void ClearRunCache();
 
 public:
 	Font(Palette*, ieWord lineheight, ieWord baseline);
@@ -406,19 +406,64 @@ Region ContentContainer::BoundingBoxForContent(const Content* c) const
 
 const ContentContainer::Layout& ContentContainer::LayoutForContent(const Content* c) const
 {
-	ContentLayout::const_iterator it = std::find(layout.begin(), layout.end(), c);
-	if (it != layout.end()) {
+	// search from the back, since we are mostly asked about the last content laid out
+	ContentLayout::const_reverse_iterator it = std::find(layout.rbegin(), layout.rend(), c);
+	if (it != layout.rend()) {
 		return *it;
 	}
 	static Layout NullLayout(NULL, Regions());
 	return NullLayout;
 }
 
+ContentContainer::ContentLayout::const_iterator ContentContainer::FirstLayoutBelow(int y) const
+{
+	// everything before the result ends at or above y
+	return std::upper_bound(layout.begin(), layout.end(), y, [](int y, const Layout& l) {
+		return y < l.bottom;
+	});
+}
+
+void ContentContainer::AppendLayout(const Content* content, const Regions& rgns)
+{
+	layout.push_back(Layout(content, rgns));
+	const Region& bounds = Region::RegionEnclosingRegions(rgns);
+	int bottom = bounds.y + bounds.h;
+	if (layout.size() > 1) {
+		bottom = std::max(bottom, layout[layout.size() - 2].bottom);
+	}
+	layout.back().bottom = bottom;
+}
+
+void ContentContainer::ShiftLayout(int dy)
+{
+	ContentLayout::iterator it = layout.begin();
+	for (; it != layout.end(); ++it) {
+		Regions::iterator rit = (*it).regions.begin();
+		for (; rit != (*it).regions.end(); ++rit) {
+			(*rit).y -= dy;
+		}
+		(*it).bottom -= dy;
+	}
+	contentBounds.h -= dy;
+	layoutPoint.y -= dy;
+	if (layout.empty() || layoutPoint.y < 0) {
+		layoutPoint = Point();
+	}
+}
+
 const Region* ContentContainer::ContentRegionForRect(const Region& r) const
 {
-	ContentLayout::const_iterator it = layout.begin();
+	// content flows top to bottom, so we can skip straight to the first candidate
+	// and stop once the layouts start below the rect
+	ContentLayout::const_iterator it = FirstLayoutBelow(r.y);
 	for (; it != layout.end(); ++it) {
 		const Regions& rgns = (*it).regions;
+		if (rgns.empty()) {
+			continue;
+		}
+		if (rgns.front().y >= r.y + r.h) {
+			break;
+		}
 		Regions::const_iterator rit = rgns.begin();
 		for (; rit != rgns.end(); ++rit) {
 			if ((*rit).IntersectsRegion(r)) {
@@ -470,12 +515,14 @@ void ContentContainer::LayoutContentsFrom(ContentList::const_iterator it)
 		it++;
 	}
 	// clear the existing layout, but only for "it" and onward
+	// the layout is kept in content order, so everything after the first match goes too
 	ContentList::const_iterator clearit = it;
 	for (; clearit != contents.end(); ++clearit) {
 		ContentLayout::iterator i = std::find(layout.begin(), layout.end(), *clearit);
 		if (i != layout.end()) {
 			layoutPoint = Point(); // reset cached layoutPoint
-			layout.erase(i);
+			layout.erase(i, layout.end());
+			break;
 		}
 	}
 
@@ -503,7 +550,7 @@ void ContentContainer::LayoutContentsFrom(ContentList::const_iterator it)
 			assert(exContent != content);
 		}
 		const Regions& rgns = content->LayoutForPointInRegion(layoutPoint, frame);
-		layout.push_back(Layout(content, rgns));
+		AppendLayout(content, rgns);
 		const Region& bounds = Region::RegionEnclosingRegions(rgns);
 		contentBounds.h = (bounds.y + bounds.h > contentBounds.h) ? bounds.y + bounds.h : contentBounds.h;
 		contentBounds.w = (bounds.x + bounds.w > contentBounds.w) ? bounds.x + bounds.w : contentBounds.w;
@@ -523,11 +570,14 @@ void ContentContainer::DrawContentsInRegions(const Regions& rgns, const Point& o
 	// should only have 1 region
 	const Region& rgn = rgns.front();
 
-	// TODO: intersect with the screen clip so we can bail out even earlier
-
 	const Point& drawOrigin = rgn.Origin();
 	Point drawPoint = drawOrigin;
-	ContentLayout::const_iterator it = layout.begin();
+
+	// only draw the layouts that are visible through the current clip
+	const Region& clip = core->GetVideoDriver()->GetScreenClip();
+	int clipTop = clip.y - offset.y - parentOffset.y;
+	int clipBottom = clipTop + clip.h;
+	ContentLayout::const_iterator it = FirstLayoutBelow(clipTop);
 
 #if (DEBUG_TEXT)
 	Region dr(parentOffset + offset, contentBounds);
@@ -540,6 +590,9 @@ void ContentContainer::DrawContentsInRegions(const Regions& rgns, const Point& o
 
 	for (; it != layout.end(); ++it) {
 		const Layout& l = *it;
+		if (!l.regions.empty() && l.regions.front().y >= clipBottom) {
+			break;
+		}
 		assert(drawPoint.x <= drawOrigin.x + frame.w);
 		l.content->DrawContentsInRegions(l.regions, offset + parentOffset);
 	}
@@ -550,6 +603,7 @@ void ContentContainer::DeleteContentsInRect(Region exclusion)
 	int top = exclusion.y;
 	int bottom = top;
 	const Content* content;
+	Point cachedLayoutPoint = layoutPoint;
 	while (const Region* rgn = ContentRegionForRect(exclusion)) {
 		content = ContentAtPoint(rgn->Origin());
 		assert(content);
@@ -560,6 +614,21 @@ void ContentContainer::DeleteContentsInRect(Region exclusion)
 		delete RemoveContent(content, false);
 	}
 
+	// trimming whole lines off the top (the message log) doesn't change how the rest wraps,
+	// so it is enough to move the remaining content up
+	if (top <= 0 && exclusion.x <= 0 && exclusion.x + exclusion.w >= ContentFrame().w
+		&& !layout.empty() && !layout.front().regions.empty()) {
+		const Region& first = layout.front().regions.front();
+		if (first.x == 0 && first.y >= bottom) {
+			layoutPoint = cachedLayoutPoint;
+			ShiftLayout(first.y);
+			if (parent) {
+				parent->LayoutContentsFrom(this);
+			}
+			return;
+		}
+	}
+
 	// TODO: we could optimize this to only layout content after exclusion.y
 	LayoutContentsFrom(contents.begin());
 }
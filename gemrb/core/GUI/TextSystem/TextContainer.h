@@ -114,9 +114,11 @@ protected:
 	struct Layout {
 		const Content* content;
 		Regions regions;
+		// lowest edge of this and all the preceding layouts, so the layout can be binary searched by y
+		int bottom;
 
 		Layout(const Content* c, const Regions r)
-		: content(c), regions(r) {}
+		: content(c), regions(r), bottom(0) {}
 
 		bool operator==(const Content* c) const {
 			return c == content;
@@ -171,6 +173,11 @@ protected:
 	void LayoutContentsFrom(const Content*);
 	Content* RemoveContent(const Content* content, bool doLayout);
 	const Layout& LayoutForContent(const Content*) const;
+	// first layout that may reach below y
+	ContentLayout::const_iterator FirstLayoutBelow(int y) const;
+	void AppendLayout(const Content*, const Regions&);
+	// moves all the laid out content up by dy, instead of doing a full layout
+	void ShiftLayout(int dy);
 };
 
 // TextContainers can hold any content, but they represent a string of text that is divided into TextSpans
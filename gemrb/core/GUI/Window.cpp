@@ -100,6 +100,7 @@ void Window::DrawWindow()
 	if ( (Flags & (WF_FRAME|WF_CHANGED) ) == (WF_FRAME|WF_CHANGED) ) {
 		Region screen( 0, 0, core->Width, core->Height );
 		video->SetScreenClip( NULL );
+		video->InvalidateAll();
 		//removed this?
 		video->DrawRect( screen, ColorBlack );
 		if (core->WindowFrames[0])
@@ -117,6 +118,7 @@ void Window::DrawWindow()
 	bool bgRefreshed = false;
 	if (BackGround && (Flags & (WF_FLOAT|WF_CHANGED) ) ) {
 		DrawBackground(NULL);
+		video->InvalidateRegion(clip);
 		bgRefreshed = true;
 	}
 
@@ -139,6 +141,7 @@ void Window::DrawWindow()
 	if ( (Flags&WF_CHANGED) && (Visible == WINDOW_GRAYED) ) {
 		Color black = { 0, 0, 0, 128 };
 		video->DrawRect(clip, black);
+		video->InvalidateRegion(clip);
 	}
 	video->SetScreenClip( NULL );
 	Flags &= ~WF_CHANGED;
@@ -739,11 +739,17 @@ Map* Game::GetMap(unsigned int index) const
 
 Map *Game::GetMap(const char *areaname, bool change)
 {
+	if (change) {
+		// animations read ahead for the area we leave won't be claimed anymore
+		gamedata->DropPrefetched();
+	}
 	int index = LoadMap(areaname, change);
 	if (index >= 0) {
 		if (change) {
 			MapIndex = index;
 			area = GetMap(index);
+			// what the last area needed can go now
+			gamedata->RequestCacheTrim();
 			memcpy (CurrentArea, areaname, 8);
 			//change the tileset if needed
 			area->ChangeMap(IsDay());
@@ -1570,6 +1576,7 @@ bool Game::EveryoneDead() const
 
 void Game::UpdateScripts()
 {
+	Targets::NewTick();
 	Update();
 
 	PartyAttack = false;
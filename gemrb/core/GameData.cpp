@@ -24,8 +24,9 @@
 
 #include "ActorMgr.h"
 #include "AnimationMgr.h"
-#include "Cache.h"
 #include "CharAnimations.h"
+#include "Dialog.h"
+#include "DialogMgr.h"
 #include "Effect.h"
 #include "EffectMgr.h"
 #include "Factory.h"
@@ -35,6 +36,7 @@
 #include "Interface.h"
 #include "Item.h"
 #include "ItemMgr.h"
+#include "Palette.h"
 #include "PluginMgr.h"
 #include "ResourceDesc.h"
 #include "ScriptedAnimation.h"
@@ -42,55 +44,216 @@
 #include "SpellMgr.h"
 #include "StoreMgr.h"
 #include "VEFObject.h"
+#include "GameScript/GameScript.h"
 #include "Scriptable/Actor.h"
 #include "System/FileStream.h"
+#include "System/WorkerPool.h"
 
+#include <condition_variable>
 #include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 namespace GemRB {
 
-static void ReleaseItem(void *poi)
+// how much memory items, spells and effects nobody uses may keep taking up
+#define ITEM_CACHE_BUDGET (4 * 1024 * 1024)
+#define SPELL_CACHE_BUDGET (4 * 1024 * 1024)
+#define EFFECT_CACHE_BUDGET (1024 * 1024)
+// and for parsed dialogs with their compiled conditions
+#define DIALOG_CACHE_BUDGET (4 * 1024 * 1024)
+// past this many recoloured palettes, those nobody uses anymore are dropped
+#define MODIFIED_PALETTE_LIMIT 256
+
+static void ReleaseItem(Item *item)
+{
+	delete item;
+}
+
+static void ReleaseSpell(Spell *spell)
 {
-	delete ((Item *) poi);
+	delete spell;
 }
 
-static void ReleaseSpell(void *poi)
+static void ReleaseEffect(Effect *effect)
 {
-	delete ((Spell *) poi);
+	delete effect;
 }
 
-static void ReleaseEffect(void *poi)
+static void ReleaseDialog(Dialog *dlg)
 {
-	delete ((Effect *) poi);
+	delete dlg;
 }
 
-static void ReleasePalette(void *poi)
+static void ReleasePalette(Palette *palette)
 {
 	//we allow nulls, but we shouldn't release them
-	if (!poi) return;
+	if (!palette) return;
 	//as long as palette has its own refcount, this should be Release
-	((Palette *) poi)->release();
+	palette->release();
+}
+
+// roughly what a loaded item or spell takes up, for the cache budget
+static size_t ItemSize(const Item *item)
+{
+	size_t size = sizeof(Item) + item->ExtHeaderCount * sizeof(ITMExtHeader) + item->EquippingFeatureCount * sizeof(Effect);
+	for (int i = 0; i < item->ExtHeaderCount; i++) {
+		size += item->ext_headers[i].FeatureCount * sizeof(Effect);
+	}
+	return size;
+}
+
+static size_t SpellSize(const Spell *spell)
+{
+	size_t size = sizeof(Spell) + spell->ExtHeaderCount * sizeof(SPLExtHeader) + spell->CastingFeatureCount * sizeof(Effect);
+	for (int i = 0; i < spell->ExtHeaderCount; i++) {
+		size += spell->ext_headers[i].FeatureCount * sizeof(Effect);
+	}
+	return size;
+}
+
+static size_t ConditionSize(const Condition *condition)
+{
+	return condition ? sizeof(Condition) + condition->triggers.size() * sizeof(Trigger) : 0;
+}
+
+static size_t DialogSize(const Dialog *dlg)
+{
+	size_t size = sizeof(Dialog) + dlg->TopLevelCount * sizeof(DialogState);
+	for (unsigned int i = 0; i < dlg->TopLevelCount; i++) {
+		const DialogState *ds = dlg->initialStates[i];
+		size += ConditionSize(ds->condition);
+		for (unsigned int j = 0; j < ds->transitionsCount; j++) {
+			const DialogTransition *trans = ds->transitions[j];
+			if (!trans) continue;
+			size += sizeof(DialogTransition) + ConditionSize(trans->condition) + trans->actions.size() * sizeof(Action);
+		}
+	}
+	return size;
+}
+
+static void LogCacheStats(const char *name, const ResourceCacheStats &stats)
+{
+	unsigned long lookups = stats.hits + stats.misses;
+	Log(MESSAGE, "GameData", "%-8s %5lu entries in %5lu slots, %7lukB (%lukB unused), %lu%% of %lu lookups hit, %lu evicted",
+		name, (unsigned long) stats.entries, (unsigned long) stats.slots, (unsigned long) stats.bytes / 1024,
+		(unsigned long) stats.unusedBytes / 1024, lookups ? stats.hits * 100 / lookups : 0, lookups, stats.evictions);
+}
+
+// what a recoloured palette is made of: the colours it starts from and the
+// modifiers, reduced to what applying them depends on
+struct ModifiedPaletteKey {
+	Color src[256];
+	int mods[8][6];
+	int count;
+};
+
+struct ModifiedPalettes {
+	struct Entry {
+		ModifiedPaletteKey key;
+		Palette* pal;
+	};
+	std::unordered_multimap<ieDword, Entry> entries;
+	ResourceCacheStats stats;
+
+	~ModifiedPalettes()
+	{
+		for (auto& entry : entries) {
+			entry.second.pal->release();
+		}
+	}
+};
+
+// the phase only matters for pulsing modifiers and then only within a cycle
+static void MakeModifierKey(const RGBModifier& mod, int* key)
+{
+	if (mod.speed != -1 && mod.speed <= 0) {
+		// applying it just copies the colours
+		return;
+	}
+	key[0] = mod.type;
+	key[1] = mod.speed;
+	key[2] = mod.speed > 0 ? mod.phase % (2 * mod.speed) : 0;
+	key[3] = mod.rgb.r;
+	key[4] = mod.rgb.g;
+	key[5] = mod.rgb.b;
+}
+
+// BAMs being read and decoded ahead on worker threads, see PrefetchFactoryResource
+struct PrefetchedFactory {
+	// opened, with the frames decoded
+	Holder<AnimationMgr> ani;
+	bool started = false;
+	bool done = false;
+	// nobody claimed it in time, the worker throws it away once done
+	bool dropped = false;
+};
+
+struct FactoryPrefetch {
+	std::mutex lock;
+	std::condition_variable finished;
+	// by lowercased resref
+	std::map<std::string, PrefetchedFactory> jobs;
+	// last, so the workers are gone before anything they touch
+	WorkerPool workers;
+};
+
+static std::string PrefetchKey(const char* resname)
+{
+	char key[9];
+	strnlwrcpy(key, resname, 8);
+	return key;
+}
+
+// making the sprites goes through the video driver, so this only runs on the main thread
+// ani is the prefetched animation, if there is one
+static AnimationFactory* LoadAnimationFactory(const char* resname, unsigned char mode, bool silent, Holder<AnimationMgr> ani)
+{
+	if (!ani) {
+		DataStream* ret = gamedata->GetResource(resname, IE_BAM_CLASS_ID, silent);
+		if (!ret) {
+			return NULL;
+		}
+		ani = PluginHolder<AnimationMgr>(IE_BAM_CLASS_ID);
+		if (!ani) {
+			delete ret;
+			return NULL;
+		}
+		if (!ani->Open(ret))
+			return NULL;
+	}
+	return ani->GetAnimationFactory(resname, mode);
 }
 
 GEM_EXPORT GameData* gamedata;
 
 GameData::GameData()
+: ItemCache(ReleaseItem, ITEM_CACHE_BUDGET), SpellCache(ReleaseSpell, SPELL_CACHE_BUDGET),
+	EffectCache(ReleaseEffect, EFFECT_CACHE_BUDGET), PaletteCache(ReleasePalette),
+	DialogCache(ReleaseDialog, DIALOG_CACHE_BUDGET)
 {
 	factory = new Factory();
+	prefetch = new FactoryPrefetch();
+	modifiedPalettes = new ModifiedPalettes();
 }
 
 GameData::~GameData()
 {
+	delete prefetch;
 	delete factory;
+	delete modifiedPalettes;
 	ItemSounds.clear();
 }
 
 void GameData::ClearCaches()
 {
-	ItemCache.RemoveAll(ReleaseItem);
-	SpellCache.RemoveAll(ReleaseSpell);
-	EffectCache.RemoveAll(ReleaseEffect);
-	PaletteCache.RemoveAll(ReleasePalette);
+	ItemCache.RemoveAll();
+	SpellCache.RemoveAll();
+	EffectCache.RemoveAll();
+	PaletteCache.RemoveAll();
+	DialogCache.RemoveAll();
+	DropPrefetched();
 
 	while (!stores.empty()) {
 		Store *store = stores.begin()->second;
@@ -99,6 +262,27 @@ void GameData::ClearCaches()
 	}
 }
 
+void GameData::TrimCaches()
+{
+	if (!cacheTrimPending) return;
+	cacheTrimPending = false;
+
+	ItemCache.Cleanup();
+	SpellCache.Cleanup();
+	EffectCache.Cleanup();
+	DialogCache.Cleanup();
+}
+
+void GameData::DumpCacheStats() const
+{
+	LogCacheStats("items", ItemCache.GetStats());
+	LogCacheStats("spells", SpellCache.GetStats());
+	LogCacheStats("effects", EffectCache.GetStats());
+	LogCacheStats("palettes", PaletteCache.GetStats());
+	LogCacheStats("dialogs", DialogCache.GetStats());
+	LogCacheStats("recolour", modifiedPalettes->stats);
+}
+
 Actor *GameData::GetCreature(const char* ResRef, unsigned int PartySlot)
 {
 	DataStream* ds = GetResource( ResRef, IE_CRE_CLASS_ID );
@@ -241,7 +425,7 @@ bool GameData::DelTable(unsigned int index)
 
 Palette *GameData::GetPalette(const ieResRef resname)
 {
-	Palette *palette = (Palette *) PaletteCache.GetResource(resname);
+	Palette *palette = PaletteCache.GetResource(resname);
 	if (palette) {
 		return palette;
 	}
@@ -258,7 +442,7 @@ Palette *GameData::GetPalette(const ieResRef resname)
 	palette = new Palette();
 	im->GetPalette(256,palette->col);
 	palette->named=true;
-	PaletteCache.SetAt(resname, (void *) palette);
+	PaletteCache.SetAt(resname, palette);
 	return palette;
 }
 
@@ -281,7 +465,7 @@ void GameData::FreePalette(Palette *&pal, const ieResRef name)
 	if (!pal->named) {
 		error("GameData", "Unnamed palette, it should be %s!\n", name);
 	}
-	res=PaletteCache.DecRef((void *) pal, name, true);
+	res=PaletteCache.DecRef(pal, name, true);
 	if (res<0) {
 		error("Core", "Corrupted Palette cache encountered (reference count went below zero), Palette name is: %.8s\n", name);
 	}
@@ -291,9 +475,76 @@ void GameData::FreePalette(Palette *&pal, const ieResRef name)
 	pal = NULL;
 }
 
+Palette* GameData::GetModifiedPalette(const Palette* src, const RGBModifier* mods, unsigned int type)
+{
+	return ShareModifiedPalette(src, mods + 8 * type, 8);
+}
+
+Palette* GameData::GetModifiedPalette(const Palette* src, const RGBModifier& globalMod)
+{
+	return ShareModifiedPalette(src, &globalMod, 1);
+}
+
+// crowds of the same creature glowing in step recolour the same palette
+// over and over, so each distinct result is only worked out once
+Palette* GameData::ShareModifiedPalette(const Palette* src, const RGBModifier* mods, int count)
+{
+	ModifiedPaletteKey key;
+	memset(&key, 0, sizeof(key));
+	memcpy(key.src, src->col, sizeof(key.src));
+	for (int i = 0; i < count; i++) {
+		MakeModifierKey(mods[i], key.mods[i]);
+	}
+	key.count = count;
+
+	ieDword hash = 2166136261u;
+	const unsigned char* bytes = (const unsigned char*) &key;
+	for (size_t i = 0; i < sizeof(key); i++) {
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+
+	ResourceCacheStats& stats = modifiedPalettes->stats;
+	auto range = modifiedPalettes->entries.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (!memcmp(&it->second.key, &key, sizeof(key))) {
+			stats.hits++;
+			it->second.pal->acquire();
+			return it->second.pal;
+		}
+	}
+	stats.misses++;
+
+	Palette* pal = new Palette();
+	if (count == 1) {
+		pal->SetupGlobalRGBModification(src, mods[0]);
+	} else {
+		pal->SetupRGBModification(src, mods, 0);
+	}
+
+	auto& entries = modifiedPalettes->entries;
+	if (entries.size() >= MODIFIED_PALETTE_LIMIT) {
+		for (auto it = entries.begin(); it != entries.end();) {
+			if (it->second.pal->IsShared()) {
+				++it;
+				continue;
+			}
+			it->second.pal->release();
+			it = entries.erase(it);
+			stats.evictions++;
+		}
+	}
+	ModifiedPalettes::Entry entry = { key, pal };
+	entries.insert(std::make_pair(hash, entry));
+	stats.entries = entries.size();
+	stats.bytes = stats.entries * sizeof(Palette);
+	// one reference for the cache, one for the caller
+	pal->acquire();
+	return pal;
+}
+
 Item* GameData::GetItem(const ieResRef resname, bool silent)
 {
-	Item *item = (Item *) ItemCache.GetResource(resname);
+	Item *item = ItemCache.GetResource(resname);
 	if (item) {
 		return item;
 	}
@@ -312,7 +563,7 @@ Item* GameData::GetItem(const ieResRef resname, bool silent)
 	strnlwrcpy(item->Name, resname, 8);
 	sm->GetItem( item );
 
-	ItemCache.SetAt(resname, (void *) item);
+	ItemCache.SetAt(resname, item, ItemSize(item));
 	return item;
 }
 
@@ -321,7 +572,7 @@ void GameData::FreeItem(Item const *itm, const ieResRef name, bool free)
 {
 	int res;
 
-	res=ItemCache.DecRef((void *) itm, name, free);
+	res=ItemCache.DecRef(itm, name, free);
 	if (res<0) {
 		error("Core", "Corrupted Item cache encountered (reference count went below zero), Item name is: %.8s\n", name);
 	}
@@ -331,7 +582,7 @@ void GameData::FreeItem(Item const *itm, const ieResRef name, bool free)
 
 Spell* GameData::GetSpell(const ieResRef resname, bool silent)
 {
-	Spell *spell = (Spell *) SpellCache.GetResource(resname);
+	Spell *spell = SpellCache.GetResource(resname);
 	if (spell) {
 		return spell;
 	}
@@ -350,7 +601,7 @@ Spell* GameData::GetSpell(const ieResRef resname, bool silent)
 	strnlwrcpy(spell->Name, resname, 8);
 	sm->GetSpell( spell, silent );
 
-	SpellCache.SetAt(resname, (void *) spell);
+	SpellCache.SetAt(resname, spell, SpellSize(spell));
 	return spell;
 }
 
@@ -358,7 +609,7 @@ void GameData::FreeSpell(Spell *spl, const ieResRef name, bool free)
 {
 	int res;
 
-	res=SpellCache.DecRef((void *) spl, name, free);
+	res=SpellCache.DecRef(spl, name, free);
 	if (res<0) {
 		error("Core", "Corrupted Spell cache encountered (reference count went below zero), Spell name is: %.8s or %.8s\n",
 			name, spl->Name);
@@ -369,7 +620,7 @@ void GameData::FreeSpell(Spell *spl, const ieResRef name, bool free)
 
 Effect* GameData::GetEffect(const ieResRef resname)
 {
-	Effect *effect = (Effect *) EffectCache.GetResource(resname);
+	Effect *effect = EffectCache.GetResource(resname);
 	if (effect) {
 		return effect;
 	}
@@ -388,7 +639,7 @@ Effect* GameData::GetEffect(const ieResRef resname)
 		return NULL;
 	}
 
-	EffectCache.SetAt(resname, (void *) effect);
+	EffectCache.SetAt(resname, effect);
 	return effect;
 }
 
@@ -396,7 +647,7 @@ void GameData::FreeEffect(Effect *eff, const ieResRef name, bool free)
 {
 	int res;
 
-	res=EffectCache.DecRef((void *) eff, name, free);
+	res=EffectCache.DecRef(eff, name, free);
 	if (res<0) {
 		error("Core", "Corrupted Effect cache encountered (reference count went below zero), Effect name is: %.8s\n", name);
 	}
@@ -404,6 +655,53 @@ void GameData::FreeEffect(Effect *eff, const ieResRef name, bool free)
 	if (free) delete eff;
 }
 
+// the parsed dialog with its compiled conditions is kept around,
+// so talking to someone again doesn't go through the importer
+Dialog* GameData::GetDialog(const ieResRef resname, bool silent)
+{
+	Dialog *dlg = DialogCache.GetResource(resname);
+	if (dlg) {
+		return dlg;
+	}
+	DataStream* str = GetResource(resname, IE_DLG_CLASS_ID, silent);
+	if (!str) {
+		return NULL;
+	}
+	PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
+	if (!dm) {
+		delete str;
+		return NULL;
+	}
+	if (!dm->Open(str)) {
+		return NULL;
+	}
+	dlg = dm->GetDialog();
+	if (!dlg) {
+		return NULL;
+	}
+	strnlwrcpy(dlg->ResRef, resname, 8);
+
+	DialogCache.SetAt(resname, dlg, DialogSize(dlg));
+	return dlg;
+}
+
+void GameData::FreeDialog(Dialog *dlg, const ieResRef name, bool free)
+{
+	int res;
+
+	res = DialogCache.DecRef(dlg, name, free);
+	if (res<0) {
+		error("Core", "Corrupted Dialog cache encountered (reference count went below zero), Dialog name is: %.8s\n", name);
+	}
+	if (res) return;
+	if (free) {
+		delete dlg;
+	} else {
+		// conversations come and go within an area, so don't wait for it to change
+		RequestCacheTrim();
+	}
+}
+
 //if the default setup doesn't fit for an animation
 //create a vvc for it!
 ScriptedAnimation* GameData::GetScriptedAnimation( const char *effect, bool doublehint)
@@ -480,18 +778,11 @@ void* GameData::GetFactoryResource(const char* resname, SClass_ID type,
 	switch (type) {
 	case IE_BAM_CLASS_ID:
 	{
-		DataStream* ret = GetResource( resname, type, silent );
-		if (ret) {
-			PluginHolder<AnimationMgr> ani(IE_BAM_CLASS_ID);
-			if (!ani)
-				return NULL;
-			if (!ani->Open(ret))
-				return NULL;
-			AnimationFactory* af = ani->GetAnimationFactory( resname, mode );
+		AnimationFactory* af = LoadAnimationFactory(resname, mode, silent, TakePrefetched(resname));
+		if (af) {
 			factory->AddFactoryObject( af );
-			return af;
 		}
-		return NULL;
+		return af;
 	}
 	case IE_BMP_CLASS_ID:
 	{
@@ -511,6 +802,106 @@ void* GameData::GetFactoryResource(const char* resname, SClass_ID type,
 	}
 }
 
+void GameData::PrefetchFactoryResource(const char* resname)
+{
+	if (!resname[0] || factory->IsLoaded(resname, IE_BAM_CLASS_ID) != -1) {
+		return;
+	}
+	std::string key = PrefetchKey(resname);
+	{
+		std::lock_guard<std::mutex> guard(prefetch->lock);
+		std::map<std::string, PrefetchedFactory>::iterator it = prefetch->jobs.find(key);
+		if (it != prefetch->jobs.end()) {
+			// wanted again after all
+			it->second.dropped = false;
+			return;
+		}
+		prefetch->jobs[key] = PrefetchedFactory();
+	}
+
+	FactoryPrefetch* pf = prefetch;
+	bool bamSprites = core->GetVideoDriver()->SupportsBAMSprites();
+	pf->workers.Post([pf, key, bamSprites] {
+		{
+			// the main thread may have taken it over in the meantime
+			std::lock_guard<std::mutex> guard(pf->lock);
+			std::map<std::string, PrefetchedFactory>::iterator it = pf->jobs.find(key);
+			if (it == pf->jobs.end() || it->second.started) {
+				return;
+			}
+			it->second.started = true;
+		}
+		PluginHolder<AnimationMgr> ani;
+		DataStream* data = gamedata->ReadResource(key.c_str(), IE_BAM_CLASS_ID, true);
+		if (data) {
+			ani = PluginHolder<AnimationMgr>(IE_BAM_CLASS_ID);
+			if (!ani) {
+				delete data;
+			} else if (ani->Open(data)) {
+				ani->DecodeFrames(bamSprites);
+			} else {
+				ani.release();
+			}
+		}
+		{
+			std::lock_guard<std::mutex> guard(pf->lock);
+			std::map<std::string, PrefetchedFactory>::iterator it = pf->jobs.find(key);
+			if (it->second.dropped) {
+				pf->jobs.erase(it);
+			} else {
+				// handed over while locked, the refcount isn't atomic
+				it->second.ani = ani;
+				ani.release();
+				it->second.done = true;
+			}
+		}
+		pf->finished.notify_all();
+	});
+}
+
+bool GameData::IsFactoryPending(const char* resname) const
+{
+	std::string key = PrefetchKey(resname);
+	std::lock_guard<std::mutex> guard(prefetch->lock);
+	std::map<std::string, PrefetchedFactory>::const_iterator it = prefetch->jobs.find(key);
+	return it != prefetch->jobs.end() && !it->second.done;
+}
+
+// waits for a prefetch that is already being decoded and returns it,
+// one still in the queue is dropped so the caller can load it right away
+Holder<AnimationMgr> GameData::TakePrefetched(const char* resname)
+{
+	std::string key = PrefetchKey(resname);
+	std::unique_lock<std::mutex> guard(prefetch->lock);
+	std::map<std::string, PrefetchedFactory>::iterator it = prefetch->jobs.find(key);
+	if (it == prefetch->jobs.end()) {
+		return Holder<AnimationMgr>();
+	}
+	if (it->second.started) {
+		// claimed now, so the worker must keep it
+		it->second.dropped = false;
+		prefetch->finished.wait(guard, [&] { return prefetch->jobs[key].done; });
+		it = prefetch->jobs.find(key);
+	}
+	Holder<AnimationMgr> ani = it->second.ani;
+	prefetch->jobs.erase(it);
+	return ani;
+}
+
+void GameData::DropPrefetched()
+{
+	std::lock_guard<std::mutex> guard(prefetch->lock);
+	std::map<std::string, PrefetchedFactory>::iterator it = prefetch->jobs.begin();
+	while (it != prefetch->jobs.end()) {
+		if (it->second.started && !it->second.done) {
+			it->second.dropped = true;
+			++it;
+		} else {
+			it = prefetch->jobs.erase(it);
+		}
+	}
+}
+
 Store* GameData::GetStore(const ieResRef ResRef)
 {
 	StoreMap::iterator it = stores.find(ResRef);
@@ -26,8 +26,8 @@
 #include "ie_types.h"
 #include "iless.h"
 
-#include "Cache.h"
 #include "Holder.h"
+#include "ResourceCache.h"
 #include "ResourceManager.h"
 #include "TableMgr.h"
 
@@ -39,10 +39,15 @@ namespace GemRB {
 static const ieResRef SevenEyes[7]={"spin126","spin127","spin128","spin129","spin130","spin131","spin132"};
 
 class Actor;
+class AnimationMgr;
+class Dialog;
 struct Effect;
 class Factory;
+struct FactoryPrefetch;
 class Item;
 class Palette;
+struct RGBModifier;
+struct ModifiedPalettes;
 class ScriptedAnimation;
 class Spell;
 class Sprite2D;
@@ -63,6 +68,14 @@ public:
 	~GameData();
 
 	void ClearCaches();
+	/** has TrimCaches do its work at the start of the next frame */
+	void RequestCacheTrim() { cacheTrimPending = true; }
+	/** if asked for, drops the resources nobody uses past the cache budgets,
+	 * least recently used first; what was freed without being removed goes
+	 * away here, so it only runs between frames */
+	void TrimCaches();
+	/** logs the hit rates and sizes of the resource caches */
+	void DumpCacheStats() const;
 
 	/** Returns actor */
 	Actor *GetCreature(const char *ResRef, unsigned int PartySlot=0);
@@ -84,6 +97,11 @@ public:
 
 	Palette* GetPalette(const ieResRef resname);
 	void FreePalette(Palette *&pal, const ieResRef name=NULL);
+	/** src recoloured by the colour modifiers of a CharAnimations part or by
+	 * a global one, shared by everyone asking for the same colours at the
+	 * same modifier phase, so it must not be changed; free it with FreePalette */
+	Palette* GetModifiedPalette(const Palette* src, const RGBModifier* mods, unsigned int type);
+	Palette* GetModifiedPalette(const Palette* src, const RGBModifier& globalMod);
 	
 	Item* GetItem(const ieResRef resname, bool silent=false);
 	void FreeItem(Item const *itm, const ieResRef name, bool free=false);
@@ -91,6 +109,9 @@ public:
 	void FreeSpell(Spell *spl, const ieResRef name, bool free=false);
 	Effect* GetEffect(const ieResRef resname);
 	void FreeEffect(Effect *eff, const ieResRef name, bool free=false);
+	/** dialogs are shared, so they must not be changed */
+	Dialog* GetDialog(const ieResRef resname, bool silent=false);
+	void FreeDialog(Dialog *dlg, const ieResRef name, bool free=false);
 
 	/** creates a vvc/bam animation object at point */
 	ScriptedAnimation* GetScriptedAnimation( const char *ResRef, bool doublehint);
@@ -104,6 +125,13 @@ public:
 	/** returns factory resource, currently works only with animations */
 	void* GetFactoryResource(const char* resname, SClass_ID type,
 		unsigned char mode = IE_NORMAL, bool silent=false);
+	/** reads and decodes a BAM on a worker thread, GetFactoryResource only
+	 * makes the sprites from it, or waits for it if it is asked for earlier */
+	void PrefetchFactoryResource(const char* resname);
+	/** true while a prefetched BAM is still being decoded */
+	bool IsFactoryPending(const char* resname) const;
+	/** throws away the prefetched BAMs nobody asked for yet */
+	void DropPrefetched();
 
 	Store* GetStore(const ieResRef ResRef);
 	/// Saves a store to the cache and frees it.
@@ -122,12 +150,17 @@ public:
 	inline void SetStepTime(int st) { stepTime = st; }
 private:
 	void ReadItemSounds();
+	Palette* ShareModifiedPalette(const Palette* src, const RGBModifier* mods, int count);
+	Holder<AnimationMgr> TakePrefetched(const char* resname);
 private:
-	Cache ItemCache;
-	Cache SpellCache;
-	Cache EffectCache;
-	Cache PaletteCache;
+	ResourceCache<Item> ItemCache;
+	ResourceCache<Spell> SpellCache;
+	ResourceCache<Effect> EffectCache;
+	ResourceCache<Palette> PaletteCache;
+	ResourceCache<Dialog> DialogCache;
+	ModifiedPalettes* modifiedPalettes;
 	Factory* factory;
+	FactoryPrefetch* prefetch;
 	std::vector<Table> tables;
 	typedef std::map<const char*, Store*, iless> StoreMap;
 	StoreMap stores;
@@ -136,6 +169,7 @@ private:
 	AutoTable spellAbilityDie;
 	AutoTable trapSaveBonus;
 	int stepTime = 0;
+	bool cacheTrimPending = false;
 };
 
 extern GEM_EXPORT GameData * gamedata;
@@ -4675,10 +4675,9 @@ void GameScript::TakeItemListPartyNum(Scriptable * Sender, Action* parameters)
 	}
 	if (count == 1) {
 		// grant the default table item to the Sender in regular games
-		Action *params = new Action(true);
-		sprintf(params->string0Parameter, "%s", tab->QueryField(9999,9999));
-		CreateItem(Sender, params);
-		delete params;
+		Action params(true);
+		sprintf(params.string0Parameter, "%s", tab->QueryField(9999,9999));
+		CreateItem(Sender, &params);
 	}
 }
 
@@ -68,8 +68,8 @@ short actionflags[MAX_ACTIONS];
 short triggerflags[MAX_TRIGGERS];
 ObjectFunction objects[MAX_OBJECTS];
 IDSFunction idtargets[MAX_OBJECT_FIELDS];
-Cache SrcCache; //cache for string resources (pst)
-Cache BcsCache; //cache for scripts
+ResourceCache<SrcVector> SrcCache; //cache for string resources (pst)
+ResourceCache<Script> BcsCache; //cache for scripts
 int ObjectIDSCount = 7;
 int MaxObjectNesting = 5;
 bool HasAdditionalRect = false;
@@ -1860,7 +1860,7 @@ int MoveNearerTo(Scriptable *Sender, const Point &p, int distance, int dont_rele
 
 void FreeSrc(SrcVector *poi, const ieResRef key)
 {
-	int res = SrcCache.DecRef((void *) poi, key, true);
+	int res = SrcCache.DecRef(poi, key, true);
 	if (res<0) {
 		error("GameScript", "Corrupted Src cache encountered (reference count went below zero), Src name is: %.8s\n", key);
 	}
@@ -1871,7 +1871,7 @@ void FreeSrc(SrcVector *poi, const ieResRef key)
 
 SrcVector *LoadSrc(const ieResRef resname)
 {
-	SrcVector *src = (SrcVector *) SrcCache.GetResource(resname);
+	SrcVector *src = SrcCache.GetResource(resname);
 	if (src) {
 		return src;
 	}
@@ -1882,7 +1882,7 @@ SrcVector *LoadSrc(const ieResRef resname)
 	ieDword size=0;
 	str->ReadDword(&size);
 	src = new SrcVector(size);
-	SrcCache.SetAt( resname, (void *) src );
+	SrcCache.SetAt( resname, src, sizeof(SrcVector) + size * sizeof(ieDword) );
 	while (size--) {
 		ieDword tmp;
 		str->ReadDword(&tmp);
@@ -2390,7 +2390,7 @@ Actor *GetNearestEnemyOf(Map *map, Actor *origin, int whoseeswho)
 		return NULL;
 	}
 
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Create();
 
 	int i = map->GetActorCount(true);
 	Actor *ac;
@@ -2422,13 +2422,13 @@ Actor *GetNearestEnemyOf(Map *map, Actor *origin, int whoseeswho)
 		}
 	}
 	ac = (Actor *) tgts->GetTarget(0, ST_ACTOR);
-	delete tgts;
+	tgts->Release();
 	return ac;
 }
 
 Actor *GetNearestOf(Map *map, Actor *origin, int whoseeswho)
 {
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Create();
 
 	int i = map->GetActorCount(true);
 	Actor *ac;
@@ -2451,7 +2451,7 @@ Actor *GetNearestOf(Map *map, Actor *origin, int whoseeswho)
 		tgts->AddTarget(ac, distance, GA_NO_DEAD|GA_NO_UNSCHEDULED);
 	}
 	ac = (Actor *) tgts->GetTarget(0, ST_ACTOR);
-	delete tgts;
+	tgts->Release();
 	return ac;
 }
 
@@ -27,6 +27,7 @@
 #include "strrefs.h"
 
 #include "Interface.h"
+#include "ResourceCache.h"
 
 namespace GemRB {
 
@@ -52,8 +53,8 @@ extern short actionflags[MAX_ACTIONS];
 extern short triggerflags[MAX_TRIGGERS];
 extern ObjectFunction objects[MAX_OBJECTS];
 extern IDSFunction idtargets[MAX_OBJECT_FIELDS];
-extern Cache SrcCache; //cache for string resources (pst)
-extern Cache BcsCache; //cache for scripts
+extern ResourceCache<SrcVector> SrcCache; //cache for string resources (pst)
+extern ResourceCache<Script> BcsCache; //cache for scripts
 extern int ObjectIDSCount;
 extern int MaxObjectNesting;
 extern bool HasAdditionalRect;
@@ -1262,6 +1262,60 @@ void ScriptDebugLog(int bit, const char *message, ...)
 
 /********************** Targets **********************************/
 
+//recycled target lists kept between evaluations
+#define MAX_FREE_TARGETS 64
+
+bool Targets::Pooling = true;
+ScriptTempStats Targets::Tick;
+ScriptTempStats Targets::LastTick;
+ScriptTempStats Targets::Total;
+static std::vector<Targets*> freeTargets;
+
+Targets *Targets::Create()
+{
+	if (Pooling && !freeTargets.empty()) {
+		Targets *tgts = freeTargets.back();
+		freeTargets.pop_back();
+		Tick.reused++;
+		return tgts;
+	}
+	Tick.allocated++;
+	return new Targets();
+}
+
+void Targets::Release()
+{
+	if (!Pooling || freeTargets.size() >= MAX_FREE_TARGETS) {
+		delete this;
+		return;
+	}
+	Clear();
+	freeTargets.push_back(this);
+}
+
+void Targets::NewTick()
+{
+	LastTick = Tick;
+	Total.allocated += Tick.allocated;
+	Total.reused += Tick.reused;
+	Total.nodes += Tick.nodes;
+	Total.reusedNodes += Tick.reusedNodes;
+	memset(&Tick, 0, sizeof(Tick));
+}
+
+//removes the target at m and steps m to the next one
+void Targets::Discard(targetlist::iterator &m)
+{
+	if (!Pooling) {
+		m = objects.erase(m);
+		return;
+	}
+	targetlist::iterator next = m;
+	++next;
+	spare.splice(spare.end(), objects, m);
+	m = next;
+}
+
 int Targets::Count() const
 {
 	return (int)objects.size();
@@ -1269,7 +1323,7 @@ int Targets::Count() const
 
 targettype *Targets::RemoveTargetAt(targetlist::iterator &m)
 {
-	m=objects.erase(m);
+	Discard(m);
 	if (m!=objects.end() ) {
 		return &(*m);
 	}
@@ -1355,16 +1409,26 @@ void Targets::AddTarget(Scriptable* target, unsigned int distance, int ga_flags)
 	targetlist::iterator m;
 	for (m = objects.begin(); m != objects.end(); ++m) {
 		if ( (*m).distance>distance) {
-			objects.insert( m, Target);
-			return;
+			break;
 		}
 	}
-	objects.push_back( Target );
+	if (spare.empty()) {
+		objects.insert( m, Target);
+		Tick.nodes++;
+	} else {
+		spare.front() = Target;
+		objects.splice(m, spare, spare.begin());
+		Tick.reusedNodes++;
+	}
 }
 
 void Targets::Clear()
 {
-	objects.clear();
+	if (Pooling) {
+		spare.splice(spare.end(), objects);
+	} else {
+		objects.clear();
+	}
 }
 
 void Targets::dump() const
@@ -1383,10 +1447,10 @@ void Targets::FilterObjectRect(const Object *oC)
 	// can't match anything if the second pair of coordinates (or all of them) are unset
 	if (oC->objectRect.w <= 0 || oC->objectRect.h <= 0) return;
 
-	targetlist::const_iterator m;
+	targetlist::iterator m;
 	for (m = objects.begin(); m != objects.end();) {
 		if (!IsInObjectRect((*m).actor->Pos, oC->objectRect)) {
-			m = objects.erase(m);
+			Discard(m);
 		} else {
 			++m;
 		}
@@ -1404,6 +1468,10 @@ static void CleanupIEScript()
 	if (ObjectIDSTableNames)
 		free(ObjectIDSTableNames);
 	ObjectIDSTableNames = NULL;
+	for (size_t i = 0; i < freeTargets.size(); i++) {
+		delete freeTargets[i];
+	}
+	freeTargets.clear();
 }
 
 static void printFunction(StringBuffer& buffer, Holder<SymbolMgr> table, int index)
@@ -1872,7 +1940,7 @@ Script* GameScript::CacheScript(ieResRef ResRef, bool AIScript)
 
 	SClass_ID type = AIScript ? IE_BS_CLASS_ID : IE_BCS_CLASS_ID;
 
-	Script *newScript = (Script *) BcsCache.GetResource(ResRef);
+	Script *newScript = BcsCache.GetResource(ResRef);
 	if ( newScript ) {
 		ScriptDebugLog(ID_REFERENCE, "Caching %s for the %d-th time\n", ResRef, BcsCache.RefCount(ResRef));
 		return newScript;
@@ -1889,7 +1957,7 @@ Script* GameScript::CacheScript(ieResRef ResRef, bool AIScript)
 		return NULL;
 	}
 	newScript = new Script( );
-	BcsCache.SetAt( ResRef, (void *) newScript );
+	BcsCache.SetAt( ResRef, newScript );
 	ScriptDebugLog(ID_REFERENCE, "Caching %s for the %d-th time", ResRef, BcsCache.RefCount(ResRef));
 
 	while (true) {
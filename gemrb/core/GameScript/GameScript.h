@@ -149,6 +149,14 @@ struct targettype {
 
 typedef std::list<targettype> targetlist;
 
+//counters of the script target lists, for one Game::UpdateScripts pass
+struct ScriptTempStats {
+	unsigned int allocated;   //lists created on the heap
+	unsigned int reused;      //lists taken from the free list
+	unsigned int nodes;       //targets allocated
+	unsigned int reusedNodes; //targets stored in recycled nodes
+};
+
 class GEM_EXPORT Targets {
 public:
 	Targets()
@@ -161,7 +169,21 @@ public:
 	}
 private:
 	targetlist objects;
+	//the nodes of removed targets, kept for the next ones
+	targetlist spare;
+	void Discard(targetlist::iterator &m);
 public:
+	//target lists only live during one evaluation, so they are recycled
+	//instead of freed: get them with Create and give them back with Release
+	static Targets *Create();
+	void Release();
+	//called at the start of every Game::UpdateScripts pass, moves the
+	//counters of the previous one to LastTick and adds them to Total
+	static void NewTick();
+	//turns off the recycling, for benchmarking
+	static bool Pooling;
+	static ScriptTempStats Tick, LastTick, Total;
+
 	int Count() const;
 	void dump() const;
 	targettype *RemoveTargetAt(targetlist::iterator &m);
@@ -36,7 +36,7 @@ namespace GemRB {
 static inline Targets* ReturnScriptableAsTarget(Scriptable *sc)
 {
 	if (!sc) return NULL;
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Create();
 	tgts->AddTarget(sc, 0, 0);
 	return tgts;
 }
@@ -87,7 +87,7 @@ static inline Targets *DoObjectFiltering(Scriptable *Sender, Targets *tgts, Obje
 
 		tgts = func(Sender, tgts, ga_flags);
 		if (!tgts->Count()) {
-			delete tgts;
+			tgts->Release();
 			return NULL;
 		}
 	}
@@ -223,7 +223,7 @@ static Targets* EvaluateObject(Map *map, Scriptable* Sender, Object* oC, int ga_
 			}
 			int dist;
 			if (DoObjectChecks(map, Sender, ac, dist, (ga_flags & GA_DETECT) != 0)) {
-				if (!tgts) tgts = new Targets();
+				if (!tgts) tgts = Targets::Create();
 				tgts->AddTarget((Scriptable *) ac, dist, ga_flags);
 			}
 		}
@@ -248,7 +248,7 @@ Targets* GetAllObjects(Map *map, Scriptable* Sender, Object* oC, int ga_flags)
 	//it is possible to start from blank sheets using endpoint filters
 	//like (Myself, Protagonist etc)
 	if (!tgts) {
-		tgts = new Targets();
+		tgts = Targets::Create();
 	}
 	tgts = DoObjectFiltering(Sender, tgts, oC, ga_flags);
 	if (tgts) {
@@ -262,7 +262,7 @@ Targets *GetAllActors(Scriptable *Sender, int ga_flags)
 	Map *map = Sender->GetCurrentArea();
 
 	int i = map->GetActorCount(true);
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Create();
 	//make sure that Sender is always first in the list, even if there
 	//are other (e.g. dead) targets at the same location
 	tgts->AddTarget(Sender, 0, ga_flags);
@@ -338,7 +338,7 @@ Scriptable* GetActorFromObject(Scriptable* Sender, Object* oC, int ga_flags)
 	if (tgts) {
 		//now this could return other than actor objects
 		aC = tgts->GetTarget(0,-1);
-		delete tgts;
+		tgts->Release();
 		if (aC || !oC || oC->objectFields[0]!=-1) {
 			return aC;
 		}
@@ -415,7 +415,7 @@ bool MatchActor(Scriptable *Sender, ieDword actorID, Object* oC)
 	if (oC->objectFilters[0]) {
 		// object filters insist on having a stupid targets list,
 		// so we waste a lot of time here
-		Targets *tgts = new Targets();
+		Targets *tgts = Targets::Create();
 		int ga_flags = 0; // TODO: correct?
 
 		// handle already-filtered vs not-yet-filtered cases
@@ -439,7 +439,7 @@ bool MatchActor(Scriptable *Sender, ieDword actorID, Object* oC)
 			}
 			tt = tgts->GetNextTarget(m, ST_ACTOR);
 		}
-		delete tgts;
+		tgts->Release();
 		if (!ret) return false;
 	}
 	return true;
@@ -457,7 +457,7 @@ int GetObjectCount(Scriptable* Sender, Object* oC)
 	int count = 0; // silly fallback to avoid potential crashes
 	if (tgts) {
 		count = tgts->Count();
-		delete tgts;
+		tgts->Release();
 	}
 	return count;
 }
@@ -486,8 +486,8 @@ int GetObjectLevelCount(Scriptable* Sender, Object* oC)
 			count += ((Actor *) tt->actor)->GetXPLevel(true);
 			tt = tgts->GetNextTarget(m, ST_ACTOR);
 		}
+		tgts->Release();
 	}
-	delete tgts;
 	return count;
 }
 
@@ -1724,8 +1724,8 @@ int GameScript::IsOverMe(Scriptable* Sender, Trigger* parameters)
 			}
 			tt = tgts->GetNextTarget(m, ST_ACTOR);
 		}
+		tgts->Release();
 	}
-	delete tgts;
 	return ret;
 }
 
@@ -2242,10 +2242,9 @@ int GameScript::IsSpellTargetValid(Scriptable* Sender, Trigger* parameters)
 //Always manages to set spell to 0, otherwise it sets if there was nothing set earlier
 int GameScript::SetMarkedSpell_Trigger(Scriptable* Sender, Trigger* parameters)
 {
-	Action *params = new Action(true);
-	params->int0Parameter = parameters->int0Parameter;
-	GameScript::SetMarkedSpell(Sender, params);
-	delete params;
+	Action params(true);
+	params.int0Parameter = parameters->int0Parameter;
+	GameScript::SetMarkedSpell(Sender, &params);
 	return 1;
 }
 
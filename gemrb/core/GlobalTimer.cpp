@@ -33,6 +33,7 @@ GlobalTimer::GlobalTimer(void)
 {
 	//AI_UPDATE_TIME: how many AI updates in a second
 	interval = ( 1000 / AI_UPDATE_TIME );
+	fixedStep = false;
 	Init();
 }
 
@@ -58,6 +59,15 @@ void GlobalTimer::Init()
 	ClearAnimations();
 }
 
+// with a fixed step every update is exactly one tick, independent of the wall clock
+unsigned long GlobalTimer::NextTime() const
+{
+	if (fixedStep && startTime) {
+		return startTime + interval;
+	}
+	return GetTickCount();
+}
+
 void GlobalTimer::Freeze()
 {
 	unsigned long thisTime;
@@ -65,7 +75,7 @@ void GlobalTimer::Freeze()
 
 	UpdateAnimations(true);
 
-	thisTime = GetTickCount();
+	thisTime = NextTime();
 	advance = thisTime - startTime;
 	if ( advance < interval) {
 		return;
@@ -165,7 +175,7 @@ bool GlobalTimer::Update()
 
 	UpdateAnimations(false);
 
-	thisTime = GetTickCount();
+	thisTime = NextTime();
 
 	if (!startTime) {
 		startTime = thisTime;
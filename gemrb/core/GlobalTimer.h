@@ -42,6 +42,7 @@ class GEM_EXPORT GlobalTimer {
 private:
 	unsigned long startTime;
 	unsigned long interval;
+	bool fixedStep; // advance exactly one tick per update, for benchmarks
 
 	int fadeToCounter, fadeToMax;
 	int fadeFromCounter, fadeFromMax;
@@ -55,6 +56,7 @@ private:
 	int speed;
 	Region currentVP;
 
+	unsigned long NextTime() const;
 	void DoFadeStep(ieDword count);
 	void UpdateAnimations(bool paused);
 public:
@@ -63,6 +65,7 @@ public:
 public:
 	void Init();
 	void Freeze();
+	void SetFixedStep(bool fixed) { fixedStep = fixed; }
 	bool Update();
 	bool ViewportIsMoving();
 	void DoStep(int count);
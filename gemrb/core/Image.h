@@ -53,6 +53,11 @@ public:
 	{
 		return width;
 	}
+	/** the raw pixels, row by row, for bulk copies */
+	Color* GetData() const
+	{
+		return data;
+	}
 	Sprite2D *GetSprite2D();
 private:
 	unsigned int height, width;
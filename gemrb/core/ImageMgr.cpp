@@ -37,6 +37,11 @@ ImageMgr::~ImageMgr(void)
 {
 }
 
+Sprite2D* ImageMgr::GetPartialSprite2D(const Region&)
+{
+	return NULL;
+}
+
 Bitmap* ImageMgr::GetBitmap()
 {
 	unsigned int height = GetHeight();
@@ -44,6 +44,11 @@ public:
 	virtual ~ImageMgr(void);
 	/** Returns a \ref Sprite2D containing the image. */
 	virtual Sprite2D* GetSprite2D() = 0;
+	/**
+	 * Returns a \ref Sprite2D of only the given part of the image, clipped
+	 * to it, or NULL if the format can't decode just a part.
+	 */
+	virtual Sprite2D* GetPartialSprite2D(const Region& rgn);
 	virtual Image* GetImage();
 	virtual Bitmap* GetBitmap();
 	/**
@@ -35,10 +35,11 @@
 #include "AmbientMgr.h"
 #include "AnimationMgr.h"
 #include "ArchiveImporter.h"
+#include "AreaDigest.h"
+#include "Benchmark.h"
 #include "Calendar.h"
 #include "DataFileMgr.h"
 #include "DialogHandler.h"
-#include "DialogMgr.h"
 #include "DisplayMessage.h"
 #include "EffectMgr.h"
 #include "EffectQueue.h"
@@ -68,6 +69,7 @@
 #include "StringMgr.h"
 #include "SymbolMgr.h"
 #include "TileMap.h"
+#include "TileOverlay.h"
 #include "VEFObject.h"
 #include "Video.h"
 #include "WindowMgr.h"
@@ -85,6 +87,7 @@
 #include "RNG.h"
 #include "Scriptable/Container.h"
 #include "System/FileStream.h"
+#include "System/MappedFileMemoryStream.h"
 #include "System/VFS.h"
 #include "System/StringBuffer.h"
 
@@ -199,6 +202,7 @@ Interface::Interface()
 #endif
 	SkipIntroVideos = false;
 	DrawFPS = false;
+	DrawDirtyRegions = false;
 	TouchScrollAreas = false;
 	UseSoftKeyboard = false;
 	KeepCache = false;
@@ -990,8 +994,13 @@ char *Interface::GetMusicPlaylist(int SongType) const {
 }
 
 /** this is the main loop */
-void Interface::Main()
+int Interface::Main()
 {
+	// headless runs skip the gui loop entirely
+	if (!BenchmarkNames.empty()) {
+		return RunBenchmarks(BenchmarkNames.c_str()) ? GEM_OK : GEM_ERROR;
+	}
+
 	ieDword speed = 10;
 
 	vars->Lookup("Mouse Scroll Speed", speed);
@@ -1011,19 +1020,7 @@ void Interface::Main()
 	double frames = 0.0;
 	Palette* palette = new Palette( ColorWhite, ColorBlack );
 	do {
-		//don't change script when quitting is pending
-
-		while (QuitFlag && QuitFlag != QF_KILL) {
-			HandleFlags();
-		}
-		//eventflags are processed only when there is a game
-		if (EventFlag && game) {
-			HandleEvents();
-		}
-		HandleGUIBehaviour();
-
-		GameLoop();
-		DrawWindows(true);
+		RunFrame();
 		if (DrawFPS) {
 			frame++;
 			time = GetTickCount();
@@ -1034,13 +1031,53 @@ void Interface::Main()
 				swprintf(fpsstring, sizeof(fpsstring)/sizeof(fpsstring[0]), L"%.3f fps", frames);
 			}
 			video->DrawRect( fpsRgn, ColorBlack );
+			video->InvalidateRegion(fpsRgn);
 			fps->Print( fpsRgn, String(fpsstring), palette,
 					   IE_FONT_ALIGN_LEFT | IE_FONT_ALIGN_MIDDLE | IE_FONT_SINGLE_LINE );
 		}
 		if (TickHook)
 			TickHook();
+		guiscript->EndFrame();
 	} while (video->SwapBuffers() == GEM_OK && !(QuitFlag&QF_KILL));
 	gamedata->FreePalette( palette );
+	return GEM_OK;
+}
+
+/** runs the logic of a single frame and draws it */
+void Interface::RunFrame()
+{
+	//don't change script when quitting is pending
+	while (QuitFlag && QuitFlag != QF_KILL) {
+		HandleFlags();
+	}
+	// nothing holds on to freed resources between frames
+	gamedata->TrimCaches();
+	//eventflags are processed only when there is a game
+	if (EventFlag && game) {
+		HandleEvents();
+	}
+	HandleGUIBehaviour();
+
+	GameLoop();
+
+	SectionTimer drawing(BENCH_DRAWING);
+	DrawWindows(true);
+}
+
+/** runs count frames with every game tick taking exactly one frame, independent of the wall clock */
+void Interface::RunFixedFrames(unsigned int count)
+{
+	timer->SetFixedStep(true);
+	for (unsigned int i = 0; i < count; i++) {
+		RunFrame();
+		if (TickHook)
+			TickHook();
+		guiscript->EndFrame();
+		if (video->SwapBuffers() != GEM_OK || (QuitFlag&QF_KILL)) {
+			break;
+		}
+	}
+	timer->SetFixedStep(false);
 }
 
 int Interface::ReadResRefTable(const ieResRef tablename, ieResRef *&data)
@@ -1275,6 +1312,17 @@ int Interface::LoadFonts()
 	return GEM_OK;
 }
 
+// the tlk is read constantly, so map it when possible and fall back to a plain file
+static DataStream* OpenTLKStream(const char* path)
+{
+	MappedFileMemoryStream* mfs = new MappedFileMemoryStream(path);
+	if (mfs->isOk()) {
+		return mfs;
+	}
+	delete mfs;
+	return FileStream::OpenFile(path);
+}
+
 int Interface::Init(InterfaceConfig* config)
 {
 	if (!config) {
@@ -1310,10 +1358,12 @@ int Interface::Init(InterfaceConfig* config)
 			var ( atoi( value ) ); \
 		value = NULL;
 
+	CONFIG_INT("AreaDigests", AreaDigest::Enabled = );
 	CONFIG_INT("Bpp", Bpp =);
 	vars->SetAt("BitsPerPixel", Bpp); //put into vars so that reading from game.ini wont overwrite
 	CONFIG_INT("CaseSensitive", CaseSensitive =);
 	CONFIG_INT("DoubleClickDelay", evntmgr->SetDCDelay);
+	CONFIG_INT("DrawDirtyRegions", DrawDirtyRegions = );
 	CONFIG_INT("DrawFPS", DrawFPS = );
 	CONFIG_INT("EnableCheatKeys", EnableCheatKeys);
 	CONFIG_INT("EndianSwitch", DataStream::SetEndianSwitch);
@@ -1333,6 +1383,7 @@ int Interface::Init(InterfaceConfig* config)
 	CONFIG_INT("SaveAsOriginal", SaveAsOriginal = );
 	CONFIG_INT("ScriptDebugMode", SetScriptDebugMode);
 	CONFIG_INT("SkipIntroVideos", SkipIntroVideos = );
+	CONFIG_INT("TileCacheSize", TileOverlay::SetCacheSize);
 	CONFIG_INT("TooltipDelay", TooltipDelay = );
 	CONFIG_INT("Width", Width = );
 	CONFIG_INT("IgnoreOriginalINI", IgnoreOriginalINI = );
@@ -1414,6 +1465,7 @@ int Interface::Init(InterfaceConfig* config)
 		value = NULL;
 
 	CONFIG_STRING("AudioDriver", AudioDriverName);
+	CONFIG_STRING("Benchmark", BenchmarkNames);
 	CONFIG_STRING("VideoDriver", VideoDriverName);
 	CONFIG_STRING("Encoding", Encoding);
 #undef CONFIG_STRING
@@ -1709,7 +1761,7 @@ int Interface::Init(InterfaceConfig* config)
 	Log(MESSAGE, "Core", "Loading Dialog.tlk file...");
 	char strpath[_MAX_PATH];
 	PathJoin(strpath, GamePath, "dialog.tlk", NULL);
-	FileStream* fs = FileStream::OpenFile(strpath);
+	DataStream* fs = OpenTLKStream(strpath);
 	if (!fs) {
 		Log(FATAL, "Core", "Cannot find Dialog.tlk.");
 		return GEM_ERROR;
@@ -1722,7 +1774,7 @@ int Interface::Init(InterfaceConfig* config)
 		Log(MESSAGE, "Core", "Loading DialogF.tlk file...");
 		char strpath[_MAX_PATH];
 		PathJoin(strpath, GamePath, "dialogf.tlk", NULL);
-		FileStream* fs = FileStream::OpenFile(strpath);
+		DataStream* fs = OpenTLKStream(strpath);
 		if (!fs) {
 			Log(ERROR, "Core", "Cannot find DialogF.tlk. Let us know which translation you are using.");
 			Log(ERROR, "Core", "Falling back to main TLK file, so female text may be wrong!");
@@ -3136,6 +3188,7 @@ void Interface::DrawWindows(bool allow_delete)
 				shieldColor.a = 0xff;
 			}
 			video->DrawRect( Region( 0, 0, Width, Height ), shieldColor );
+			video->InvalidateAll();
 			video->TakeBackgroundBuffer();
 			RedrawAll(); // wont actually have any effect until the modal window is dismissed.
 			modalShield = true;
@@ -3253,7 +3306,11 @@ void Interface::DrawTooltip ()
 		video->BlitSprite( TooltipBack[0], x + TooltipMargin - (TooltipBack[0]->Width - w) / 2, y, true, &clip );
 		video->BlitSprite( TooltipBack[1], x, y, true );
 		video->BlitSprite( TooltipBack[2], x + w, y, true );
+		// the scroll ends hang outside of clip
+		video->InvalidateRegion(Region(x - TooltipBack[1]->XPos, y - TooltipBack[1]->YPos, TooltipBack[1]->Width, TooltipBack[1]->Height));
+		video->InvalidateRegion(Region(x + w - TooltipBack[2]->XPos, y - TooltipBack[2]->YPos, TooltipBack[2]->Width, TooltipBack[2]->Height));
 	}
+	video->InvalidateRegion(clip);
 
 	if (TooltipBack) {
 		clip.x += TooltipBack[1]->Width;
@@ -3979,6 +4036,7 @@ void Interface::LoadGame(SaveGame *sg, int ver_override)
 
 	game = new_game;
 	worldmap = new_worldmap;
+	gamedata->RequestCacheTrim();
 
 	strings->OpenAux();
 	LoadProgress(70);
@@ -4503,6 +4561,12 @@ int Interface::SavedExtension(const char *filename)
 	return 0;
 }
 
+static bool IsDigest(const char *filename)
+{
+	const char *str = strrchr(filename, '.');
+	return str && !stricmp(str, ".dig");
+}
+
 static const char *protected_extensions[]={".exe",".dll",".so",0};
 
 //returns true if file should be saved
@@ -4582,6 +4646,9 @@ void Interface::DelTree(const char* Pt, bool onlysave)
 		// FIXME: we need a more universal isHidden type method on DirectoryIterator
 		if (name[0] == '.')
 			continue;
+		// area digests check themselves against the game data, so they outlive the session
+		if (!onlysave && IsDigest(name))
+			continue;
 		if (!onlysave || SavedExtension(name) ) {
 			char dtmp[_MAX_PATH];
 			dir.GetFullPath(dtmp);
@@ -4978,10 +5045,7 @@ int Interface::GetMouseScrollSpeed() {
 
 ieStrRef Interface::GetRumour(const ieResRef dlgref)
 {
-	PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
-	dm->Open(gamedata->GetResource(dlgref, IE_DLG_CLASS_ID));
-	Dialog *dlg = dm->GetDialog();
-
+	Dialog *dlg = gamedata->GetDialog(dlgref);
 	if (!dlg) {
 		Log(ERROR, "Interface", "Cannot load dialog: %s", dlgref);
 		return (ieStrRef) -1;
@@ -4993,7 +5057,7 @@ ieStrRef Interface::GetRumour(const ieResRef dlgref)
 	if (i>=0 ) {
 		ret = dlg->GetState( i )->StrRef;
 	}
-	delete dlg;
+	gamedata->FreeDialog(dlg, dlgref);
 	return ret;
 }
 
@@ -30,7 +30,6 @@
 #include "exports.h"
 
 #include "Audio.h" // needed for _MSC_VER and SoundHandle (everywhere)
-#include "Cache.h"
 #include "Callback.h"
 #include "Holder.h"
 #include "InterfaceConfig.h"
@@ -336,6 +335,7 @@ private:
 	Holder<Audio> AudioDriver;
 	std::string VideoDriverName;
 	std::string AudioDriverName;
+	std::string BenchmarkNames;
 	ProjectileServer * projserv;
 
 	EventMgr * evntmgr;
@@ -792,6 +792,8 @@ private:
 	GameControl* StartGameControl();
 	/** Executes everything (non graphical) in the main game loop */
 	void GameLoop(void);
+	/** Runs the logic of a single frame and draws it */
+	void RunFrame();
 	/** the internal (without cache) part of GetListFrom2DA */
 	ieDword *GetListFrom2DAInternal(const ieResRef resref);
 public:
@@ -822,7 +824,7 @@ public:
 	unsigned int TooltipDelay;
 	int IgnoreOriginalINI;
 	unsigned int FogOfWar;
-	bool CaseSensitive, SkipIntroVideos, DrawFPS;
+	bool CaseSensitive, SkipIntroVideos, DrawFPS, DrawDirtyRegions;
 	bool TouchScrollAreas, UseSoftKeyboard;
 	unsigned short NumFingScroll, NumFingKboard, NumFingInfo;
 	int MouseFeedback;
@@ -834,8 +836,10 @@ public:
 	int FeedbackLevel;
 
 	Variables *plugin_flags;
-	/** The Main program loop */
-	void Main(void);
+	/** The Main program loop, returns GEM_ERROR if a benchmark run failed */
+	int Main(void);
+	/** Runs count frames, each advancing the game by exactly one tick */
+	void RunFixedFrames(unsigned int count);
 	/** returns true if the game is paused */
 	bool IsFreezed();
 	/** Draws the Visible windows in the Windows Array */
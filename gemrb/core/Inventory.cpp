@@ -1748,6 +1748,7 @@ void Inventory::UpdateWeaponAnimation()
 	if (itm)
 		gamedata->FreeItem( itm, Slot->ItemResRef, false );
 	Owner->SetUsedWeapon(AnimationType, MeleeAnimation, WeaponType);
+	Owner->PrefetchAnimations();
 }
 
 //this function will also check disabled slots (if that feature will be imped)
@@ -27,7 +27,9 @@
 #include "Ambient.h"
 #include "AmbientMgr.h"
 #include "Audio.h"
+#include "Benchmark.h"
 #include "DisplayMessage.h"
+#include "FlowField.h"
 #include "Game.h"
 #include "GameData.h"
 #include "IniSpawn.h"
@@ -39,6 +41,7 @@
 #include "Particles.h"
 #include "PluginMgr.h"
 #include "Projectile.h"
+#include "ProjectileServer.h"
 #include "SaveGameIterator.h"
 #include "ScriptedAnimation.h"
 #include "TileMap.h"
@@ -56,15 +59,20 @@
 #include "Scriptable/InfoPoint.h"
 #include "System/StringBuffer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <functional>
 #include <limits>
+#include <new>
 
 namespace GemRB {
 
 #define YESNO(x) ( (x)?"Yes":"No")
 
 #define ANI_PRI_BACKGROUND	-9999
+//expired projectiles kept for reuse per area
+#define MAX_PROJECTILE_POOL 128
 
 // TODO: fix this hardcoded resource reference
 static ieResRef PortalResRef={"EF03TPR3"};
@@ -331,23 +339,20 @@ Map::Map(void)
 	TMap = NULL;
 	LightMap = NULL;
 	HeightMap = NULL;
+	SmallMapRef[0] = 0;
 	SmallMap = NULL;
 	SrchMap = NULL;
+	flowFields = new FlowFieldCache();
 	Walls = NULL;
 	WallCount = 0;
-	queue[PR_SCRIPT] = NULL;
-	queue[PR_DISPLAY] = NULL;
 	INISpawn = NULL;
-	//no one needs this queue
-	//queue[PR_IGNORE] = NULL;
 	Qcount[PR_SCRIPT] = 0;
 	Qcount[PR_DISPLAY] = 0;
 	//no one needs this queue
 	//Qcount[PR_IGNORE] = 0;
-	lastActorCount[PR_SCRIPT] = 0;
-	lastActorCount[PR_DISPLAY] = 0;
-	//no one needs this
-	//lastActorCount[PR_IGNORE] = 0;
+	queuesStale = true;
+	exploredRevision = 0;
+	exploredAllRevision = 0;
 	if (!PathFinderInited) {
 		InitPathFinder();
 		InitSpawnGroups();
@@ -375,6 +380,7 @@ Map::~Map(void)
 {
 	free( SrchMap );
 	free( MaterialMap );
+	delete flowFields;
 
 	//close the current container if it was owned by this map, this avoids a crash
 	Container *c = core->GetCurrentContainer();
@@ -404,14 +410,12 @@ Map::~Map(void)
 	delete LightMap;
 	delete HeightMap;
 	Sprite2D::FreeSprite( SmallMap );
-	for (int i = 0; i < QUEUE_COUNT; i++) {
-		free(queue[i]);
-		queue[i] = NULL;
-	}
-
 	for (auto projectile : projectiles) {
 		delete projectile;
 	}
+	for (auto projectile : projectilePool) {
+		delete projectile;
+	}
 
 	for (auto vvc : vvcCells) {
 		delete vvc;
@@ -441,24 +445,25 @@ Map::~Map(void)
 	WallCount=0;
 }
 
-void Map::ChangeTileMap(Image* lm, Sprite2D* sm)
+void Map::ChangeTileMap(Image* lm, const ieResRef sm)
 {
 	delete LightMap;
 	Sprite2D::FreeSprite(SmallMap);
 
 	LightMap = lm;
-	SmallMap = sm;
+	SmallMap = NULL;
+	CopyResRef(SmallMapRef, sm ? sm : "");
 
 	TMap->UpdateDoors();
 }
 
-void Map::AddTileMap(TileMap* tm, Image* lm, Bitmap* sr, Sprite2D* sm, Bitmap* hm)
+void Map::AddTileMap(TileMap* tm, Image* lm, Bitmap* sr, const ieResRef sm, Bitmap* hm)
 {
 	// CHECKME: leaks? Should the old TMap, LightMap, etc... be freed?
 	TMap = tm;
 	LightMap = lm;
 	HeightMap = hm;
-	SmallMap = sm;
+	CopyResRef(SmallMapRef, sm ? sm : "");
 	Width = (unsigned int) (TMap->XCellCount * 4);
 	Height = (unsigned int) (( TMap->YCellCount * 64 + 63) / 12);
 	//Internal Searchmap
@@ -689,8 +694,10 @@ void Map::UpdateScripts()
 		//Run all the Map Scripts (as in the original)
 		//The default area script is in the last slot anyway
 		//ExecuteScript( MAX_SCRIPTS );
+		SectionTimer scripts(BENCH_SCRIPTS);
 		Update();
 	} else {
+		SectionTimer scripts(BENCH_SCRIPTS);
 		ProcessActions();
 	}
 
@@ -749,7 +756,10 @@ void Map::UpdateScripts()
 		 * point, etc), but i did it this way for now because it seems least painful
 		 * and we should probably be staggering the script executions anyway
 		 */
-		actor->Update();
+		{
+			SectionTimer scripts(BENCH_SCRIPTS);
+			actor->Update();
+		}
 
 		actor->UpdateActorState(game->GameTime);
 
@@ -791,31 +801,34 @@ void Map::UpdateScripts()
 	}
 
 	ieDword time = game->Ticks; // make sure everything moves at the same time
-	// Make actors pathfind if there are others nearby
-	// in order to avoid bumping when possible
-	q = Qcount[PR_SCRIPT];
-	while (q--) {
-		Actor* actor = queue[PR_SCRIPT][q];
-		if (actor->GetRandomBackoff() || !actor->GetStep() || actor->speed == 0) {
-			continue;
-		}
-		Actor* nearActor = GetActorInRadius(actor->Pos, GA_NO_DEAD|GA_NO_UNSCHEDULED, actor->GetAnims()->GetCircleSize());
-		if (nearActor && nearActor != actor) {
-			actor->NewPath();
+	{
+		SectionTimer movement(BENCH_MOVEMENT);
+		// Make actors pathfind if there are others nearby
+		// in order to avoid bumping when possible
+		q = Qcount[PR_SCRIPT];
+		while (q--) {
+			Actor* actor = queue[PR_SCRIPT][q];
+			if (actor->GetRandomBackoff() || !actor->GetStep() || actor->speed == 0) {
+				continue;
+			}
+			Actor* nearActor = GetActorInRadius(actor->Pos, GA_NO_DEAD|GA_NO_UNSCHEDULED, actor->GetAnims()->GetCircleSize());
+			if (nearActor && nearActor != actor) {
+				actor->NewPath();
+			}
 		}
-	}
 
-	q = Qcount[PR_SCRIPT];
-	while (q--) {
-		Actor* actor = queue[PR_SCRIPT][q];
-		if (actor->GetRandomBackoff()) {
-			actor->DecreaseBackoff();
-			if (!actor->GetRandomBackoff() && actor->speed > 0) {
-				actor->NewPath();
+		q = Qcount[PR_SCRIPT];
+		while (q--) {
+			Actor* actor = queue[PR_SCRIPT][q];
+			if (actor->GetRandomBackoff()) {
+				actor->DecreaseBackoff();
+				if (!actor->GetRandomBackoff() && actor->speed > 0) {
+					actor->NewPath();
+				}
+				continue;
 			}
-			continue;
+			DoStepForActor(actor, actor->speed, time);
 		}
-		DoStepForActor(actor, actor->speed, time);
 	}
 
 
@@ -837,6 +850,18 @@ void Map::UpdateScripts()
 		container->Update();
 	}
 
+	//Bucket the scripted actors by position, so the trap checks
+	//below only look at the actors near each region
+	//(the buckets are in queue order, like the loop they replace)
+	scriptQueueGrid.Reset(Point(Width * 16, Height * 12));
+	int maxSize = 0;
+	q = Qcount[PR_SCRIPT];
+	while (q--) {
+		Actor *actor = queue[PR_SCRIPT][q];
+		scriptQueueGrid.Insert(q, Region(actor->Pos, Size(0, 0)));
+		maxSize = std::max(maxSize, actor->size);
+	}
+
 	//Check if we need to start some trap scripts
 	int ipCount = 0;
 	while (true) {
@@ -860,10 +885,18 @@ void Map::UpdateScripts()
 			continue;
 		}
 
-		q = Qcount[PR_SCRIPT];
+		Region bounds = ip->EnterBounds(maxSize);
+		trapCandidates.clear();
+		scriptQueueGrid.ForEachBucket(bounds, [this](const std::vector<int>& bucket) {
+			trapCandidates.insert(trapCandidates.end(), bucket.begin(), bucket.end());
+		});
+		if (scriptQueueGrid.BucketCount(bounds) > 1) {
+			std::sort(trapCandidates.begin(), trapCandidates.end(), std::greater<int>());
+		}
+
 		ieDword exitID = ip->GetGlobalID();
-		while (q--) {
-			Actor *actor = queue[PR_SCRIPT][q];
+		for (int candidate : trapCandidates) {
+			Actor *actor = queue[PR_SCRIPT][candidate];
 			if (ip->Type == ST_PROXIMITY) {
 				if (ip->Entered(actor)) {
 					// if trap triggered, then mark actor
@@ -1217,7 +1250,7 @@ void Map::DrawMap(Region screen)
 					pro->Draw( screen );
 					proidx++;
 				} else {
-					delete( pro );
+					RecycleProjectile(pro);
 					proidx = projectiles.erase(proidx);
 				}
 			}
@@ -1366,6 +1399,7 @@ void Map::AddAnimation(AreaAnimation* panim)
 //this might be unnecessary later
 void Map::UpdateEffects()
 {
+	SectionTimer effects(BENCH_EFFECTS);
 	size_t i = actors.size();
 	while (i--) {
 		actors[i]->RefreshEffects(NULL);
@@ -1487,6 +1521,7 @@ void Map::InitActor(Actor *actor)
 		}
 		core->GetGame()->locals->SetAt(key, 1);
 	}
+	actor->PrefetchAnimations();
 }
 
 void Map::AddActor(Actor* actor, bool init)
@@ -1495,6 +1530,7 @@ void Map::AddActor(Actor* actor, bool init)
 	strnlwrcpy(actor->Area, scriptName, 8);
 	if (!HasActor(actor)) {
 		actors.push_back( actor );
+		queuesStale = true;
 	}
 	if (init) {
 		actor->SetMap(this);
@@ -1540,6 +1576,7 @@ void Map::DeleteActor(int i)
 	}
 	//remove the actor from the area's actor list
 	actors.erase( actors.begin()+i );
+	queuesStale = true;
 }
 
 Scriptable *Map::GetScriptableByGlobalID(ieDword objectID)
@@ -2127,17 +2164,8 @@ void Map::GenerateQueues()
 	int priority;
 
 	unsigned int i=(unsigned int) actors.size();
-	for (priority=0;priority<QUEUE_COUNT;priority++) {
-		if (lastActorCount[priority] != i) {
-			if (queue[priority]) {
-				free(queue[priority]);
-				queue[priority] = NULL;
-			}
-			queue[priority] = (Actor **) calloc( i, sizeof(Actor *) );
-			lastActorCount[priority] = i;
-		}
-		Qcount[priority] = 0;
-	}
+	lastActorQueue.swap(actorQueue);
+	actorQueue.assign(i, PR_IGNORE);
 
 	ieDword gametime = core->GetGame()->GameTime;
 	while (i--) {
@@ -2145,6 +2173,7 @@ void Map::GenerateQueues()
 
 		if (actor->CheckOnDeath()) {
 			DeleteActor( i );
+			actorQueue.erase(actorQueue.begin() + i);
 			continue;
 		}
 
@@ -2181,50 +2210,109 @@ void Map::GenerateQueues()
 			}
 		}
 
-		//we ignore priority 2
-		if (priority>=PR_IGNORE) continue;
+		actorQueue[i] = (char) priority;
+	}
+	// anyone joining from a script above wasn't classified, like before
+	actorQueue.resize(actors.size(), PR_IGNORE);
+
+	int count = (int) actors.size();
+	for (priority = 0; priority < QUEUE_COUNT; priority++) {
+		std::vector<unsigned int> &order = queueOrder[priority];
+		if (queuesStale) {
+			order.clear();
+			for (int a = count - 1; a >= 0; a--) {
+				if (actorQueue[a] == priority) order.push_back(a);
+			}
+			continue;
+		}
+		// keep the last order of those that stayed, newcomers go at the end
+		size_t kept = 0;
+		for (unsigned int a : order) {
+			if (actorQueue[a] == priority) order[kept++] = a;
+		}
+		order.resize(kept);
+		for (int a = count - 1; a >= 0; a--) {
+			if (actorQueue[a] == priority && lastActorQueue[a] != priority) {
+				order.push_back(a);
+			}
+		}
+	}
+	queuesStale = false;
+}
+
+// the heap sort the queues always went through, the order of actors on the
+// same row depends on it, so it is kept for them
+void Map::HeapSortQueue(std::vector<unsigned int>& order) const
+{
+	// the queues used to be collected from the end of the actor list
+	std::sort(order.begin(), order.end(), std::greater<unsigned int>());
+	unsigned int* baseline = order.data();
+	int n = (int) order.size();
+	int i = n/2;
+	int parent, child;
+	unsigned int tmp;
 
-		queue[priority][Qcount[priority]] = actor;
-		Qcount[priority]++;
+	for (;;) {
+		if (i>0) {
+			i--;
+			tmp = baseline[i];
+		} else {
+			n--;
+			if (n<=0) break; //breaking loop
+			tmp = baseline[n];
+			baseline[n] = baseline[0];
+		}
+		parent = i;
+		child = i*2+1;
+		while(child<n) {
+			int chp = child+1;
+			if (chp<n && actors[baseline[chp]]->Pos.y < actors[baseline[child]]->Pos.y) {
+				child=chp;
+			}
+			if (actors[baseline[child]]->Pos.y < actors[tmp]->Pos.y) {
+				baseline[parent] = baseline[child];
+				parent = child;
+				child = parent*2+1;
+			} else
+				break;
+		}
+		baseline[parent]=tmp;
 	}
 }
 
-//the original qsort implementation was flawed
+// the queues are ordered by descending y and drawn from the back
+// the queues barely change between calls, so the kept order from the last
+// time is almost sorted and insertion sort gets it done in about one pass;
+// only if actors share a row does the old heap sort have to decide their order
 void Map::SortQueues()
 {
 	for (int q=0;q<QUEUE_COUNT;q++) {
-		Actor **baseline=queue[q];
-		int n = Qcount[q];
-		int i = n/2;
-		int parent, child;
-		Actor * tmp;
-
-		for (;;) {
-			if (i>0) {
-				i--;
-				tmp = baseline[i];
-			} else {
-				n--;
-				if (n<=0) break; //breaking loop
-				tmp = baseline[n];
-				baseline[n] = baseline[0];
+		std::vector<unsigned int> &order = queueOrder[q];
+		size_t n = order.size();
+		bool tied = false;
+		for (size_t i = 1; i < n; i++) {
+			unsigned int tmp = order[i];
+			int y = actors[tmp]->Pos.y;
+			size_t j = i;
+			while (j > 0) {
+				unsigned int prev = order[j - 1];
+				int prevY = actors[prev]->Pos.y;
+				if (prevY == y) tied = true;
+				if (prevY >= y) break;
+				order[j] = prev;
+				j--;
 			}
-			parent = i;
-			child = i*2+1;
-			while(child<n) {
-				int chp = child+1;
-				if (chp<n && baseline[chp]->Pos.y < baseline[child]->Pos.y) {
-					child=chp;
-				}
-				if (baseline[child]->Pos.y<tmp->Pos.y) {
-					baseline[parent] = baseline[child];
-					parent = child;
-					child = parent*2+1;
-				} else
-					break;
-			}
-			baseline[parent]=tmp;
+			order[j] = tmp;
+		}
+		if (tied) {
+			HeapSortQueue(order);
+		}
+
+		queue[q].resize(n);
+		for (size_t i = 0; i < n; i++) {
+			queue[q][i] = actors[order[i]];
 		}
+		Qcount[q] = (int) n;
 	}
 }
 
@@ -2251,6 +2339,28 @@ void Map::AddProjectile(Projectile* pro, const Point &source, const Point &dest)
 	projectiles.insert(iter, pro);
 }
 
+Projectile *Map::GetPooledProjectile()
+{
+	if (projectilePool.empty()) {
+		return NULL;
+	}
+	Projectile *pro = projectilePool.back();
+	projectilePool.pop_back();
+	return pro;
+}
+
+void Map::RecycleProjectile(Projectile* pro)
+{
+	if (!ProjectileServer::Pooling || projectilePool.size() >= MAX_PROJECTILE_POOL) {
+		delete pro;
+		return;
+	}
+	//the destructor lets go of the payload, animations and sounds
+	pro->~Projectile();
+	new (pro) Projectile();
+	projectilePool.push_back(pro);
+}
+
 //returns the longest duration of the VVC cell named 'resource' (if it exists)
 //if P is empty, the position won't be checked
 ieDword Map::HasVVCCell(const ieResRef resource, const Point &p)
@@ -2354,6 +2464,7 @@ void Map::RemoveActor(Actor* actor)
 			actor->SetMap(NULL);
 			CopyResRef(actor->Area, "");
 			actors.erase( actors.begin()+i );
+			queuesStale = true;
 			return;
 		}
 	}
@@ -2801,6 +2912,15 @@ int Map::GetExploredMapSize() const
 void Map::Explore(int setreset)
 {
 	memset (ExploredBitmap, setreset, GetExploredMapSize() );
+	exploredAllRevision = ++exploredRevision;
+}
+
+ieDword Map::GetExploredRowRevision(int row) const
+{
+	if (row >= 0 && row < (int) exploredRows.size()) {
+		return std::max(exploredRows[row], exploredAllRevision);
+	}
+	return exploredAllRevision;
 }
 
 void Map::SetMapVisibility(int setreset)
@@ -2825,7 +2945,13 @@ void Map::ExploreTile(const Point &pos)
 	int by = b0/8;
 	int bi = 1<<(b0%8);
 
-	ExploredBitmap[by] |= bi;
+	if (!(ExploredBitmap[by] & bi)) {
+		ExploredBitmap[by] |= bi;
+		if ((int) exploredRows.size() < h) {
+			exploredRows.resize(h, 0);
+		}
+		exploredRows[y] = ++exploredRevision;
+	}
 	VisibleBitmap[by] |= bi;
 }
 
@@ -3570,6 +3696,14 @@ short unsigned int Map::GetInternalSearchMap(int x, int y) const
 	return SrchMap[x+y*Width];
 }
 
+unsigned short Map::GetMaterial(int x, int y) const
+{
+	if ((unsigned)x >= Width || (unsigned)y >= Height) {
+		return 0;
+	}
+	return MaterialMap[x+y*Width];
+}
+
 void Map::SetInternalSearchMap(int x, int y, int value)
 {
 	if ((unsigned)x >= Width || (unsigned)y >= Height) {
@@ -3578,6 +3712,46 @@ void Map::SetInternalSearchMap(int x, int y, int value)
 	SrchMap[x+y*Width] = value;
 }
 
+void Map::ClearFlowFields()
+{
+	flowFields->Clear();
+}
+
+// the small map is only needed once the map window is opened, so it isn't
+// decoded with the rest of the area
+Sprite2D* Map::GetSmallMap()
+{
+	if (!SmallMap && SmallMapRef[0]) {
+		ResourceHolder<ImageMgr> sm = GetResourceHolder<ImageMgr>(SmallMapRef, true);
+		if (sm) {
+			SmallMap = sm->GetSprite2D();
+		}
+		if (!SmallMap) {
+			// don't keep trying
+			SmallMapRef[0] = 0;
+		}
+	}
+	return SmallMap;
+}
+
+Size Map::GetSmallMapSize() const
+{
+	if (SmallMap) {
+		return Size(SmallMap->Width, SmallMap->Height);
+	}
+	ResourceHolder<ImageMgr> sm = GetResourceHolder<ImageMgr>(SmallMapRef, true);
+	if (!sm) {
+		return Size();
+	}
+	return Size(sm->GetWidth(), sm->GetHeight());
+}
+
+Sprite2D* Map::GetSmallMapPart(const Region& part) const
+{
+	ResourceHolder<ImageMgr> sm = GetResourceHolder<ImageMgr>(SmallMapRef, true);
+	return sm ? sm->GetPartialSprite2D(part) : NULL;
+}
+
 void Map::SetBackground(const ieResRef &bgResRef, ieDword duration)
 {
 	ResourceHolder<ImageMgr> bmp = GetResourceHolder<ImageMgr>(bgResRef);
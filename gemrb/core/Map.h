@@ -27,6 +27,7 @@
 #include "Interface.h"
 #include "Scriptable/Scriptable.h"
 #include "PathFinder.h"
+#include "RegionGrid.h"
 
 #include <algorithm>
 #include <queue>
@@ -41,6 +42,8 @@ class Animation;
 class AnimationFactory;
 class Bitmap;
 class CREItem;
+class FlowField;
+class FlowFieldCache;
 class GameControl;
 class Image;
 class IniSpawn;
@@ -328,7 +331,6 @@ public:
 	TileMap* TMap;
 	Image* LightMap;
 	Bitmap* HeightMap;
-	Sprite2D* SmallMap;
 	IniSpawn *INISpawn;
 	ieDword AreaFlags;
 	ieWord AreaType;
@@ -348,26 +350,43 @@ public:
 	MapReverb *reverb;
 
 private:
+	ieResRef SmallMapRef;
+	Sprite2D* SmallMap;
 	ieStrRef trackString;
 	int trackFlag;
 	ieWord trackDiff;
 	unsigned short* SrchMap; //internal searchmap
 	unsigned short* MaterialMap;
 	unsigned int Width, Height;
+	FlowFieldCache *flowFields;
 	std::list< AreaAnimation*> animations;
 	std::vector< Actor*> actors;
 	Wall_Polygon **Walls;
 	unsigned int WallCount;
 	std::list< VEFObject*> vvcCells;
 	std::list< Projectile*> projectiles;
+	//expired projectiles kept for reuse by explosions and fragments
+	std::vector<Projectile*> projectilePool;
 	std::list< Particles*> particles;
 	std::vector< Entrance*> entrances;
 	std::vector< Ambient*> ambients;
 	std::vector<MapNote> mapnotes;
 	std::vector< Spawn*> spawns;
-	Actor** queue[QUEUE_COUNT];
+	std::vector<Actor*> queue[QUEUE_COUNT];
 	int Qcount[QUEUE_COUNT];
-	unsigned int lastActorCount[QUEUE_COUNT];
+	// the queues are kept between calls as indices into actors, so resorting
+	// them only has to fix up what moved since; they get rebuilt whenever
+	// an actor is added or removed, as that shifts the indices
+	std::vector<unsigned int> queueOrder[QUEUE_COUNT];
+	std::vector<char> actorQueue, lastActorQueue;
+	bool queuesStale;
+	// bumped whenever cells get explored, also noted for their row of cells
+	ieDword exploredRevision;
+	ieDword exploredAllRevision;
+	std::vector<ieDword> exploredRows;
+	// PR_SCRIPT queue indices by actor position, for the trap checks
+	RegionGrid<int> scriptQueueGrid;
+	std::vector<int> trapCandidates;
 
 public:
 	Map(void);
@@ -382,9 +401,17 @@ public:
 	bool ChangeMap(bool day_or_night);
 	void SeeSpellCast(Scriptable *caster, ieDword spell);
 	/* low level function to perform the daylight changes */
-	void ChangeTileMap(Image* lm, Sprite2D* sm);
-	/* sets all the auxiliary maps and the tileset */
-	void AddTileMap(TileMap* tm, Image* lm, Bitmap* sr, Sprite2D* sm, Bitmap* hm);
+	void ChangeTileMap(Image* lm, const ieResRef sm);
+	/* sets all the auxiliary maps and the tileset, the small map is only named */
+	void AddTileMap(TileMap* tm, Image* lm, Bitmap* sr, const ieResRef sm, Bitmap* hm);
+	/* the small map for MapControl, decoded on first use */
+	Sprite2D* GetSmallMap();
+	bool IsSmallMapDecoded() const { return SmallMap != NULL; }
+	/* the size of the small map, without decoding it */
+	Size GetSmallMapSize() const;
+	/* decodes only part of the small map, so it can be shown before the rest,
+	 * NULL if the image format can't do that */
+	Sprite2D* GetSmallMapPart(const Region& part) const;
 	void UpdateScripts();
 	void ResolveTerrainSound(ieResRef &sound, Point &pos);
 	void DoStepForActor(Actor *actor, int walkScale, ieDword time);
@@ -476,6 +503,10 @@ public:
 	//add a projectile to the area
 	void AddProjectile(Projectile* pro, const Point &source, ieWord actorID, bool fake);
 	void AddProjectile(Projectile* pro, const Point &source, const Point &dest);
+	//a blank projectile from the pool of expired ones, NULL if there is none
+	Projectile *GetPooledProjectile();
+	//destructs an expired projectile, keeping its memory for reuse
+	void RecycleProjectile(Projectile* pro);
 
 	//returns the duration of a VVC cell set in the area (point may be set to empty)
 	ieDword HasVVCCell(const ieResRef resource, const Point &p);
@@ -513,6 +544,10 @@ public:
 	void ExploreTile(const Point &Tile);
 	/* explore map from given point in map coordinates */
 	void ExploreMapChunk(const Point &Pos, int range, int los);
+	/* changes whenever the explored bitmap does, so views of it can tell
+	 * they are out of date; per row of fog cells too */
+	ieDword GetExploredRevision() const { return exploredRevision; }
+	ieDword GetExploredRowRevision(int row) const;
 	/* block or unblock searchmap with value */
 	void BlockSearchMap(const Point &Pos, unsigned int size, unsigned int value);
 	void ClearSearchMapFor(Movable *actor);
@@ -536,6 +571,8 @@ public:
 	PathNode* GetLine(const Point &start, const Point &dest, int speed, int Orientation, int flags) const;
 	/* Finds the path which leads to near d */
 	PathNode* FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance = 0, int flags = PF_SIGHT, const Actor *caller = NULL) const;
+	/* Returns the shared flow field of actors walking to near goal, if there is one */
+	const FlowField* GetFlowField(const Point &goal, unsigned int size) const;
 
 	/* returns false if point isn't visible on visibility/explored map */
 	bool IsVisible(const Point &s, int explored);
@@ -590,7 +627,10 @@ public:
 
 	unsigned int GetLightLevel(const Point &Pos) const;
 	unsigned short GetInternalSearchMap(int x, int y) const;
+	unsigned short GetMaterial(int x, int y) const;
 	void SetInternalSearchMap(int x, int y, int value);
+	/** drops the group pathfinding fields, call after changing the searchmap */
+	void ClearFlowFields();
 	void SetBackground(const ieResRef &bgResref, ieDword duration);
 	void SetupReverbInfo();
 
@@ -604,6 +644,8 @@ private:
 	void DrawSearchMap(const Region &screen);
 	void GenerateQueues();
 	void SortQueues();
+	void HeapSortQueue(std::vector<unsigned int>& order) const;
+	PathNode* FollowFlowField(const FlowField &field, const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const;
 	//Actor* GetRoot(int priority, int &index);
 	void DeleteActor(int i);
 	//actor uses travel region
@@ -46,6 +46,9 @@ public:
 	MoviePlayer(void);
 	virtual ~MoviePlayer(void);
 	virtual int Play() = 0;
+	/** decodes every frame as fast as possible, without showing them or
+	 * playing the sound, returns how many there were or -1 if unsupported */
+	virtual int Decode() { return -1; }
 	virtual void CallBackAtFrames(ieDword cnt, ieDword *frames, ieDword *strrefs) = 0;
 };
 
@@ -34,7 +34,9 @@
 // Moving to each node in the path thus becomes an automatic regulation problem
 // which is solved with a P regulator, see Scriptable.cpp
 
+#include "Benchmark.h"
 #include "FibonacciHeap.h"
+#include "FlowField.h"
 #include "GameData.h"
 #include "Map.h"
 #include "PathFinder.h"
@@ -256,6 +258,7 @@ PathNode *Map::GetLine(const Point &p, int steps, unsigned int orient) const
 // target (the goal must be in sight of the end, if PF_SIGHT is specified)
 PathNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const
 {
+	SectionTimer pathfinding(BENCH_PATHFINDING);
 	Log(DEBUG, "FindPath", "s = (%d, %d), d = (%d, %d), caller = %s, dist = %d, size = %d", s.x, s.y, d.x, d.y, caller ? caller->GetName(0) : "nullptr", minDistance, size);
 	NavmapPoint nmptDest = d;
 	NavmapPoint nmptSource = s;
@@ -274,6 +277,17 @@ PathNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsig
 	SearchmapPoint smptDest(nmptDest.x / 16, nmptDest.y / 12);
 	if (smptDest == smptSource) return nullptr;
 
+	// Actors walking to the same place share a flow field instead of each
+	// running a search, only the last bit is left to the search below
+	if (!(flags & (PF_NO_FLOWFIELD | PF_BACKAWAY)) &&
+		(std::abs(smptDest.x - smptSource.x) > 2 * FLOWFIELD_APPROACH || std::abs(smptDest.y - smptSource.y) > 2 * FLOWFIELD_APPROACH)) {
+		const FlowField *field = flowFields->Request(this, nmptDest, size);
+		if (field) {
+			PathNode *path = FollowFlowField(*field, nmptSource, d, size, minDistance, flags, caller);
+			if (path) return path;
+		}
+	}
+
 	// Initialize data structures
 	FibonacciHeap<PQNode> open;
 	std::vector<bool> isClosed(Width * Height, false);
@@ -401,6 +415,80 @@ PathNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsig
 	return nullptr;
 }
 
+const FlowField *Map::GetFlowField(const Point &goal, unsigned int size) const
+{
+	return flowFields->Find(goal, size);
+}
+
+// Walk down the flow field from s until close to d, then search the rest.
+// Only the squares where the straight line breaks become path nodes,
+// so the result is as smooth as a Theta* path.
+PathNode *Map::FollowFlowField(const FlowField &field, const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const
+{
+	SearchmapPoint smptCurrent(s.x / 16, s.y / 12);
+	SearchmapPoint smptDest(d.x / 16, d.y / 12);
+	if (!field.Reachable(smptCurrent)) return nullptr;
+
+	bool actorsAreBlocking = flags & PF_ACTORS_ARE_BLOCKING;
+	unsigned int squaredMinDist = minDistance * minDistance;
+	std::vector<NavmapPoint> waypoints;
+	NavmapPoint nmptAnchor = s;
+	NavmapPoint nmptLast = s;
+	bool arrived = false;
+	while (std::abs(smptCurrent.x - smptDest.x) > FLOWFIELD_APPROACH || std::abs(smptCurrent.y - smptDest.y) > FLOWFIELD_APPROACH) {
+		if (!field.Descend(smptCurrent)) break;
+
+		NavmapPoint nmptNext(smptCurrent.x * 16 + 8, smptCurrent.y * 12 + 6);
+		if (!IsWalkableTo(nmptAnchor, nmptNext, actorsAreBlocking, caller)) {
+			// blocked right away, probably by an actor
+			if (nmptLast == nmptAnchor) return nullptr;
+			waypoints.push_back(nmptLast);
+			nmptAnchor = nmptLast;
+		}
+		nmptLast = nmptNext;
+		if (minDistance && SquaredDistance(nmptLast, d) < squaredMinDist) {
+			if (!(flags & PF_SIGHT) || IsVisibleLOS(nmptLast, d)) {
+				arrived = true;
+				break;
+			}
+		}
+	}
+	if (nmptLast != nmptAnchor) {
+		waypoints.push_back(nmptLast);
+	}
+	if (waypoints.empty()) return nullptr;
+
+	PathNode *tail = nullptr;
+	if (!arrived && SearchmapPoint(nmptLast.x / 16, nmptLast.y / 12) != smptDest) {
+		tail = FindPath(nmptLast, d, size, minDistance, flags | PF_NO_FLOWFIELD, caller);
+		if (!tail) return nullptr;
+	}
+
+	PathNode *resultPath = nullptr;
+	PathNode *prevStep = nullptr;
+	NavmapPoint nmptPrev = s;
+	for (const NavmapPoint &nmptStep : waypoints) {
+		PathNode *newStep = new PathNode;
+		newStep->x = nmptStep.x;
+		newStep->y = nmptStep.y;
+		newStep->orient = GetOrient(nmptStep, nmptPrev);
+		newStep->Parent = prevStep;
+		newStep->Next = nullptr;
+		if (prevStep) {
+			prevStep->Next = newStep;
+		} else {
+			resultPath = newStep;
+		}
+		prevStep = newStep;
+		nmptPrev = nmptStep;
+	}
+	if (tail) {
+		prevStep->Next = tail;
+		tail->Parent = prevStep;
+	}
+	return resultPath;
+}
+
 void Map::NormalizeDeltas(double &dx, double &dy, const double &factor)
 {
 	const double STEP_RADIUS = 2.0;
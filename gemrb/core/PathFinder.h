@@ -57,7 +57,8 @@ typedef Point SearchmapPoint;
 enum {
 	PF_SIGHT = 1,
 	PF_BACKAWAY = 2,
-	PF_ACTORS_ARE_BLOCKING = 4
+	PF_ACTORS_ARE_BLOCKING = 4,
+	PF_NO_FLOWFIELD = 8
 };
 
 
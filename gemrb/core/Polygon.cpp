@@ -86,41 +86,32 @@ bool Gem_Polygon::PointIn(const Point &p) const
 	return PointIn(p.x, p.y);
 }
 
+// the trapezoids split the polygon into horizontal strips, so only the
+// strips containing ty have to be checked and each is just two edges
 bool Gem_Polygon::PointIn(int tx, int ty) const
 {
-	int   j, yflag0, yflag1, xflag0 , index;
-	bool inside_flag = false;
-	Point* vtx0, * vtx1;
+	for (const Trapezoid& t : trapezoids) {
+		if (t.y1 > ty) {
+			break;
+		}
+		if (t.y2 <= ty) {
+			continue;
+		}
 
-	if (count<3) {
-		return false;
-	}
-	index = 0;
-
-	vtx0 = &points[count - 1];
-	yflag0 = ( vtx0->y >= ty );
-	vtx1 = &points[index];
-
-	for (j = count + 1; --j ;) {
-		yflag1 = ( vtx1->y >= ty );
-		if (yflag0 != yflag1) {
-			xflag0 = ( vtx0->x >= tx );
-			if (xflag0 == ( vtx1->x >= tx )) {
-				if (xflag0)
-					inside_flag = !inside_flag;
-			} else {
-				if (( vtx1->x -
-					( vtx1->y - ty ) * ( vtx0->x - vtx1->x ) /
-					( vtx0->y - vtx1->y ) ) >= tx) {
-					inside_flag = !inside_flag;
-				}
-			}
+		const Point& a = points[t.left_edge];
+		const Point& b = points[(t.left_edge + 1) % count];
+		int lt = (b.x * (ty - a.y) + a.x * (b.y - ty)) / (b.y - a.y);
+		if (tx < lt) {
+			continue;
+		}
+		const Point& c = points[t.right_edge];
+		const Point& d = points[(t.right_edge + 1) % count];
+		int rt = (d.x * (ty - c.y) + c.x * (d.y - ty)) / (d.y - c.y);
+		if (tx <= rt) {
+			return true;
 		}
-		yflag0 = yflag1;
-		vtx0 = vtx1;
-		vtx1 = &points[++index];
 	}
-	return inside_flag;
+	return false;
 }
 
 // returns twice the area of triangle a, b, c.
@@ -270,7 +261,7 @@ void Gem_Polygon::ComputeTrapezoids()
 	Trapezoid t;
 	ScanlineInt is;
 	is.p = this;
-	std::list<Trapezoid>::iterator iter;
+	std::vector<Trapezoid>::iterator iter;
 
 	unsigned int yi = 0;
 	int cury = ys[0];
@@ -26,6 +26,7 @@
 #include "Region.h"
 
 #include <list>
+#include <vector>
 
 namespace GemRB {
 
@@ -42,7 +43,8 @@ public:
 	Region BBox;
 	Point* points;
 	unsigned int count;
-	std::list<Trapezoid> trapezoids;
+	// sorted by y1
+	std::vector<Trapezoid> trapezoids;
 	bool PointIn(const Point &p) const;
 	bool PointIn(int x, int y) const;
 	void RecalcBBox();
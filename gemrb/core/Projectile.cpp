@@ -116,9 +116,10 @@ Projectile::~Projectile()
 
 	if (phase != P_UNINITED) {
 		for (i = 0; i < MAX_ORIENT; ++i) {
-			if(travel[i])
+			//single orientation animations fill all the slots
+			if(travel[i] && (!i || travel[i] != travel[i-1]))
 				delete travel[i];
-			if(shadow[i])
+			if(shadow[i] && (!i || shadow[i] != shadow[i-1]))
 				delete shadow[i];
 		}
 		Sprite2D::FreeSprite(light);
@@ -177,6 +178,7 @@ void Projectile::CreateCompositeAnimation(Animation **anims, AnimationFactory *a
 	for (int Cycle = 0; Cycle<Aim; Cycle++) {
 		int c = Cycle+Seq;
 		Animation* a = af->GetCycle( c );
+		server->stats.animations++;
 		anims[Cycle] = a;
 		if (!a) continue;
 		//animations are started at a random frame position
@@ -191,9 +193,25 @@ void Projectile::CreateCompositeAnimation(Animation **anims, AnimationFactory *a
 
 //Seq is the cycle to use in case of single orientations
 //Aim is the number of Orientations
-// FIXME: seems inefficient that we load up MAX_ORIENT animations even for those with a single orientation (default case)
 void Projectile::CreateOrientedAnimations(Animation **anims, AnimationFactory *af, int Seq)
 {
+	//a single orientation is the same cycle in every direction,
+	//so one animation fills all the slots
+	if (ProjectileServer::Pooling && Aim != 5 && Aim != 9 && Aim != 16) {
+		Animation* a = af->GetCycle( Seq );
+		server->stats.animations++;
+		if (a) {
+			if (!(ExtFlags&PEF_RANDOM)) {
+				a->SetPos(0);
+			}
+			a->gameAnimation = true;
+		}
+		for (int Cycle = 0; Cycle<MAX_ORIENT; Cycle++) {
+			anims[Cycle] = a;
+		}
+		return;
+	}
+
 	for (int Cycle = 0; Cycle<MAX_ORIENT; Cycle++) {
 		bool mirror = false, mirrorvert = false;
 		int c;
@@ -227,6 +245,7 @@ void Projectile::CreateOrientedAnimations(Animation **anims, AnimationFactory *a
 			break;
 		}
 		Animation* a = af->GetCycle( c );
+		server->stats.animations++;
 		anims[Cycle] = a;
 		if (!a) continue;
 		//animations are started at a random frame position
@@ -268,6 +287,7 @@ void Projectile::GetPaletteCopy(Animation *anim[], Palette *&pal)
 			Sprite2D* spr = anim[i]->GetFrame(0);
 			if (spr) {
 				pal = spr->GetPalette()->Copy();
+				server->stats.palettes++;
 				break;
 			}
 		}
@@ -290,7 +310,7 @@ void Projectile::SetBlend(int brighten)
 //create another projectile with type-1 (iterate magic missiles and call lightning)
 void Projectile::CreateIteration()
 {
-	Projectile *pro = server->GetProjectileByIndex(type-1);
+	Projectile *pro = server->GetProjectileByIndex(type-1, area);
 	pro->SetEffectsCopy(effects, Pos);
 	pro->SetCaster(Caster, Level);
 	if (ExtFlags&PEF_CURVE) {
@@ -429,17 +449,33 @@ void Projectile::Setup()
 		}
 	}
 
+	//coloured and blended palettes only depend on the bam and the flags,
+	//so they come ready made from the server, shared by all projectiles
+	int blend = 0;
+	if (TFlags&PTF_BLEND) {
+		blend = (TFlags&PTF_BRIGHTEN) ? 2 : 1;
+	}
+	bool shared = false;
 	if (TFlags&PTF_COLOUR) {
-		SetupPalette(travel, palette, Gradients);
+		if (ProjectileServer::Pooling && !palette) {
+			palette = server->GetSharedPalette(travel, BAMRes1, Gradients, blend);
+			shared = true;
+		} else {
+			SetupPalette(travel, palette, Gradients);
+		}
 	} else {
 		gamedata->FreePalette(palette, PaletteRes);
 		palette=gamedata->GetPalette(PaletteRes);
+		if (ProjectileServer::Pooling && !palette && blend) {
+			palette = server->GetSharedPalette(travel, BAMRes1, NULL, blend);
+			shared = true;
+		}
 	}
 
 	if (TFlags&PTF_LIGHT) {
 		light = core->GetVideoDriver()->CreateLight(LightX, LightZ);
 	}
-	if (TFlags&PTF_BLEND) {
+	if ((TFlags&PTF_BLEND) && !shared) {
 		SetBlend(TFlags&PTF_BRIGHTEN);
 	}
 	if (SFlags&PSF_FLYING) {
@@ -1241,7 +1277,10 @@ void Projectile::SecondaryTarget()
 			}
 		}
 
-		Projectile *pro = server->GetProjectileByIndex(Extension->ExplProjIdx);
+		server->stats.targets++;
+		server->stats.targetHash = server->stats.targetHash * 31 + Target;
+
+		Projectile *pro = server->GetProjectileByIndex(Extension->ExplProjIdx, area);
 		pro->SetEffectsCopy(effects, Pos);
 		//copy the additional effects reference to the child projectile
 		//but only when there is a spell to copy
@@ -1352,7 +1391,7 @@ bool Projectile::DrawChildren(const Region &screen)
 					children[i]->DrawTravel(screen);
 					drawn = true;
 				} else {
-					delete children[i];
+					area->RecycleProjectile(children[i]);
 					children[i]=NULL;
 				}
 			}
@@ -1373,7 +1412,7 @@ void Projectile::DrawExploded(const Region &screen)
 
 void Projectile::SpawnFragment(Point &dest)
 {
-	Projectile *pro = server->GetProjectileByIndex(Extension->FragProjIdx);
+	Projectile *pro = server->GetProjectileByIndex(Extension->FragProjIdx, area);
 	if (pro) {
 //		if (Extension->AFlags&PAF_SECONDARY) {
 //				pro->SetEffectsCopy(effects);
@@ -1562,7 +1601,7 @@ void Projectile::DrawExplosion(const Region &screen)
 				}
 			}
 			//create a custom projectile with single traveling effect
-			Projectile *pro = server->CreateDefaultProjectile((unsigned int) ~0);
+			Projectile *pro = server->CreateDefaultProjectile((unsigned int) ~0, area);
 			strnlwrcpy(pro->BAMRes1, tmp, 8);
 			if (ExtFlags&PEF_TRAIL) {
 				pro->Aim = Aim;
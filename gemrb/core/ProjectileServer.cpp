@@ -20,10 +20,14 @@
 
 #include "ProjectileServer.h"
 
+#include "Animation.h"
 #include "GameData.h"
 #include "Interface.h"
+#include "Map.h"
+#include "Palette.h"
 #include "PluginMgr.h"
 #include "ProjectileMgr.h"
+#include "Sprite2D.h"
 #include "SymbolMgr.h"
 
 namespace GemRB {
@@ -33,6 +37,10 @@ namespace GemRB {
 //////////////////////////////////////////////////////////////////////
 
 #define MAX_PROJ_IDX  0x1fff
+//distinct bam and gradient combinations kept before starting over
+#define MAX_SHARED_PALETTES 256
+
+bool ProjectileServer::Pooling = true;
 
 ProjectileServer::ProjectileServer()
 {
@@ -40,6 +48,7 @@ ProjectileServer::ProjectileServer()
 	projectiles = NULL;
 	explosioncount = -1;
 	explosions = NULL;
+	memset(&stats, 0, sizeof(stats));
 }
 
 ProjectileServer::~ProjectileServer()
@@ -50,11 +59,92 @@ ProjectileServer::~ProjectileServer()
 	if (explosions) {
 		delete[] explosions;
 	}
+	std::map<ProjectilePaletteKey, Palette*>::iterator it;
+	for (it = palettes.begin(); it != palettes.end(); ++it) {
+		it->second->release();
+	}
 }
 
-Projectile *ProjectileServer::CreateDefaultProjectile(unsigned int idx)
+Projectile *ProjectileServer::NewProjectile(Map *area)
 {
-	Projectile *pro = new Projectile();
+	Projectile *pro = NULL;
+	if (area && Pooling) {
+		pro = area->GetPooledProjectile();
+	}
+	if (pro) {
+		stats.reused++;
+	} else {
+		pro = new Projectile();
+		stats.allocated++;
+	}
+	return pro;
+}
+
+Palette *ProjectileServer::GetSharedPalette(Animation *anims[], const ieResRef bam, const ieByte *gradients, int blend)
+{
+	ProjectilePaletteKey key;
+	memset(&key, 0, sizeof(key));
+	strnlwrcpy(key.bam, bam, 8);
+	if (gradients) {
+		memcpy(key.gradients, gradients, sizeof(key.gradients));
+	}
+	key.blend = (ieByte) blend;
+
+	std::map<ProjectilePaletteKey, Palette*>::iterator it = palettes.find(key);
+	if (it != palettes.end()) {
+		stats.sharedPalettes++;
+		it->second->acquire();
+		return it->second;
+	}
+
+	Palette *pal = NULL;
+	for (unsigned int i = 0; i < MAX_ORIENT && !pal; i++) {
+		if (!anims[i]) continue;
+		Sprite2D* spr = anims[i]->GetFrame(0);
+		if (spr) {
+			pal = spr->GetPalette()->Copy();
+		}
+	}
+	if (!pal) {
+		return NULL;
+	}
+	stats.palettes++;
+	if (gradients) {
+		ieDword Colors[7];
+		for (int i = 0; i < 7; i++) {
+			Colors[i] = gradients[i];
+		}
+		pal->SetupPaperdollColours(Colors, 0);
+	}
+	if (blend) {
+		if (!pal->alpha) {
+			pal->CreateShadedAlphaChannel();
+		}
+		if (blend > 1) {
+			pal->Brighten();
+		}
+	}
+
+	if (palettes.size() >= MAX_SHARED_PALETTES) {
+		for (it = palettes.begin(); it != palettes.end(); ++it) {
+			it->second->release();
+		}
+		palettes.clear();
+	}
+	pal->acquire();
+	palettes[key] = pal;
+	return pal;
+}
+
+Projectile *ProjectileServer::CreateDefaultProjectile(unsigned int idx, Map *area)
+{
+	Projectile *pro;
+	//the cached template is never pooled
+	if (idx == (unsigned int) ~0) {
+		pro = NewProjectile(area);
+	} else {
+		pro = new Projectile();
+	}
 	//int strlength = (ieByte *) (&pro->Extension)-(ieByte *) (&pro->Type);
 	//memset(&pro->Type, 0, strlength );
 	int strlength = (ieByte *) (&pro->Extension)-(ieByte *) (&pro->Speed);
@@ -67,7 +157,7 @@ Projectile *ProjectileServer::CreateDefaultProjectile(unsigned int idx)
 
 	projectiles[idx].projectile = pro;
 	pro->SetIdentifiers(projectiles[idx].resname, idx);
-	return ReturnCopy(idx);
+	return ReturnCopy(idx, area);
 }
 
 //this function can return only projectiles listed in projectl.ids
@@ -79,27 +169,27 @@ Projectile *ProjectileServer::GetProjectileByName(const ieResRef resname)
 	unsigned int idx=GetHighestProjectileNumber();
 	while(idx--) {
 		if (!strnicmp(resname, projectiles[idx].resname,8) ) {
-			return GetProjectile(idx);
+			return GetProjectile(idx, NULL);
 		}
 	}
 	return NULL;
 }
 
-Projectile *ProjectileServer::GetProjectileByIndex(unsigned int idx)
+Projectile *ProjectileServer::GetProjectileByIndex(unsigned int idx, Map *area)
 {
 	if (!core->IsAvailable(IE_PRO_CLASS_ID)) {
 		return NULL;
 	}
 	if (idx>=GetHighestProjectileNumber()) {
-		return GetProjectile(0);
+		return GetProjectile(0, area);
 	}
 
-	return GetProjectile(idx);
+	return GetProjectile(idx, area);
 }
 
-Projectile *ProjectileServer::ReturnCopy(unsigned int idx)
+Projectile *ProjectileServer::ReturnCopy(unsigned int idx, Map *area)
 {
-	Projectile *pro = new Projectile();
+	Projectile *pro = NewProjectile(area);
 	Projectile *old = projectiles[idx].projectile;
 	//int strlength = (ieByte *) (&pro->Extension)-(ieByte *) (&pro->Type);
 	//memcpy(&pro->Type, &old->Type, strlength );
@@ -113,19 +203,19 @@ Projectile *ProjectileServer::ReturnCopy(unsigned int idx)
 	return pro;
 }
 
-Projectile *ProjectileServer::GetProjectile(unsigned int idx)
+Projectile *ProjectileServer::GetProjectile(unsigned int idx, Map *area)
 {
 	if (projectiles[idx].projectile) {
-		return ReturnCopy(idx);
+		return ReturnCopy(idx, area);
 	}
 	DataStream* str = gamedata->GetResource( projectiles[idx].resname, IE_PRO_CLASS_ID );
 	PluginHolder<ProjectileMgr> sm(IE_PRO_CLASS_ID);
 	if (!sm) {
 		delete ( str );
-		return CreateDefaultProjectile(idx);
+		return CreateDefaultProjectile(idx, area);
 	}
 	if (!sm->Open(str)) {
-		return CreateDefaultProjectile(idx);
+		return CreateDefaultProjectile(idx, area);
 	}
 	Projectile *pro = new Projectile();
 	projectiles[idx].projectile = pro;
@@ -178,7 +268,7 @@ Projectile *ProjectileServer::GetProjectile(unsigned int idx)
 	}
 
 	pro->autofree = true;
-	return ReturnCopy(idx);
+	return ReturnCopy(idx, area);
 }
 
 int ProjectileServer::InitExplosion()
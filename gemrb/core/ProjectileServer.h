@@ -25,6 +25,8 @@
 
 #include "Projectile.h"
 
+#include <map>
+
 namespace GemRB {
 
 class SymbolMgr;
@@ -62,6 +64,31 @@ public:
 	int flags;
 };
 
+//the key of a shared projectile palette
+struct ProjectilePaletteKey
+{
+	ieResRef bam;
+	ieByte gradients[7];
+	ieByte blend; //0 none, 1 blended, 2 blended and brightened
+
+	bool operator<(const ProjectilePaletteKey &other) const
+	{
+		return memcmp(this, &other, sizeof(ProjectilePaletteKey)) < 0;
+	}
+};
+
+//counters for the projectile benchmark
+struct ProjectileStats
+{
+	unsigned int allocated; //projectiles created with new
+	unsigned int reused;    //projectiles taken from an area pool
+	unsigned int animations; //animation cycles created
+	unsigned int palettes;  //palettes built
+	unsigned int sharedPalettes; //palettes served from the cache
+	unsigned int targets;   //actors hit by area projectiles
+	ieDword targetHash;     //hash of their global ids, in hit order
+};
+
 //this singleton object serves the projectile objects
 class GEM_EXPORT ProjectileServer
 {
@@ -69,7 +96,13 @@ public:
 	ProjectileServer();
 	~ProjectileServer();
 
-	Projectile *GetProjectileByIndex(unsigned int idx);
+	//share palettes and single orientation animations between projectiles
+	//and reuse expired ones of the area, turned off only for benchmarking
+	static bool Pooling;
+	ProjectileStats stats;
+
+	//if an area is given, the projectile may be an expired one from its pool
+	Projectile *GetProjectileByIndex(unsigned int idx, Map *area = NULL);
 	//it is highly unlikely we need this function
 	Projectile *GetProjectileByName(const ieResRef resname);
 	//returns the highest projectile id
@@ -78,8 +111,12 @@ public:
 	int GetExplosionFlags(unsigned int idx);
 	ieResRef const *GetExplosion(unsigned int idx, int type);
 	//creates an empty projectile on the fly
-	Projectile *CreateDefaultProjectile(unsigned int idx);
+	Projectile *CreateDefaultProjectile(unsigned int idx, Map *area = NULL);
+	//the gradient coloured and/or blended palette of a bam, the same object is
+	//returned for the same parameters, so it must not be changed
+	Palette *GetSharedPalette(Animation *anims[], const ieResRef bam, const ieByte *gradients, int blend);
 private:
+	std::map<ProjectilePaletteKey, Palette*> palettes;
 	ProjectileEntry *projectiles; //this is the list of projectiles
 	int projectilecount;
 	ExplosionEntry *explosions;   //this is the list of explosion resources
@@ -89,9 +126,11 @@ private:
 	// internal function: read projectiles
 	void AddSymbols(Holder<SymbolMgr> projlist);
 	//this method is used internally
-	Projectile *GetProjectile(unsigned int idx);
+	Projectile *GetProjectile(unsigned int idx, Map *area);
 	//creates a clone from the cached projectiles
-	Projectile *ReturnCopy(unsigned int idx);
+	Projectile *ReturnCopy(unsigned int idx, Map *area);
+	//a blank projectile, from the area pool if possible
+	Projectile *NewProjectile(Map *area);
 	//returns one of the resource names
 };
 
@@ -59,6 +59,13 @@ RNG& RNG::getInstance() {
 	return instance;
 }
 
+/**
+ * Reseeds the engine, so runs can be reproduced (eg. for benchmarks).
+ */
+void RNG::seed(uint32_t seed) {
+	engine.seed(seed);
+}
+
 /**
  * It is possible to generate random numbers from [-min, +/-max].
  * It is only necessary that the upper bound is larger or equal to the lower bound - with the exception
@@ -39,6 +39,7 @@ class GEM_EXPORT RNG {
 	public:
 		static RNG& getInstance();
 		int32_t rand(int32_t min = 0, int32_t max = INT_MAX-1);
+		void seed(uint32_t seed);
 };
 
 }
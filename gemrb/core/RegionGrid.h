@@ -0,0 +1,114 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef REGIONGRID_H
+#define REGIONGRID_H
+
+#include "globals.h"
+#include "Region.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace GemRB {
+
+// cells are 2^REGIONGRID_SHIFT pixels a side
+#define REGIONGRID_SHIFT 8
+
+/**
+ * @class RegionGrid
+ * Buckets values by the grid cells their bounding box touches, so point
+ * lookups only have to consider the few values near the point.
+ * Coordinates outside the grid land in its border cells, so nothing is lost.
+ * Buckets keep the insertion order, which makes the first match of a lookup
+ * the same one a linear search of the inserted values would find.
+ */
+
+template <class T>
+class RegionGrid {
+private:
+	int width, height; // in cells
+	std::vector<std::vector<T> > cells;
+
+	int CellX(int x) const { return Clamp(x >> REGIONGRID_SHIFT, 0, width - 1); }
+	int CellY(int y) const { return Clamp(y >> REGIONGRID_SHIFT, 0, height - 1); }
+
+public:
+	RegionGrid() : width(1), height(1), cells(1) {}
+
+	/** empties the grid and resizes it to cover a map of the given pixel size */
+	void Reset(const Point& size)
+	{
+		int w = std::max(1, (size.x + (1 << REGIONGRID_SHIFT) - 1) >> REGIONGRID_SHIFT);
+		int h = std::max(1, (size.y + (1 << REGIONGRID_SHIFT) - 1) >> REGIONGRID_SHIFT);
+		if (w != width || h != height) {
+			width = w;
+			height = h;
+			cells.clear();
+			cells.resize(width * height);
+			return;
+		}
+		// keep the buckets' memory when refilling every tick
+		for (size_t i = 0; i < cells.size(); i++) {
+			cells[i].clear();
+		}
+	}
+
+	/** adds value to every cell touched by bbox, edges included */
+	void Insert(const T& value, const Region& bbox)
+	{
+		int x1 = CellX(bbox.x + bbox.w);
+		int y1 = CellY(bbox.y + bbox.h);
+		for (int y = CellY(bbox.y); y <= y1; y++) {
+			for (int x = CellX(bbox.x); x <= x1; x++) {
+				cells[y * width + x].push_back(value);
+			}
+		}
+	}
+
+	/** the values that may contain p, in insertion order */
+	const std::vector<T>& Lookup(const Point& p) const
+	{
+		return cells[CellY(p.y) * width + CellX(p.x)];
+	}
+
+	/** calls f with every bucket touched by rgn, edges included */
+	template <class F>
+	void ForEachBucket(const Region& rgn, F f) const
+	{
+		int x1 = CellX(rgn.x + rgn.w);
+		int y1 = CellY(rgn.y + rgn.h);
+		for (int y = CellY(rgn.y); y <= y1; y++) {
+			for (int x = CellX(rgn.x); x <= x1; x++) {
+				f(cells[y * width + x]);
+			}
+		}
+	}
+
+	/** number of cells touched by rgn */
+	int BucketCount(const Region& rgn) const
+	{
+		return (CellX(rgn.x + rgn.w) - CellX(rgn.x) + 1) * (CellY(rgn.y + rgn.h) - CellY(rgn.y) + 1);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,266 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+#include "globals.h"
+#include "Resource.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <vector>
+
+namespace GemRB {
+
+// slots the table starts with, always a power of two
+#define RESOURCECACHE_INITIAL_SIZE 256
+
+struct ResourceCacheStats {
+	unsigned long hits = 0;
+	unsigned long misses = 0;
+	unsigned long evictions = 0;
+	size_t entries = 0;
+	size_t slots = 0;
+	size_t bytes = 0; // of all entries
+	size_t unusedBytes = 0; // of the ones without users
+};
+
+/**
+ * @class ResourceCache
+ * Shares loaded resources by their resref and counts their users.
+ * An open addressing table that grows as needed, so lookups stay cheap
+ * no matter how many resources a mod brings.
+ * Entries nobody uses anymore stay cached until they are dropped with
+ * DecRef(..., true), or by Cleanup() once they take up more than the budget,
+ * least recently used first. Pointers into them stay valid until then, so
+ * Cleanup() is only called at safe points, like between frames.
+ * The reference counts are atomic, ready for workers sharing entries, but the
+ * table itself, lookups and DecRef included, is for the main thread only.
+ */
+
+template <class T>
+class ResourceCache {
+public:
+	typedef void (*ReleaseFun)(T*);
+
+private:
+	struct Entry {
+		ResRef key;
+		T* data;
+		size_t size;
+		unsigned long lastUse;
+		std::atomic<int> refCount;
+
+		Entry(const ResRef& k, T* d, size_t s) : key(k), data(d), size(s), lastUse(0), refCount(1) {}
+	};
+
+	std::vector<Entry*> slots;
+	size_t used = 0; // live entries and tombstones
+	ReleaseFun release;
+	size_t budget;
+	unsigned long useClock = 0;
+	ResourceCacheStats stats;
+
+	// marks the slots of removed entries, so probing goes on past them
+	static Entry* Tombstone() { static Entry* const mark = reinterpret_cast<Entry*>(&Tombstone); return mark; }
+
+	static size_t Hash(const char* key)
+	{
+		size_t hash = 0;
+		for (int i = 0; i < 8 && key[i]; i++) {
+			hash = hash * 31 + tolower(key[i]);
+		}
+		// the low bits pick the slot, so mix the high ones in
+		return hash ^ (hash >> 7) ^ (hash >> 15);
+	}
+
+	size_t FindSlot(const ResRef& key) const
+	{
+		if (slots.empty()) return size_t(-1);
+		size_t mask = slots.size() - 1;
+		for (size_t i = Hash(key.CString()) & mask; ; i = (i + 1) & mask) {
+			const Entry* entry = slots[i];
+			if (!entry) return size_t(-1);
+			if (entry != Tombstone() && entry->key == key) return i;
+		}
+	}
+
+	void Insert(Entry* entry)
+	{
+		size_t mask = slots.size() - 1;
+		size_t i = Hash(entry->key.CString()) & mask;
+		while (slots[i] && slots[i] != Tombstone()) {
+			i = (i + 1) & mask;
+		}
+		if (!slots[i]) used++;
+		slots[i] = entry;
+	}
+
+	void Rehash(size_t size)
+	{
+		std::vector<Entry*> old;
+		old.swap(slots);
+		slots.assign(size, nullptr);
+		used = 0;
+		for (Entry* entry : old) {
+			if (entry && entry != Tombstone()) Insert(entry);
+		}
+		stats.slots = size;
+	}
+
+	void Remove(size_t slot)
+	{
+		Entry* entry = slots[slot];
+		if (!entry->refCount) stats.unusedBytes -= entry->size;
+		stats.bytes -= entry->size;
+		stats.entries--;
+		slots[slot] = Tombstone();
+		delete entry;
+	}
+
+public:
+	/** budget is how many bytes unused entries may keep taking up after
+	 * a Cleanup(), 0 has it drop them all */
+	explicit ResourceCache(ReleaseFun fun = nullptr, size_t budget = 0)
+	: release(fun), budget(budget) {}
+	ResourceCache(const ResourceCache&) = delete;
+	~ResourceCache() { RemoveAll(); }
+	ResourceCache& operator=(const ResourceCache&) = delete;
+
+	/** returns the cached resource and adds a user, NULL if there is none
+	 * (a NULL can be cached too, check RefCount to tell them apart) */
+	T* GetResource(const ResRef& key)
+	{
+		size_t slot = FindSlot(key);
+		if (slot == size_t(-1)) {
+			stats.misses++;
+			return nullptr;
+		}
+		Entry* entry = slots[slot];
+		if (entry->refCount++ == 0) stats.unusedBytes -= entry->size;
+		entry->lastUse = ++useClock;
+		stats.hits++;
+		return entry->data;
+	}
+
+	/** adds a resource with its first user, size is what counts against the budget
+	 * returns false if key is already taken by something else */
+	bool SetAt(const ResRef& key, T* value, size_t size = sizeof(T))
+	{
+		size_t slot = FindSlot(key);
+		if (slot != size_t(-1)) {
+			return slots[slot]->data == value;
+		}
+		if (slots.empty()) {
+			Rehash(RESOURCECACHE_INITIAL_SIZE);
+		} else if ((used + 1) * 4 > slots.size() * 3) {
+			// only grow if it isn't the tombstones filling it up
+			Rehash(stats.entries * 2 >= slots.size() ? slots.size() * 2 : slots.size());
+		}
+		Entry* entry = new Entry(key, value, size);
+		entry->lastUse = ++useClock;
+		Insert(entry);
+		stats.entries++;
+		stats.bytes += size;
+		return true;
+	}
+
+	/** removes a user of value, name makes it faster
+	 * returns the users left, -1 if value wasn't cached or had none
+	 * if remove is set and no users are left, the entry is dropped
+	 * and the caller has to free value */
+	int DecRef(const T* value, const char* name, bool remove)
+	{
+		size_t slot = size_t(-1);
+		if (name) {
+			slot = FindSlot(ResRef(name));
+			if (slot != size_t(-1) && slots[slot]->data != value) return -1;
+		} else {
+			for (size_t i = 0; i < slots.size(); i++) {
+				if (slots[i] && slots[i] != Tombstone() && slots[i]->data == value) {
+					slot = i;
+					break;
+				}
+			}
+		}
+		if (slot == size_t(-1)) return -1;
+
+		Entry* entry = slots[slot];
+		if (entry->refCount <= 0) return -1;
+		int left = --entry->refCount;
+		if (left) return left;
+		stats.unusedBytes += entry->size;
+		if (remove) {
+			Remove(slot);
+		}
+		return 0;
+	}
+
+	/** the number of users, -1 if key isn't cached */
+	int RefCount(const ResRef& key) const
+	{
+		size_t slot = FindSlot(key);
+		return slot == size_t(-1) ? -1 : int(slots[slot]->refCount);
+	}
+
+	/** drops every entry, whether in use or not */
+	void RemoveAll()
+	{
+		for (size_t i = 0; i < slots.size(); i++) {
+			if (slots[i] && slots[i] != Tombstone()) {
+				if (release) release(slots[i]->data);
+				delete slots[i];
+			}
+		}
+		slots.clear();
+		used = 0;
+		stats.entries = stats.slots = stats.bytes = stats.unusedBytes = 0;
+	}
+
+	/** drops entries without users, least recently used first, until
+	 * the rest fits in the budget */
+	void Cleanup()
+	{
+		if (stats.unusedBytes <= budget) return;
+
+		std::vector<size_t> unused;
+		for (size_t i = 0; i < slots.size(); i++) {
+			if (slots[i] && slots[i] != Tombstone() && !slots[i]->refCount) {
+				unused.push_back(i);
+			}
+		}
+		std::sort(unused.begin(), unused.end(), [this](size_t a, size_t b) {
+			return slots[a]->lastUse < slots[b]->lastUse;
+		});
+		for (size_t i = 0; i < unused.size() && stats.unusedBytes > budget; i++) {
+			if (release) release(slots[unused[i]]->data);
+			Remove(unused[i]);
+			stats.evictions++;
+		}
+	}
+
+	size_t GetCount() const { return stats.entries; }
+	const ResourceCacheStats& GetStats() const { return stats; }
+};
+
+}
+
+#endif
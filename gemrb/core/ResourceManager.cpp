@@ -25,10 +25,16 @@
 #include "Resource.h"
 #include "ResourceDesc.h"
 #include "ResourceSource.h"
+#include "System/MemoryStream.h"
 #include "System/StringBuffer.h"
 
+#include <mutex>
+
 namespace GemRB {
 
+// held while a source looks a resource up, including the archives it opens
+static std::mutex LookupLock;
+
 ResourceManager::ResourceManager()
 {
 }
@@ -46,6 +52,7 @@ bool ResourceManager::AddSource(const char *path, const char *description, Plugi
 		return false;
 	}
 
+	std::lock_guard<std::mutex> guard(LookupLock);
 	if (flags & RM_REPLACE_SAME_SOURCE) {
 		for (size_t i = 0; i < searchPath.size(); i++) {
 			if (!stricmp(description, searchPath[i]->GetDescription())) {
@@ -72,9 +79,12 @@ bool ResourceManager::Exists(const char *ResRef, SClass_ID type, bool silent) co
 	if (ResRef[0] == '\0')
 		return false;
 	// TODO: check various caches
-	for (size_t i = 0; i < searchPath.size(); i++) {
-		if (searchPath[i]->HasResource( ResRef, type )) {
-			return true;
+	{
+		std::lock_guard<std::mutex> guard(LookupLock);
+		for (size_t i = 0; i < searchPath.size(); i++) {
+			if (searchPath[i]->HasResource( ResRef, type )) {
+				return true;
+			}
 		}
 	}
 	if (!silent) {
@@ -90,10 +100,13 @@ bool ResourceManager::Exists(const char *ResRef, const TypeID *type, bool silent
 		return false;
 	// TODO: check various caches
 	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
-	for (size_t j = 0; j < types.size(); j++) {
-		for (size_t i = 0; i < searchPath.size(); i++) {
-			if (searchPath[i]->HasResource(ResRef, types[j])) {
-				return true;
+	{
+		std::lock_guard<std::mutex> guard(LookupLock);
+		for (size_t j = 0; j < types.size(); j++) {
+			for (size_t i = 0; i < searchPath.size(); i++) {
+				if (searchPath[i]->HasResource(ResRef, types[j])) {
+					return true;
+				}
 			}
 		}
 	}
@@ -112,7 +125,11 @@ DataStream* ResourceManager::GetResource(const char* ResRef, SClass_ID type, boo
 	if (ResRef[0] == '\0')
 		return NULL;
 	for (size_t i = 0; i < searchPath.size(); i++) {
-		DataStream *ds = searchPath[i]->GetResource(ResRef, type);
+		DataStream *ds;
+		{
+			std::lock_guard<std::mutex> guard(LookupLock);
+			ds = searchPath[i]->GetResource(ResRef, type);
+		}
 		if (ds) {
 			if (!silent) {
 				Log(MESSAGE, "ResourceManager", "Found '%s.%s' in '%s'.",
@@ -138,7 +155,11 @@ Resource* ResourceManager::GetResource(const char* ResRef, const TypeID *type, b
 	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
 	for (size_t j = 0; j < types.size(); j++) {
 		for (size_t i = 0; i < searchPath.size(); i++) {
-			DataStream *str = searchPath[i]->GetResource(ResRef, types[j]);
+			DataStream *str;
+			{
+				std::lock_guard<std::mutex> guard(LookupLock);
+				str = searchPath[i]->GetResource(ResRef, types[j]);
+			}
 			if (!str && useCorrupt && core->UseCorruptedHack) {
 				// don't look at other paths if requested
 				core->UseCorruptedHack = false;
@@ -167,4 +188,23 @@ Resource* ResourceManager::GetResource(const char* ResRef, const TypeID *type, b
 	return NULL;
 }
 
+DataStream* ResourceManager::ReadResource(const char* ResRef, SClass_ID type, bool silent) const
+{
+	DataStream* str = GetResource(ResRef, type, silent);
+	if (!str) {
+		return NULL;
+	}
+	unsigned long size = str->Size();
+	void* data = malloc(size);
+	if (str->Read(data, size) != (int) size) {
+		free(data);
+		delete str;
+		return NULL;
+	}
+	DataStream* mem = new MemoryStream(str->originalfile, data, size);
+	strlcpy(mem->filename, str->filename, sizeof(mem->filename));
+	delete str;
+	return mem;
+}
+
 }
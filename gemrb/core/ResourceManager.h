@@ -43,6 +43,14 @@ class ResourceSource;
 #endif
 class TypeID;
 
+/**
+ * @class ResourceManager
+ * Finds resources in the search path. Lookups take a lock shared by all
+ * managers, so they may run on worker threads: the sources, the bif
+ * archives and the files they unpack into the cache aren't thread safe.
+ * The streams handed out are independent, reading them needs no lock.
+ */
+
 class GEM_EXPORT ResourceManager {
 public:
 	ResourceManager();
@@ -66,6 +74,8 @@ public:
 	DataStream* GetResource(const char* resname, SClass_ID type, bool silent = false) const;
 	/** Returns Resource object associated to given resource */
 	Resource* GetResource(const char* resname, const TypeID *type, bool silent = false, bool useCorrupt = false) const;
+	/** Returns the resource read into memory, NULL if it is missing or short */
+	DataStream* ReadResource(const char* resname, SClass_ID type, bool silent = false) const;
 
 private:
 	std::vector<Holder<ResourceSource> > searchPath;
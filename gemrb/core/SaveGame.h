@@ -22,25 +22,42 @@
 #define SAVEGAME_H
 
 #include "exports.h"
+#include "ie_types.h"
 
 #include "Holder.h"
 #include "ResourceManager.h"
 #include "System/VFS.h"
 
+#include <ctime>
+#include <memory>
+
 namespace GemRB {
 
 class ImageMgr;
 class Sprite2D;
+class WorkerPool;
+struct SaveGameImages;
+
+/** What the save browser needs to know about a slot without opening it.
+ * Kept in the on-disk save index, keyed by the slot directory mtime. */
+struct SaveGameInfo {
+	time_t dirTime;
+	bool valid;
+	int portraitCount;
+	time_t previewTime;
+	ieDword gameTime;
+	bool gameTimeValid;
+};
 
 class GEM_EXPORT SaveGame : public Held<SaveGame> {
 public:
 	static const TypeID ID;
 public:
-	SaveGame(const char* path, const char* name, const char* prefix, const char* slotname, int pCount, int saveID);
+	SaveGame(const char* path, const char* name, const char* prefix, const char* slotname, int saveID, const SaveGameInfo& info);
 	~SaveGame();
 	int GetPortraitCount() const
 	{
-		return PortraitCount;
+		return Info.portraitCount;
 	}
 	int GetSaveID() const
 	{
@@ -67,22 +84,34 @@ public:
 	{
 		return SlotName;
 	}
+	const SaveGameInfo& GetInfo() const
+	{
+		return Info;
+	}
 
 	Sprite2D* GetPortrait(int index) const;
 	Sprite2D* GetPreview() const;
 	DataStream* GetGame() const;
 	DataStream* GetWmap(int idx) const;
 	DataStream* GetSave() const;
+
+	/** queue decoding of the preview and portraits on workers */
+	void PrefetchImages(WorkerPool& workers);
+	/** drop queued decoding and wait for a running one, eg. before deleting the files */
+	void CancelPrefetch();
 private:
+	SaveGameImages* WaitForImages() const;
+
 	char Path[_MAX_PATH];
 	char Prefix[10];
 	char Name[_MAX_PATH];
 	char Date[_MAX_PATH];
 	mutable char GameDate[_MAX_PATH];
 	char SlotName[_MAX_PATH];
-	int PortraitCount;
+	SaveGameInfo Info;
 	int SaveID;
 	ResourceManager manager;
+	std::shared_ptr<SaveGameImages> images;
 };
 
 }
@@ -36,6 +36,7 @@
 #include "GUI/GameControl.h"
 #include "Scriptable/Actor.h"
 #include "System/FileStream.h"
+#include "System/WorkerPool.h"
 
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
@@ -45,6 +46,8 @@
 #endif
 
 #include <cassert>
+#include <condition_variable>
+#include <mutex>
 #include <set>
 #include <time.h>
 
@@ -52,20 +55,23 @@ namespace GemRB {
 
 const TypeID SaveGame::ID = { "SaveGame" };
 
-/** Extract date from save game ds into Date. */
-static void ParseGameDate(DataStream *ds, char *Date)
+/** Read the game time from save game ds, false if it isn't one. */
+static bool ReadGameTime(DataStream *ds, ieDword& GameTime)
 {
-	Date[0] = '\0';
-
+	if (!ds) {
+		return false;
+	}
 	char Signature[8];
-	ieDword GameTime;
 	ds->Read(Signature, 8);
 	ds->ReadDword(&GameTime);
 	delete ds;
-	if (memcmp(Signature,"GAME",4) ) {
-		strcpy(Date, "ERROR");
-		return;
-	}
+	return memcmp(Signature, "GAME", 4) == 0;
+}
+
+/** Format the game time of a save into Date. */
+static void FormatGameDate(ieDword GameTime, char *Date)
+{
+	Date[0] = '\0';
 
 	int hours = ((int)GameTime)/core->Time.hour_sec;
 	int days = hours/24;
@@ -109,23 +115,109 @@ static void ParseGameDate(DataStream *ds, char *Date)
 	core->FreeString(c);
 }
 
-SaveGame::SaveGame(const char* path, const char* name, const char* prefix, const char* slotname, int pCount, int saveID)
+/** Preview and portraits of a save, read and decoded on a worker ahead
+ * of the load screen asking for them. Sprites come from the video driver,
+ * so they are only made on the main thread, once the job is DONE and the
+ * load screen shows them. */
+struct SaveGameImages {
+	enum { QUEUED, RUNNING, DONE, CANCELLED };
+
+	std::mutex lock;
+	std::condition_variable finished;
+	int state;
+	std::string path;
+	std::string prefix;
+	int portraitCount;
+	// the opened images hold the decoded pixels
+	ResourceHolder<ImageMgr> preview;
+	std::vector<ResourceHolder<ImageMgr> > portraits;
+	// the sprites made of them, on first use
+	Sprite2D* previewSprite;
+	std::vector<Sprite2D*> portraitSprites;
+
+	SaveGameImages() : state(QUEUED), portraitCount(0), previewSprite(NULL) {}
+
+	void FreeSprites()
+	{
+		Sprite2D::FreeSprite(previewSprite);
+		for (size_t i = 0; i < portraitSprites.size(); i++) {
+			Sprite2D::FreeSprite(portraitSprites[i]);
+		}
+		portraitSprites.clear();
+	}
+};
+
+static Sprite2D* DecodeSaveImage(const ResourceManager& rm, const char* name)
+{
+	ResourceHolder<ImageMgr> im = GetResourceHolder<ImageMgr>(name, rm, true);
+	if (!im)
+		return NULL;
+	return im->GetSprite2D();
+}
+
+/** the sprite of a decoded image, made on first use */
+static Sprite2D* SaveImageSprite(ResourceHolder<ImageMgr>& im, Sprite2D*& sprite)
+{
+	if (!sprite && im) {
+		sprite = im->GetSprite2D();
+		// the pixels are in the sprite now
+		im.release();
+	}
+	if (sprite) {
+		sprite->acquire();
+	}
+	return sprite;
+}
+
+/** Decode the images unless someone else already did or they are no
+ * longer wanted. Runs on a worker, or on the main thread if it got there
+ * first. */
+static void DecodeSaveImages(const std::shared_ptr<SaveGameImages>& img)
+{
+	{
+		std::lock_guard<std::mutex> l(img->lock);
+		if (img->state != SaveGameImages::QUEUED) {
+			return;
+		}
+		img->state = SaveGameImages::RUNNING;
+	}
+
+	// a manager of our own, the save's one belongs to the main thread
+	// opening the images reads and decodes them, but makes no sprites
+	ResourceManager rm;
+	rm.AddSource(img->path.c_str(), "SaveImages", PLUGIN_RESOURCE_DIRECTORY);
+	ResourceHolder<ImageMgr> preview = GetResourceHolder<ImageMgr>(img->prefix.c_str(), rm, true);
+	std::vector<ResourceHolder<ImageMgr> > portraits;
+	// the original bound allowed one past the count, portraits may have gaps
+	for (int i = 0; i <= img->portraitCount; i++) {
+		char name[20];
+		snprintf(name, sizeof(name), "PORTRT%d", i);
+		portraits.push_back(GetResourceHolder<ImageMgr>(name, rm, true));
+	}
+
+	std::lock_guard<std::mutex> l(img->lock);
+	// the reference counts aren't atomic, so ours are gone before unlocking
+	img->preview = preview;
+	preview.release();
+	img->portraits.swap(portraits);
+	img->portraitSprites.assign(img->portraits.size(), NULL);
+	img->state = SaveGameImages::DONE;
+	img->finished.notify_all();
+}
+
+SaveGame::SaveGame(const char* path, const char* name, const char* prefix, const char* slotname, int saveID, const SaveGameInfo& info)
 {
 	strlcpy( Prefix, prefix, sizeof( Prefix ) );
 	strlcpy( Path, path, sizeof( Path ) );
 	strlcpy( Name, name, sizeof( Name ) );
 	strlcpy( SlotName, slotname, sizeof( SlotName ) );
-	PortraitCount = pCount;
+	Info = info;
 	SaveID = saveID;
-	char nPath[_MAX_PATH];
-	struct stat my_stat;
-	PathJoinExt(nPath, Path, Prefix, "bmp");
-	memset(&my_stat,0,sizeof(my_stat));
-	if (stat(nPath, &my_stat)) {
+	if (!Info.previewTime) {
 		Log(ERROR, "SaveGameIterator", "Stat call failed, using dummy time!");
 		strlcpy(Date, "Sun 31 Feb 00:00:01 2099", _MAX_PATH);
 	} else {
-		strftime(Date, _MAX_PATH, "%c", localtime((time_t*)&my_stat.st_mtime));
+		strftime(Date, _MAX_PATH, "%c", localtime(&Info.previewTime));
 	}
 	manager.AddSource(Path, Name, PLUGIN_RESOURCE_DIRECTORY);
 	GameDate[0] = '\0';
@@ -133,27 +225,78 @@ SaveGame::SaveGame(const char* path, const char* name, const char* prefix, const
 
 SaveGame::~SaveGame()
 {
+	CancelPrefetch();
+}
+
+void SaveGame::PrefetchImages(WorkerPool& workers)
+{
+	if (images) {
+		return;
+	}
+	images = std::make_shared<SaveGameImages>();
+	images->path = Path;
+	images->prefix = Prefix;
+	images->portraitCount = Info.portraitCount;
+	std::shared_ptr<SaveGameImages> img = images;
+	workers.Post([img]() {
+		DecodeSaveImages(img);
+	});
+}
+
+void SaveGame::CancelPrefetch()
+{
+	if (!images) {
+		return;
+	}
+	std::unique_lock<std::mutex> l(images->lock);
+	if (images->state == SaveGameImages::QUEUED) {
+		images->state = SaveGameImages::CANCELLED;
+	}
+	while (images->state == SaveGameImages::RUNNING) {
+		images->finished.wait(l);
+	}
+	images->FreeSprites();
+	images->preview.release();
+	images->portraits.clear();
+	l.unlock();
+	images.reset();
+}
+
+/** The decoded images, doing the work here if no worker has started on it. */
+SaveGameImages* SaveGame::WaitForImages() const
+{
+	if (!images) {
+		return NULL;
+	}
+	DecodeSaveImages(images);
+	std::unique_lock<std::mutex> l(images->lock);
+	while (images->state == SaveGameImages::RUNNING) {
+		images->finished.wait(l);
+	}
+	return images.get();
 }
 
 Sprite2D* SaveGame::GetPortrait(int index) const
 {
-	if (index > PortraitCount) {
+	if (index > Info.portraitCount || index < 0) {
 		return NULL;
 	}
+	SaveGameImages* img = WaitForImages();
+	if (img) {
+		return SaveImageSprite(img->portraits[index], img->portraitSprites[index]);
+	}
 	char nPath[_MAX_PATH];
 	sprintf( nPath, "PORTRT%d", index );
-	ResourceHolder<ImageMgr> im = GetResourceHolder<ImageMgr>(nPath, manager, true);
-	if (!im)
-		return NULL;
-	return im->GetSprite2D();
+	return DecodeSaveImage(manager, nPath);
 }
 
 Sprite2D* SaveGame::GetPreview() const
 {
-	ResourceHolder<ImageMgr> im = GetResourceHolder<ImageMgr>(Prefix, manager, true);
-	if (!im)
-		return NULL;
-	return im->GetSprite2D();
+	SaveGameImages* img = WaitForImages();
+	if (img) {
+		return SaveImageSprite(img->preview, img->previewSprite);
+	}
+	return DecodeSaveImage(manager, Prefix);
 }
 
 DataStream* SaveGame::GetGame() const
@@ -173,17 +316,34 @@ DataStream* SaveGame::GetSave() const
 
 const char* SaveGame::GetGameDate() const
 {
-	if (GameDate[0] == '\0')
-		ParseGameDate(GetGame(), GameDate);
+	if (GameDate[0] == '\0') {
+		if (Info.gameTimeValid) {
+			FormatGameDate(Info.gameTime, GameDate);
+		} else {
+			strcpy(GameDate, "ERROR");
+		}
+	}
 	return GameDate;
 }
 
+// remembers what the slots looked like, so rescans only stat directories
+#define SAVE_INDEX_NAME "gemrb-saves.idx"
+#define SAVE_INDEX_VERSION 1
+// newest saves to decode ahead, the load screen starts at the end
+#define SAVE_PREFETCH_COUNT 16
+
 SaveGameIterator::SaveGameIterator(void)
 {
+	indexLoaded = false;
+	indexDirty = false;
+	imageLoader = new WorkerPool(1);
 }
 
 SaveGameIterator::~SaveGameIterator(void)
 {
+	// the jobs may still be decoding into the saves
+	delete imageLoader;
+	save_slots.clear();
 }
 
 // mission pack save dir or the main one?
@@ -282,10 +442,133 @@ static bool IsSaveGameSlot(const char* Path, const char* slotname)
 	return true;
 }
 
+/** Read what is known about the slot at Path/slotname, false if it isn't a usable one. */
+static bool ReadSlotInfo(const char* Path, const char* slotname, SaveGameInfo& info)
+{
+	info.valid = false;
+	info.portraitCount = 0;
+	info.previewTime = 0;
+	info.gameTime = 0;
+	info.gameTimeValid = false;
+
+	if (!IsSaveGameSlot(Path, slotname)) {
+		return false;
+	}
+
+	char dtmp[_MAX_PATH];
+	PathJoin(dtmp, Path, slotname, NULL);
+	//maximum pathlength == 240, without 8+3 filenames
+	if (strlen(dtmp) > 240) {
+		Log(WARNING, "SaveGame", "Invalid savegame directory '%s' in %s.", slotname, Path);
+		return false;
+	}
+
+	DirectoryIterator dir(dtmp);
+	if (!dir) {
+		return false;
+	}
+	do {
+		if (strnicmp( dir.GetName(), "PORTRT", 6 ) == 0)
+			info.portraitCount++;
+	} while (++dir);
+
+	char ftmp[_MAX_PATH];
+	struct stat my_stat;
+	PathJoinExt(ftmp, dtmp, core->GameNameResRef, "bmp");
+	memset(&my_stat, 0, sizeof(my_stat));
+	if (!stat(ftmp, &my_stat)) {
+		info.previewTime = my_stat.st_mtime;
+	}
+
+	PathJoinExt(ftmp, dtmp, core->GameNameResRef, "gam");
+	info.gameTimeValid = ReadGameTime(FileStream::OpenFile(ftmp), info.gameTime);
+
+	info.valid = true;
+	return true;
+}
+
+/*
+ * The index holds one line per slot directory:
+ * dirTime valid portraitCount previewTime gameTime gameTimeValid slotname
+ * Anything that doesn't parse is just scanned again.
+ */
+void SaveGameIterator::LoadIndex(const char *path)
+{
+	indexLoaded = true;
+	slotIndex.clear();
+
+	char file[_MAX_PATH];
+	PathJoin(file, path, SAVE_INDEX_NAME, NULL);
+	FileStream* str = FileStream::OpenFile(file);
+	if (!str) {
+		return;
+	}
+
+	char line[_MAX_PATH+128];
+	int version = 0;
+	if (str->ReadLine(line, sizeof(line)) == -1 || sscanf(line, "GEMRB SAVEINDEX %d", &version) != 1 || version != SAVE_INDEX_VERSION) {
+		delete str;
+		return;
+	}
+	while (str->ReadLine(line, sizeof(line)) != -1) {
+		long long dirTime, previewTime;
+		int valid, portraits, gameTimeValid, pos = 0;
+		unsigned int gameTime;
+		if (sscanf(line, "%lld %d %d %lld %u %d %n", &dirTime, &valid, &portraits, &previewTime, &gameTime, &gameTimeValid, &pos) != 6 || !pos || !line[pos]) {
+			continue;
+		}
+		SaveGameInfo& info = slotIndex[line + pos];
+		info.dirTime = (time_t) dirTime;
+		info.valid = valid != 0;
+		info.portraitCount = portraits;
+		info.previewTime = (time_t) previewTime;
+		info.gameTime = gameTime;
+		info.gameTimeValid = gameTimeValid != 0;
+	}
+	delete str;
+}
+
+void SaveGameIterator::SaveIndex(const char *path)
+{
+	indexDirty = false;
+
+	char file[_MAX_PATH];
+	PathJoin(file, path, SAVE_INDEX_NAME, NULL);
+	FileStream str;
+	if (!str.Create(file)) {
+		Log(WARNING, "SaveGameIterator", "Unable to write the save index '%s'", file);
+		return;
+	}
+
+	char line[_MAX_PATH+128];
+	int len = snprintf(line, sizeof(line), "GEMRB SAVEINDEX %d\n", SAVE_INDEX_VERSION);
+	str.Write(line, len);
+	for (SlotIndex::const_iterator i = slotIndex.begin(); i != slotIndex.end(); ++i) {
+		const SaveGameInfo& info = i->second;
+		len = snprintf(line, sizeof(line), "%lld %d %d %lld %u %d %s\n", (long long) info.dirTime,
+			info.valid, info.portraitCount, (long long) info.previewTime,
+			(unsigned int) info.gameTime, info.gameTimeValid, i->first.c_str());
+		if (len > 0 && len < (int) sizeof(line)) {
+			str.Write(line, len);
+		}
+	}
+}
+
+/** Drop the index entry of the slot directory at path, it is being rewritten. */
+void SaveGameIterator::ForgetSlot(const char *path)
+{
+	const char *slotname = strrchr(path, PathDelimiter);
+	slotname = slotname ? slotname + 1 : path;
+	if (slotIndex.erase(slotname)) {
+		indexDirty = true;
+	}
+}
+
 bool SaveGameIterator::RescanSaveGames()
 {
-	// delete old entries
-	save_slots.clear();
+	// keep the old entries around, unchanged slots reuse their decoded images
+	charlist old_slots;
+	old_slots.swap(save_slots);
 
 	char Path[_MAX_PATH];
 	PathJoin(Path, core->SavePath, SaveDir(), NULL);
@@ -303,19 +586,74 @@ bool SaveGameIterator::RescanSaveGames()
 		return false;
 	}
 
+	if (!indexLoaded) {
+		LoadIndex(Path);
+	}
+
+	std::set<std::string> seen;
 	std::set<char*,iless> slots;
 	do {
 		const char *name = dir.GetName();
-		if (dir.IsDirectory() && IsSaveGameSlot( Path, name )) {
+		if (name[0] == '.' || !dir.IsDirectory()) {
+			continue;
+		}
+
+		char dtmp[_MAX_PATH];
+		struct stat my_stat;
+		PathJoin(dtmp, Path, name, NULL);
+		memset(&my_stat, 0, sizeof(my_stat));
+		stat(dtmp, &my_stat);
+
+		seen.insert(name);
+		SlotIndex::iterator it = slotIndex.find(name);
+		if (it == slotIndex.end() || it->second.dirTime != my_stat.st_mtime) {
+			SaveGameInfo& info = slotIndex[name];
+			ReadSlotInfo(Path, name, info);
+			info.dirTime = my_stat.st_mtime;
+			indexDirty = true;
+			it = slotIndex.find(name);
+		}
+		if (it->second.valid) {
 			slots.insert(strdup(name));
 		}
 	} while (++dir);
 
+	for (SlotIndex::iterator i = slotIndex.begin(); i != slotIndex.end(); ) {
+		if (seen.count(i->first)) {
+			++i;
+		} else {
+			slotIndex.erase(i++);
+			indexDirty = true;
+		}
+	}
+	if (indexDirty) {
+		SaveIndex(Path);
+	}
+
 	for (std::set<char*,iless>::iterator i = slots.begin(); i != slots.end(); ++i) {
-		save_slots.push_back(BuildSaveGame(*i));
+		const SaveGameInfo& info = slotIndex[*i];
+		Holder<SaveGame> sg;
+		for (charlist::iterator m = old_slots.begin(); m != old_slots.end(); ++m) {
+			if (!strcmp((*m)->GetSlotName(), *i) && (*m)->GetInfo().dirTime == info.dirTime) {
+				sg = *m;
+				break;
+			}
+		}
+		if (!sg) {
+			sg = BuildSaveGame(*i, info);
+		}
+		if (sg) {
+			save_slots.push_back(sg);
+		}
 		free(*i);
 	}
 
+	// decode the newest previews while the player looks at the first page
+	size_t count = save_slots.size();
+	for (size_t i = count; i > 0 && count - i < SAVE_PREFETCH_COUNT; i--) {
+		save_slots[i - 1]->PrefetchImages(*imageLoader);
+	}
+
 	return true;
 }
 
@@ -337,13 +675,12 @@ Holder<SaveGame> SaveGameIterator::GetSaveGame(const char *name)
 	return NULL;
 }
 
-Holder<SaveGame> SaveGameIterator::BuildSaveGame(const char *slotname)
+Holder<SaveGame> SaveGameIterator::BuildSaveGame(const char *slotname, const SaveGameInfo& info)
 {
 	if (!slotname) {
 		return NULL;
 	}
 
-	int prtrt = 0;
 	char Path[_MAX_PATH];
 	//lets leave space for the filenames
 	PathJoin(Path, core->SavePath, SaveDir(), slotname, NULL);
@@ -352,22 +689,12 @@ Holder<SaveGame> SaveGameIterator::BuildSaveGame(const char *slotname)
 	int savegameNumber = 0;
 
 	int cnt = sscanf( slotname, SAVEGAME_DIRECTORY_MATCHER, &savegameNumber, savegameName );
-	//maximum pathlength == 240, without 8+3 filenames
-	if ( (cnt != 2) || (strlen(Path)>240) ) {
+	if (cnt != 2) {
 		Log(WARNING, "SaveGame", "Invalid savegame directory '%s' in %s.", slotname, Path );
 		return NULL;
 	}
 
-	DirectoryIterator dir(Path);
-	if (!dir) {
-		return NULL;
-	}
-	do {
-		if (strnicmp( dir.GetName(), "PORTRT", 6 ) == 0)
-			prtrt++;
-	} while (++dir);
-
-	SaveGame* sg = new SaveGame( Path, savegameName, core->GameNameResRef, slotname, prtrt, savegameNumber );
+	SaveGame* sg = new SaveGame( Path, savegameName, core->GameNameResRef, slotname, savegameNumber, info );
 	return sg;
 }
 
@@ -615,6 +942,7 @@ int SaveGameIterator::CreateSaveGame(int index, bool mqs)
 		return -1;
 	}
 
+	ForgetSlot(Path);
 	if (!DoSaveGame(Path)) {
 		displaymsg->DisplayConstantString(STR_CANTSAVE, DMC_BG2XPGREEN);
 		if (gc) {
@@ -677,6 +1005,7 @@ int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, const char *slotname
 		return -1;
 	}
 
+	ForgetSlot(Path);
 	if (!DoSaveGame(Path)) {
 		displaymsg->DisplayConstantString(STR_CANTSAVE, DMC_BG2XPGREEN);
 		if (gc) {
@@ -699,6 +1028,15 @@ void SaveGameIterator::DeleteSaveGame(Holder<SaveGame> game)
 		return;
 	}
 
+	game->CancelPrefetch();
+	for (charlist::iterator i = save_slots.begin(); i != save_slots.end(); ++i) {
+		if (i->get() == game.get()) {
+			save_slots.erase(i);
+			break;
+		}
+	}
+	ForgetSlot(game->GetPath());
+
 	core->DelTree( game->GetPath(), false ); //remove all files from folder
 	rmdir( game->GetPath() );
 }
@@ -25,16 +25,26 @@
 
 #include "SaveGame.h"
 
+#include <map>
+#include <string>
 #include <vector>
 
 namespace GemRB {
 
+class WorkerPool;
+
 #define SAVEGAME_DIRECTORY_MATCHER "%d - %[A-Za-z0-9- _+*#%&|()=!?':;]"
 
 class GEM_EXPORT SaveGameIterator {
 private:
 	typedef std::vector<Holder<SaveGame> > charlist;
 	charlist save_slots;
+	// slot directory name -> what we learned about it, see LoadIndex
+	typedef std::map<std::string, SaveGameInfo> SlotIndex;
+	SlotIndex slotIndex;
+	bool indexLoaded;
+	bool indexDirty;
+	WorkerPool* imageLoader;
 
 public:
 	SaveGameIterator(void);
@@ -46,8 +56,11 @@ public:
 	Holder<SaveGame> GetSaveGame(const char *slotname);
 private:
 	bool RescanSaveGames();
-	static Holder<SaveGame> BuildSaveGame(const char *slotname);
+	static Holder<SaveGame> BuildSaveGame(const char *slotname, const SaveGameInfo& info);
 	void PruneQuickSave(const char *folder);
+	void LoadIndex(const char *path);
+	void SaveIndex(const char *path);
+	void ForgetSlot(const char *path);
 };
 
 }
@@ -40,6 +40,8 @@ public:
 	virtual bool RunFunction(const char* Modulename, const char* FunctionName, bool report_error, Point) = 0;
 	/** Exec a single String */
 	virtual void ExecString(const char* string, bool feedback) = 0;
+	/** Called once per drawn frame, for profiling */
+	virtual void EndFrame() = 0;
 };
 
 }
@@ -9937,6 +9937,34 @@ void Actor::SetUsedWeapon(const char (&AnimationType)[2], ieWord* MeleeAnimation
 	AttackStance = IE_ANI_ATTACK;
 }
 
+void Actor::PrefetchAnimations() const
+{
+	if (!anims || !area) {
+		return;
+	}
+
+	// only what the actor will plausibly show, the rest is loaded on demand
+	unsigned char stances[12];
+	int count = 0;
+	stances[count++] = GetStance();
+	stances[count++] = IE_ANI_READY;
+	stances[count++] = IE_ANI_WALK;
+	stances[count++] = IE_ANI_DAMAGE;
+	stances[count++] = IE_ANI_DIE;
+	if (AttackStance == IE_ANI_ATTACK) {
+		stances[count++] = IE_ANI_ATTACK_SLASH;
+		stances[count++] = IE_ANI_ATTACK_BACKSLASH;
+		stances[count++] = IE_ANI_ATTACK_JAB;
+	} else {
+		stances[count++] = AttackStance;
+	}
+	if (spellbook.GetTotalKnownSpellsCount()) {
+		stances[count++] = IE_ANI_CONJURE;
+		stances[count++] = IE_ANI_CAST;
+	}
+	anims->PrefetchStances(stances, count);
+}
+
 void Actor::SetUsedShield(const char (&AnimationType)[2], int wt)
 {
 	memcpy(ShieldRef, AnimationType, sizeof(ShieldRef) );
@@ -821,6 +821,8 @@ public:
 	void SetUsedShield(const char (&AnimationType)[2], int WeaponType=-1);
 	void SetUsedHelmet(const char (&AnimationType)[2]);
 	void SetupFist();
+	/* starts decoding the animations this actor is likely to need soon */
+	void PrefetchAnimations() const;
 	/* Returns nonzero if the caster is held */
 	int Immobile() const;
 	/* Returns strref if the item is unusable due to name/type restrictions */
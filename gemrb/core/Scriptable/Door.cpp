@@ -118,6 +118,8 @@ void Door::UpdateDoor()
 		ImpedeBlocks(oibcount, open_ib, 0);
 		ImpedeBlocks(cibcount, closed_ib, pmdflags);
 	}
+	// the fields may lead through the door now, or miss the way it opened
+	area->ClearFlowFields();
 
 	InfoPoint *ip = area->TMap->GetInfoPoint(LinkedInfo);
 	if (ip) {
@@ -168,6 +168,31 @@ bool InfoPoint::TriggerTrap(int skill, ieDword ID)
 	return false;
 }
 
+static void ExtendBounds(Region &bounds, const Point &p, int reach)
+{
+	int x2 = std::max(bounds.x + bounds.w, p.x + reach);
+	int y2 = std::max(bounds.y + bounds.h, p.y + reach);
+	bounds.x = std::min(bounds.x, p.x - reach);
+	bounds.y = std::min(bounds.y, p.y - reach);
+	bounds.w = x2 - bounds.x;
+	bounds.h = y2 - bounds.y;
+}
+
+// covers everything Entered checks below, so it must be kept in sync with it
+Region InfoPoint::EnterBounds(int actorSize) const
+{
+	Region bounds = outline->BBox;
+	int reach = MAX_OPERATING_DISTANCE + actorSize * 10;
+	if (Type == ST_TRAVEL) {
+		ExtendBounds(bounds, TrapLaunch, reach);
+		ExtendBounds(bounds, TalkPos, reach);
+	}
+	if (Flags&TRAP_USEPOINT) {
+		ExtendBounds(bounds, UsePoint, reach);
+	}
+	return bounds;
+}
+
 bool InfoPoint::Entered(Actor *actor)
 {
 	if (outline->PointIn( actor->Pos ) ) {
@@ -34,6 +34,8 @@ public:
 	bool TriggerTrap(int skill, ieDword ID);
 	//call this to check if an actor entered the trigger zone
 	bool Entered(Actor *actor);
+	//actors of this size outside the returned box can't have entered
+	Region EnterBounds(int actorSize) const;
   //returns true if
   ieDword GetUsePoint() const;
 	//checks if the actor may use this travel trigger
@@ -25,6 +25,7 @@
 
 #include "DialogHandler.h"
 #include "DisplayMessage.h"
+#include "FlowField.h"
 #include "Game.h"
 #include "GameData.h"
 #include "Projectile.h"
@@ -2168,6 +2169,38 @@ void Movable::Backoff()
 	}
 }
 
+// When part of a group move, walk around the blocker by stepping to another
+// square that is just as good a way to the goal, instead of waiting
+bool Movable::SidestepAlongFlow()
+{
+	const FlowField *field = area->GetFlowField(Destination, size);
+	if (!field) return false;
+
+	SearchmapPoint smptHere(Pos.x / 16, Pos.y / 12);
+	SearchmapPoint candidates[8];
+	int count = field->Downhill(smptHere, candidates);
+	for (int i = 0; i < count; i++) {
+		Point nmptDetour(candidates[i].x * 16 + 8, candidates[i].y * 12 + 6);
+		if (area->GetActor(nmptDetour, GA_NO_DEAD|GA_NO_UNSCHEDULED)) continue;
+		if (!(area->GetBlockedInRadius(nmptDetour.x, nmptDetour.y, size) & PATH_MAP_PASSABLE)) continue;
+
+		PathNode *detour = new PathNode;
+		detour->x = nmptDetour.x;
+		detour->y = nmptDetour.y;
+		detour->orient = GetOrient(nmptDetour, Pos);
+		detour->Next = step;
+		detour->Parent = step->Parent;
+		if (step->Parent) {
+			step->Parent->Next = detour;
+		} else {
+			path = detour;
+		}
+		step->Parent = detour;
+		step = detour;
+		return true;
+	}
+	return false;
+}
 
 void Movable::BumpAway()
 {
@@ -2270,6 +2303,8 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 			}
 			if (actor && actor->ValidTarget(GA_CAN_BUMP) && actorInTheWay->ValidTarget(GA_ONLY_BUMPABLE)) {
 				actorInTheWay->BumpAway();
+			} else if (SidestepAlongFlow()) {
+				return;
 			} else {
 				Backoff();
 				return;
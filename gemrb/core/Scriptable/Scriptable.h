@@ -483,6 +483,7 @@ public:
 		return randomBackoff;
 	}
 	void Backoff();
+	bool SidestepAlongFlow();
 	inline void DecreaseBackoff()
 	{
 		randomBackoff--;
@@ -40,9 +40,13 @@ public:
 	/**
 	 * Read up to cnt samples into memory
 	 *
+	 * Decoding continues where the previous call stopped, so a stream
+	 * can be consumed in fixed-size chunks through the same buffer;
+	 * implementations must not allocate per call.
+	 *
 	 * @param[out] memory Array to hold samples read.
 	 * @param[in] cnt number of samples to read.
-	 * @returns Number of samples read.
+	 * @returns Number of samples read, less than cnt only at the end.
 	 */
 	virtual int read_samples( short* memory, int cnt ) = 0 ;
 	int get_channels() const
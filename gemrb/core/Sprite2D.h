@@ -81,6 +81,7 @@ public:
 							   ieDword /*bmask*/, ieDword /*amask*/) { return false; }; // not pure virtual!
 	void acquire() { ++RefCount; }
 	void release();
+	bool IsShared() const { return RefCount > 1; }
 
 public:
 	static void FreeSprite(Sprite2D*& spr) {
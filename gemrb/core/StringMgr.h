@@ -70,6 +70,7 @@ public:
 	virtual StringBlock GetStringBlock(ieStrRef strref, unsigned int flags = 0) = 0;
 	virtual ieStrRef UpdateString(ieStrRef strref, const char *text) = 0;
 	virtual bool HasAltTLK() const = 0;
+	virtual ieDword GetStrRefCount() const = 0;
 };
 
 }
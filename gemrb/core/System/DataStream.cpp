@@ -73,6 +73,11 @@ void DataStream::ReadDecrypted(void* buf, unsigned int size)
 		( ( unsigned char * ) buf )[i] ^= GEM_ENCRYPTION_KEY[( Pos + i ) & 63];
 }
 
+const char* DataStream::DataAt(unsigned long /*pos*/) const
+{
+	return NULL;
+}
+
 void DataStream::Rewind()
 {
 	Seek( Encrypted ? 2 : 0, GEM_STREAM_START );
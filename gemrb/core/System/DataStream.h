@@ -63,6 +63,9 @@ public:
 	int WriteDword(const ieDword* src);
 	int WriteResRef(const ieResRef src);
 	virtual int Seek(int pos, int startpos) = 0;
+	/** Returns the contents at pos for reading them in place, or NULL if the
+	 *  stream isn't backed by (unencrypted) memory. See SpanReader. */
+	virtual const char* DataAt(unsigned long pos) const;
 	unsigned long Remains() const;
 	unsigned long Size() const;
 	unsigned long GetPos() const;
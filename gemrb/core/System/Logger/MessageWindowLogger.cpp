@@ -27,7 +27,7 @@ namespace GemRB {
 MessageWindowLogger* mwl = NULL;
 
 MessageWindowLogger::MessageWindowLogger( log_level level)
-	: Logger(level)
+	: Logger(level), guiThread(std::this_thread::get_id())
 {
 	PrintStatus(true);
 }
@@ -41,6 +41,9 @@ MessageWindowLogger::~MessageWindowLogger()
 
 void MessageWindowLogger::LogInternal(log_level level, const char* owner, const char* message, log_color color)
 {
+	if (std::this_thread::get_id() != guiThread) {
+		return;
+	}
 	GameControl* gc = core->GetGameControl();
 	if (displaymsg && gc && !(gc->GetDialogueFlags()&DF_IN_DIALOG)) {
 		// FIXME: we check DF_IN_DIALOG here to avoid recurssion in the MessageWindowLogger, but what happens when an error happens during dialog?
@@ -20,6 +20,8 @@
 
 #include "System/Logger.h" // for log_color
 
+#include <thread>
+
 namespace GemRB {
 
 class GEM_EXPORT MessageWindowLogger : public Logger {
@@ -29,6 +31,9 @@ public:
 protected:
 	void LogInternal(log_level level, const char* owner, const char* message, log_color color);
 private:
+	// the window can only be written to from here, workers log elsewhere
+	std::thread::id guiThread;
+
 	void PrintStatus(bool);
 };
 
@@ -26,14 +26,18 @@
 #else
 #  include <cstdarg>
 #endif
+#include <mutex>
 #include <vector>
 
 namespace GemRB {
 
 static std::vector<Logger*> theLogger;
+// workers log too; recursive, since a logger may itself log
+static std::recursive_mutex LoggerLock;
 
 void ShutdownLogging()
 {
+	std::lock_guard<std::recursive_mutex> guard(LoggerLock);
 	for (size_t i = 0; i < theLogger.size(); ++i) {
 		theLogger[i]->destroy();
 	}
@@ -47,6 +51,7 @@ void InitializeLogging()
 
 void AddLogger(Logger* logger)
 {
+	std::lock_guard<std::recursive_mutex> guard(LoggerLock);
 	if (logger)
 		theLogger.push_back(logger);
 }
@@ -54,6 +59,7 @@ void AddLogger(Logger* logger)
 void RemoveLogger(Logger* logger)
 {
 	if (logger) {
+		std::lock_guard<std::recursive_mutex> guard(LoggerLock);
 		std::vector<Logger*>::iterator itr = theLogger.begin();
 		while (itr != theLogger.end()) {
 			if (*itr == logger) {
@@ -79,6 +85,7 @@ static void vLog(log_level level, const char* owner, const char* message, log_co
 
 	char *buf = new char[len+1];
 	vsnprintf(buf, len + 1, message, ap);
+	std::lock_guard<std::recursive_mutex> guard(LoggerLock);
 	for (size_t i = 0; i < theLogger.size(); ++i) {
 		theLogger[i]->log(level, owner, buf, color);
 	}
@@ -120,6 +127,7 @@ void LogVA(log_level level, const char* owner, const char* message, va_list args
 
 void Log(log_level level, const char* owner, StringBuffer const& buffer)
 {
+	std::lock_guard<std::recursive_mutex> guard(LoggerLock);
 	for (size_t i = 0; i < theLogger.size(); ++i) {
 		theLogger[i]->log(level, owner, buffer.get().c_str(), WHITE);
 	}
@@ -74,6 +74,14 @@ int MemoryStream::Write(const void* src, unsigned int length)
 	return length;
 }
 
+const char* MemoryStream::DataAt(unsigned long pos) const
+{
+	if (!data || Encrypted || pos > size) {
+		return NULL;
+	}
+	return data + pos;
+}
+
 int MemoryStream::Seek(int newpos, int type)
 {
 	switch (type) {
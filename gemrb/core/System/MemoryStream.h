@@ -39,6 +39,7 @@ public:
 	int Read(void* dest, unsigned int length) override;
 	int Write(const void* src, unsigned int length) override;
 	int Seek(int pos, int startpos) override;
+	const char* DataAt(unsigned long pos) const override;
 };
 
 }
@@ -98,6 +98,14 @@ int SlicedStream::Seek(int newpos, int type)
 	return GEM_OK;
 }
 
+const char* SlicedStream::DataAt(unsigned long pos) const
+{
+	if (Encrypted || pos > size) {
+		return NULL;
+	}
+	return str->DataAt(startpos + pos);
+}
+
 DataStream* SliceStream(DataStream* str, unsigned long startpos, unsigned long size, bool preservepos)
 {
 	if (size <= 16384) {
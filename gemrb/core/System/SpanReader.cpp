@@ -0,0 +1,70 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "System/SpanReader.h"
+
+#include "win32def.h"
+#include "errors.h"
+
+#include <ctype.h>
+
+namespace GemRB {
+
+SpanReader::SpanReader(DataStream* stream, unsigned long len)
+	: data(NULL), size(0), pos(0), endianSwitch(DataStream::IsEndianSwitch())
+{
+	if (len > stream->Remains()) {
+		len = stream->Remains();
+	}
+	data = stream->DataAt(stream->GetPos());
+	if (data) {
+		stream->Seek(len, GEM_CURRENT_POS);
+	} else {
+		buffer.resize(len);
+		if (len && stream->Read(&buffer[0], len) == GEM_ERROR) {
+			len = 0;
+		}
+		data = buffer.empty() ? NULL : &buffer[0];
+	}
+	size = len;
+}
+
+int SpanReader::ReadResRef(ieResRef dest)
+{
+	int len = Read(dest, 8);
+	if (len == GEM_ERROR) {
+		return len;
+	}
+	int i;
+	// lowercase the resref
+	for (i = 0; i < 8; i++) {
+		dest[i] = (char) tolower(dest[i]);
+	}
+	// remove trailing spaces
+	for (i = 7; i >= 0; i--) {
+		if (dest[i] == ' ') dest[i] = 0;
+		else break;
+	}
+	// null-terminate
+	dest[8] = 0;
+	return len;
+}
+
+}
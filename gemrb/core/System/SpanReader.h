@@ -0,0 +1,142 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+/**
+ * @file SpanReader.h
+ * Declares SpanReader, a reader for fixed-layout tables of a DataStream.
+ * @author The GemRB Project
+ */
+
+#ifndef SPANREADER_H
+#define SPANREADER_H
+
+#include "errors.h"
+#include "exports.h"
+#include "globals.h"
+
+#include "System/DataStream.h"
+
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * @class SpanReader
+ * Takes the next len bytes of a stream in one go and decodes its fields
+ * without going through the virtual DataStream::Read for each of them.
+ * Memory backed streams are read in place, the rest is copied once.
+ * Reads are bounds checked and behave like those of DataStream: a read
+ * past the end fails with GEM_ERROR and leaves the destination alone.
+ * The reader must not outlive the stream it was made from.
+ */
+
+class GEM_EXPORT SpanReader {
+private:
+	std::vector<char> buffer; // only used if the stream can't be read in place
+	const char* data;
+	unsigned long size;
+	unsigned long pos;
+	bool endianSwitch;
+
+	SpanReader(const SpanReader&);
+	SpanReader& operator=(const SpanReader&);
+
+	const char* Take(unsigned long len)
+	{
+		if (pos + len > size) {
+			return NULL;
+		}
+		const char* src = data + pos;
+		pos += len;
+		return src;
+	}
+
+public:
+	/** Consumes len bytes from the stream, or all that remain if there are fewer */
+	SpanReader(DataStream* stream, unsigned long len);
+
+	unsigned long Size() const { return size; }
+	unsigned long GetPos() const { return pos; }
+	unsigned long Remains() const { return size - pos; }
+
+	int Seek(unsigned long newpos)
+	{
+		if (newpos > size) {
+			return GEM_ERROR;
+		}
+		pos = newpos;
+		return GEM_OK;
+	}
+
+	int Skip(unsigned long len)
+	{
+		return Take(len) ? GEM_OK : GEM_ERROR;
+	}
+
+	int Read(void* dest, unsigned int len)
+	{
+		const char* src = Take(len);
+		if (!src) {
+			return GEM_ERROR;
+		}
+		memcpy(dest, src, len);
+		return len;
+	}
+
+	int ReadWord(ieWord* dest)
+	{
+		const unsigned char* src = (const unsigned char*) Take(2);
+		if (!src) {
+			return GEM_ERROR;
+		}
+		if (endianSwitch) {
+			// the data is little endian, build the value explicitly
+			*dest = (ieWord) (src[0] | (src[1] << 8));
+		} else {
+			memcpy(dest, src, 2);
+		}
+		return 2;
+	}
+
+	int ReadWordSigned(ieWordSigned* dest)
+	{
+		return ReadWord((ieWord*) dest);
+	}
+
+	int ReadDword(ieDword* dest)
+	{
+		const unsigned char* src = (const unsigned char*) Take(4);
+		if (!src) {
+			return GEM_ERROR;
+		}
+		if (endianSwitch) {
+			*dest = src[0] | ((ieDword) src[1] << 8) | ((ieDword) src[2] << 16) | ((ieDword) src[3] << 24);
+		} else {
+			memcpy(dest, src, 4);
+		}
+		return 4;
+	}
+
+	int ReadResRef(ieResRef dest);
+};
+
+}
+
+#endif
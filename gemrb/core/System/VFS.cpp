@@ -555,7 +555,11 @@ void* readonly_mmap(void *vfd) {
 	int ret = fstat(fd, &statData);
 	assert(ret != -1);
 
-	return mmap(nullptr, statData.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	void *start = mmap(nullptr, statData.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (start == MAP_FAILED) {
+		return nullptr;
+	}
+	return start;
 }
 
 #endif
@@ -0,0 +1,95 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "System/WorkerPool.h"
+
+namespace GemRB {
+
+bool WorkerPool::Serial = false;
+
+WorkerPool::WorkerPool(int count)
+	: running(0), quit(false)
+{
+	if (count <= 0) {
+		count = DefaultThreads();
+	}
+	for (int i = 0; i < count; i++) {
+		threads.push_back(std::thread(&WorkerPool::Run, this));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+		jobs.clear();
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+}
+
+int WorkerPool::DefaultThreads()
+{
+	// leave a core to the main thread, but never use more than a couple
+	int cores = std::thread::hardware_concurrency();
+	if (cores <= 2) return 1;
+	return cores > 3 ? 2 : cores - 1;
+}
+
+void WorkerPool::Post(Job job)
+{
+	if (Serial) {
+		job();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		jobs.push_back(std::move(job));
+	}
+	wake.notify_one();
+}
+
+size_t WorkerPool::Pending()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return jobs.size() + running;
+}
+
+void WorkerPool::Run()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	while (true) {
+		wake.wait(guard, [this] { return quit || !jobs.empty(); });
+		if (quit) break;
+
+		Job job = std::move(jobs.front());
+		jobs.pop_front();
+		running++;
+		guard.unlock();
+		job();
+		guard.lock();
+		running--;
+	}
+}
+
+}
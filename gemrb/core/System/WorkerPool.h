@@ -0,0 +1,73 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include "exports.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * @class WorkerPool
+ * A few threads running jobs that would otherwise stall a frame.
+ * Jobs run in the order they were posted, and it is up to them to hand
+ * their results back to the main thread; the pool only runs them.
+ * Queued jobs that have not started are dropped on destruction.
+ */
+
+class GEM_EXPORT WorkerPool {
+public:
+	typedef std::function<void()> Job;
+
+	explicit WorkerPool(int threads = 0);
+	~WorkerPool();
+
+	void Post(Job job);
+	/** jobs still queued or running */
+	size_t Pending();
+	/** a sensible thread count for background loading on this machine */
+	static int DefaultThreads();
+
+	/** runs every job right away in Post instead, to check the threaded
+	 * loading against the serial one */
+	static bool Serial;
+
+private:
+	void Run();
+
+	std::vector<std::thread> threads;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::deque<Job> jobs;
+	size_t running;
+	bool quit;
+};
+
+}
+
+#endif
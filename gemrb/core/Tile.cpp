@@ -20,13 +20,21 @@
 
 #include "Tile.h"
 
+#include "Animation.h"
+#include "Game.h"
+#include "Interface.h"
+
 namespace GemRB {
 
-Tile::Tile(Animation* anim, Animation* sec)
+Tile::Tile(const ieWord* indexes, int count, const ieWord* secondary)
+	: frames(indexes, indexes + count)
 {
 	tileIndex = om = 0;
-	this->anim[0] = anim;
-	this->anim[1] = sec;
+	fps = ANI_DEFAULT_FRAMERATE;
+	this->secondary = secondary ? *secondary : -1;
+	//the turning crystal in ar3202 (bg1) requires animations to be synced
+	pos = 0;
+	starttime = 0;
 	memset(SearchMap, 0, sizeof(SearchMap));
 	memset(HeightMap, 0, sizeof(HeightMap));
 	memset(LightMap, 0, sizeof(LightMap));
@@ -35,8 +43,35 @@ Tile::Tile(Animation* anim, Animation* sec)
 
 Tile::~Tile(void)
 {
-	delete( anim[0] );
-	delete( anim[1] );
+}
+
+// the same timing as Animation::NextFrame for looping game animations
+int Tile::NextFrame(int which)
+{
+	if (which && secondary >= 0) {
+		return secondary;
+	}
+	if (frames.empty()) {
+		return -1;
+	}
+
+	//pause key stops animation
+	unsigned long time = core->GetGame()->Ticks;
+	if (starttime == 0) {
+		starttime = time;
+	}
+	int ret = frames[pos];
+
+	//it could be that we skip more than one frame in case of slow rendering
+	if (( time - starttime ) >= ( unsigned long ) ( 1000 / fps )) {
+		int inc = (time-starttime)*fps/1000;
+		pos += inc;
+		starttime += inc*1000/fps;
+	}
+	if (pos >= frames.size()) {
+		pos = pos % frames.size();
+	}
+	return ret;
 }
 
 }
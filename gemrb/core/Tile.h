@@ -23,22 +23,39 @@
 
 #include "RGBAColor.h"
 #include "exports.h"
+#include "globals.h"
 
-#include "Animation.h"
+#include <vector>
 
 namespace GemRB {
 
+/**
+ * @class Tile
+ * A cell of a TileOverlay. It only knows which TIS tiles to show and
+ * when, the overlay decodes them on first draw.
+ */
+
 class GEM_EXPORT Tile {
 public:
-	Tile(Animation* anim, Animation* sec = NULL);
+	Tile(const ieWord* indexes, int count, const ieWord* secondary = NULL);
 	~Tile(void);
 	unsigned char tileIndex;
 	unsigned char om;
+	unsigned char fps;
 	Color SearchMap[16];
 	Color HeightMap[16];
 	Color LightMap[16];
 	Color NLightMap[16];
-	Animation* anim[2];
+
+	/** the TIS index to draw now, advancing the animation
+	 * which is 1 for the secondary (door) tile, if there is one */
+	int NextFrame(int which);
+	bool HasSecondary() const { return secondary >= 0; }
+private:
+	std::vector<ieWord> frames;
+	int secondary;
+	unsigned int pos;
+	unsigned long starttime;
 };
 
 }
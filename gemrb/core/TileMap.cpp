@@ -34,6 +34,7 @@ TileMap::TileMap(void)
 	XCellCount = 0;
 	YCellCount = 0;
 	LargeMap = !core->HasFeature(GF_SMALL_FOG);
+	gridsDirty = true;
 }
 
 TileMap::~TileMap(void)
@@ -72,6 +73,37 @@ void TileMap::ClearOverlays()
 	rain_overlays.clear();
 }
 
+// doors are indexed by both of their outlines, so opening and closing
+// them doesn't need an update; the lookups check the current one
+void TileMap::UpdateGrids() const
+{
+	if (!gridsDirty) {
+		return;
+	}
+	gridsDirty = false;
+
+	Point size = GetMapSize();
+	doorGrid.Reset(size);
+	for (size_t i = 0; i < doors.size(); i++) {
+		const Region& o = doors[i]->open->BBox;
+		const Region& c = doors[i]->closed->BBox;
+		Region bbox;
+		bbox.x = std::min(o.x, c.x);
+		bbox.y = std::min(o.y, c.y);
+		bbox.w = std::max(o.x + o.w, c.x + c.w) - bbox.x;
+		bbox.h = std::max(o.y + o.h, c.y + c.h) - bbox.y;
+		doorGrid.Insert(doors[i], bbox);
+	}
+	containerGrid.Reset(size);
+	for (size_t i = 0; i < containers.size(); i++) {
+		containerGrid.Insert(containers[i], containers[i]->outline->BBox);
+	}
+	infoPointGrid.Reset(size);
+	for (size_t i = 0; i < infoPoints.size(); i++) {
+		infoPointGrid.Insert(infoPoints[i], infoPoints[i]->outline->BBox);
+	}
+}
+
 //tiled objects
 TileObject* TileMap::AddTile(const char *ID, const char* Name, unsigned int Flags,
 	unsigned short* openindices, int opencount, unsigned short* closeindices, int closecount)
@@ -108,6 +140,7 @@ Door* TileMap::AddDoor(const char *ID, const char* Name, unsigned int Flags,
 	door->SetName( ID );
 	door->SetScriptName( Name );
 	doors.push_back( door );
+	gridsDirty = true;
 	return door;
 }
 
@@ -121,10 +154,10 @@ Door* TileMap::GetDoor(unsigned int idx) const
 
 Door* TileMap::GetDoor(const Point &p) const
 {
-	for (size_t i = 0; i < doors.size(); i++) {
+	UpdateGrids();
+	for (Door* door : doorGrid.Lookup(p)) {
 		Gem_Polygon *doorpoly;
 
-		Door* door = doors[i];
 		if (door->Flags&DOOR_HIDDEN) {
 			continue;
 		}
@@ -195,6 +228,7 @@ void TileMap::AddOverlay(TileOverlay* overlay)
 		}
 	}
 	overlays.push_back( overlay );
+	gridsDirty = true;
 }
 
 void TileMap::AddRainOverlay(TileOverlay* overlay)
@@ -419,6 +453,7 @@ void TileMap::DrawFogOfWar(ieByte* explored_mask, ieByte* visible_mask, Region v
 void TileMap::AddContainer(Container *c)
 {
 	containers.push_back(c);
+	gridsDirty = true;
 }
 
 Container* TileMap::GetContainer(unsigned int idx) const
@@ -444,8 +479,8 @@ Container* TileMap::GetContainer(const char* Name) const
 //in this case, empty piles won't be found!
 Container* TileMap::GetContainer(const Point &position, int type) const
 {
-	for (size_t i = 0; i < containers.size(); i++) {
-		Container* c = containers[i];
+	UpdateGrids();
+	for (Container* c : containerGrid.Lookup(position)) {
 		if (type!=-1) {
 			if (c->Type!=type) {
 				continue;
@@ -513,6 +548,7 @@ int TileMap::CleanupContainer(Container *container)
 	for (size_t i = 0; i < containers.size(); i++) {
 		if (containers[i]==container) {
 			containers.erase(containers.begin()+i);
+			gridsDirty = true;
 			delete container;
 			return 1;
 		}
@@ -548,14 +584,15 @@ InfoPoint* TileMap::AddInfoPoint(const char* Name, unsigned short Type,
 	ip->outline = outline;
 	//ip->Active = true; //set active on creation
 	infoPoints.push_back( ip );
+	gridsDirty = true;
 	return ip;
 }
 
 //if detectable is set, then only detectable infopoints will be returned
 InfoPoint* TileMap::GetInfoPoint(const Point &p, bool detectable) const
 {
-	for (size_t i = 0; i < infoPoints.size(); i++) {
-		InfoPoint* ip = infoPoints[i];
+	UpdateGrids();
+	for (InfoPoint* ip : infoPointGrid.Lookup(p)) {
 		//these flags disable any kind of user interaction
 		//scripts can still access an infopoint by name
 		if (ip->Flags&(INFO_DOOR|TRAP_DEACTIVATED) )
@@ -647,7 +684,7 @@ InfoPoint *TileMap::AdjustNearestTravel(Point &p)
 	return best;
 }
 
-Point TileMap::GetMapSize()
+Point TileMap::GetMapSize() const
 {
 	return Point((short) (XCellCount*64), (short) (YCellCount*64));
 }
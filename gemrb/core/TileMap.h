@@ -24,6 +24,7 @@
 #include "exports.h"
 
 #include "Polygon.h"
+#include "RegionGrid.h"
 #include "TileOverlay.h"
 
 namespace GemRB {
@@ -45,6 +46,13 @@ private:
 	std::vector< InfoPoint*> infoPoints;
 	std::vector< TileObject*> tiles;
 	bool LargeMap;
+
+	// spatial indices of the click targets, rebuilt when they were changed
+	mutable RegionGrid<Door*> doorGrid;
+	mutable RegionGrid<Container*> containerGrid;
+	mutable RegionGrid<InfoPoint*> infoPointGrid;
+	mutable bool gridsDirty;
+	void UpdateGrids() const;
 public:
 	TileMap(void);
 	~TileMap(void);
@@ -94,7 +102,7 @@ public:
 	void AddRainOverlay(TileOverlay* overlay);
 	void DrawOverlays(Region screen, int rain, int flags);
 	void DrawFogOfWar(ieByte* explored_mask, ieByte* visible_mask, Region viewport);
-	Point GetMapSize();
+	Point GetMapSize() const;
 public:
 	int XCellCount, YCellCount;
 };
@@ -23,18 +23,32 @@
 //#include "Game.h" // needed only for TILE_GREY below
 #include "GlobalTimer.h"
 #include "Interface.h"
+#include "Sprite2D.h"
 #include "Video.h"
 
+#include <algorithm>
+
 namespace GemRB {
 
 bool RedrawTile = false;
 
-TileOverlay::TileOverlay(int Width, int Height)
+// what a decoded tile costs: the pixels and the palette copy of the surface
+#define TILE_BYTES (64 * 64 + 256 * 4)
+
+// decoded tiles of all the overlays, see SetCacheSize
+static size_t tileBudget = 16384 * 1024;
+static size_t tileBytes = 0;
+static unsigned long tileClock = 0;
+static std::vector<TileOverlay*> liveOverlays;
+
+TileOverlay::TileOverlay(int Width, int Height, const Holder<TileSetMgr>& tileset)
+	: tileset(tileset)
 {
 	w = Width;
 	h = Height;
 	count = 0;
 	tiles = ( Tile * * ) malloc( w * h * sizeof( Tile * ) );
+	liveOverlays.push_back(this);
 }
 
 TileOverlay::~TileOverlay(void)
@@ -43,6 +57,84 @@ TileOverlay::~TileOverlay(void)
 		delete( tiles[i] );
 	}
 	free( tiles );
+	for (size_t i = 0; i < decoded.size(); i++) {
+		if (decoded[i].sprite) {
+			Sprite2D::FreeSprite(decoded[i].sprite);
+			tileBytes -= TILE_BYTES;
+		}
+	}
+	liveOverlays.erase(std::find(liveOverlays.begin(), liveOverlays.end(), this));
+}
+
+void TileOverlay::SetCacheSize(int kilobytes)
+{
+	tileBudget = std::max(kilobytes, 0) * 1024;
+}
+
+int TileOverlay::GetCacheSize()
+{
+	return (int) (tileBudget / 1024);
+}
+
+const Sprite2D* TileOverlay::GetDecodedTile(int index) const
+{
+	if (index < 0 || (size_t) index >= decoded.size()) {
+		return NULL;
+	}
+	return decoded[index].sprite;
+}
+
+Sprite2D* TileOverlay::GetTileSprite(int index)
+{
+	if (index < 0) {
+		return NULL;
+	}
+	if ((size_t) index >= decoded.size()) {
+		DecodedTile none = { NULL, 0 };
+		decoded.resize(index + 1, none);
+	}
+	DecodedTile& tile = decoded[index];
+	if (!tile.sprite) {
+		tile.sprite = tileset->GetTile(index);
+		tileBytes += TILE_BYTES;
+	}
+	tile.lastUse = ++tileClock;
+	return tile.sprite;
+}
+
+// drops decoded tiles of any overlay, least recently drawn first, until there
+// is some room below the budget again; the ones drawn since keepSince stay
+void TileOverlay::ReclaimTiles(unsigned long keepSince)
+{
+	if (!tileBudget || tileBytes <= tileBudget) {
+		return;
+	}
+
+	struct Candidate {
+		unsigned long lastUse;
+		TileOverlay* overlay;
+		size_t index;
+	};
+	std::vector<Candidate> unused;
+	for (size_t o = 0; o < liveOverlays.size(); o++) {
+		TileOverlay* ov = liveOverlays[o];
+		for (size_t i = 0; i < ov->decoded.size(); i++) {
+			const DecodedTile& tile = ov->decoded[i];
+			if (tile.sprite && tile.lastUse < keepSince) {
+				Candidate c = { tile.lastUse, ov, i };
+				unused.push_back(c);
+			}
+		}
+	}
+	std::sort(unused.begin(), unused.end(), [](const Candidate& a, const Candidate& b) {
+		return a.lastUse < b.lastUse;
+	});
+	size_t target = tileBudget / 4 * 3;
+	for (size_t i = 0; i < unused.size() && tileBytes > target; i++) {
+		DecodedTile& tile = unused[i].overlay->decoded[unused[i].index];
+		Sprite2D::FreeSprite(tile.sprite);
+		tileBytes -= TILE_BYTES;
+	}
 }
 
 void TileOverlay::AddTile(Tile* tile)
@@ -92,17 +184,17 @@ void TileOverlay::Draw(Region viewport, std::vector< TileOverlay*> &overlays, in
 	int dx = ( vp.x + vp.w + 63 ) / 64;
 	int dy = ( vp.y + vp.h + 63 ) / 64;
 
+	unsigned long drawStart = tileClock + 1;
 	for (int y = sy; y < dy && y < h; y++) {
 		for (int x = sx; x < dx && x < w; x++) {
 			Tile* tile = tiles[( y* w ) + x];
 
 			//draw door tiles if there are any
-			Animation* anim = tile->anim[tile->tileIndex];
-			if (!anim && tile->tileIndex) {
-				anim = tile->anim[0];
+			Sprite2D* spr = GetTileSprite(tile->NextFrame(tile->tileIndex));
+			if (!spr) {
+				continue;
 			}
-			assert(anim);
-			vid->BlitTile( anim->NextFrame(), 0, viewport.x + ( x * 64 ),
+			vid->BlitTile( spr, 0, viewport.x + ( x * 64 ),
 				viewport.y + ( y * 64 ), &viewport, flags );
 			if (!tile->om || tile->tileIndex) {
 				continue;
@@ -116,16 +208,16 @@ void TileOverlay::Draw(Region viewport, std::vector< TileOverlay*> &overlays, in
 					Tile *ovtile = ov->tiles[0]; //allow only 1x1 tiles now
 					if (tile->om & mask) {
 						if (RedrawTile) {
-							vid->BlitTile( ovtile->anim[0]->NextFrame(),
-						                   tile->anim[0]->NextFrame(),
+							vid->BlitTile( ov->GetTileSprite(ovtile->NextFrame(0)),
+						                   GetTileSprite(tile->NextFrame(0)),
 							               viewport.x + ( x * 64 ),
 							               viewport.y + ( y * 64 ),
 							               &viewport, flags );
 						} else {
 							Sprite2D* mask = 0;
-							if (tile->anim[1])
-								mask = tile->anim[1]->NextFrame();
-							vid->BlitTile( ovtile->anim[0]->NextFrame(),
+							if (tile->HasSecondary())
+								mask = GetTileSprite(tile->NextFrame(1));
+							vid->BlitTile( ov->GetTileSprite(ovtile->NextFrame(0)),
 						                   mask,
 							               viewport.x + ( x * 64 ),
 							               viewport.y + ( y * 64 ),
@@ -137,6 +229,9 @@ void TileOverlay::Draw(Region viewport, std::vector< TileOverlay*> &overlays, in
 			}
 		}
 	}
+
+	// only now, the tiles blitted above had to stay around until here
+	ReclaimTiles(drawStart);
 }
 
 }
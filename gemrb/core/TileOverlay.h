@@ -23,14 +23,26 @@
 
 #include "exports.h"
 
+#include "Holder.h"
+#include "Region.h"
 #include "Tile.h"
+#include "TileSetMgr.h"
 
 #include <vector>
 
 namespace GemRB {
 
+class Sprite2D;
+
 extern bool RedrawTile;
 
+/**
+ * @class TileOverlay
+ * A grid of tiles from one TIS. They are decoded when first drawn and
+ * dropped again, least recently drawn first, once all overlays together
+ * hold more than the budget set with SetCacheSize.
+ */
+
 class GEM_EXPORT TileOverlay {
 public:
 	int w, h;
@@ -38,11 +50,28 @@ public:
 	Tile** tiles;
 	int count;
 public:
-	TileOverlay(int Width, int Height);
+	TileOverlay(int Width, int Height, const Holder<TileSetMgr>& tileset);
 	~TileOverlay(void);
 	void AddTile(Tile* tile);
 	void Draw(Region viewport, std::vector< TileOverlay*> &overlays, int flags);
 	void BumpViewport(const Region &viewport, Region &vp);
+	/** the sprite of a TIS tile if it is decoded right now, NULL otherwise */
+	const Sprite2D* GetDecodedTile(int index) const;
+	/** the decoded tile budget of all overlays, in kilobytes */
+	static void SetCacheSize(int kilobytes);
+	static int GetCacheSize();
+private:
+	struct DecodedTile {
+		Sprite2D* sprite;
+		unsigned long lastUse;
+	};
+
+	Holder<TileSetMgr> tileset;
+	// by TIS index
+	std::vector<DecodedTile> decoded;
+
+	Sprite2D* GetTileSprite(int index);
+	static void ReclaimTiles(unsigned long keepSince);
 };
 
 }
@@ -27,13 +27,17 @@
 
 namespace GemRB {
 
+class Sprite2D;
+
 class GEM_EXPORT TileSetMgr : public Plugin {
 public:
 	TileSetMgr(void);
 	virtual ~TileSetMgr(void);
 	virtual bool Open(DataStream* stream) = 0;
-	virtual Tile* GetTile(unsigned short* indexes, int count,
-		unsigned short* secondary = NULL) = 0;
+	/** decodes a single 64x64 tile, the stream stays open for more */
+	virtual Sprite2D* GetTile(int index) = 0;
+	/** how many tiles the stream really holds */
+	virtual int GetTileCount() = 0;
 };
 
 }
@@ -26,6 +26,7 @@
 #include "Palette.h"
 #include "Sprite2D.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace GemRB {
@@ -56,6 +57,8 @@ Video::Video(void)
 	fullscreen = false;
 	subtitlefont = NULL;
 	subtitlepal = NULL;
+	drawingOverlay = false;
+	drawDirtyRegions = core->DrawDirtyRegions;
 }
 
 Region Video::ClippedDrawingRect(const Region& target, const Region* clip) const
@@ -81,6 +84,65 @@ void Video::SetScreenClip(const Region* clip)
 	}
 }
 
+// past this many separate regions presenting their bounding box is cheaper
+#define MAX_DIRTY_REGIONS 16
+
+static Region RegionUnion(const Region& a, const Region& b)
+{
+	int right = std::max(a.x + a.w, b.x + b.w);
+	int bottom = std::max(a.y + a.h, b.y + b.h);
+	Region r;
+	r.x = std::min(a.x, b.x);
+	r.y = std::min(a.y, b.y);
+	r.w = right - r.x;
+	r.h = bottom - r.y;
+	return r;
+}
+
+void Video::AddDirtyRegion(std::vector<Region>& regions, const Region& rgn)
+{
+	Region r = rgn;
+	// swallow everything we touch, which can make the result touch more
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		std::vector<Region>::iterator it = regions.begin();
+		while (it != regions.end()) {
+			if (!it->IntersectsRegion(r)) {
+				++it;
+				continue;
+			}
+			r = RegionUnion(r, *it);
+			it = regions.erase(it);
+			merged = true;
+		}
+	}
+	regions.push_back(r);
+
+	if (regions.size() > MAX_DIRTY_REGIONS) {
+		Region bounds = regions[0];
+		for (size_t i = 1; i < regions.size(); i++) {
+			bounds = RegionUnion(bounds, regions[i]);
+		}
+		regions.assign(1, bounds);
+	}
+}
+
+void Video::InvalidateRegion(const Region& rgn)
+{
+	Region r = rgn.Intersect(Region(0, 0, width, height));
+	if (r.Dimensions().IsEmpty()) {
+		return;
+	}
+	AddDirtyRegion(drawingOverlay ? overlayRegions : dirtyRegions, r);
+}
+
+void Video::InvalidateAll()
+{
+	std::vector<Region>& regions = drawingOverlay ? overlayRegions : dirtyRegions;
+	regions.assign(1, Region(0, 0, width, height));
+}
+
 bool Video::ToggleFullscreenMode()
 {
 	return SetFullscreenMode(!fullscreen);
@@ -215,6 +277,13 @@ bool Video::GetFullscreenMode() const
 	return fullscreen;
 }
 
+void Video::DrawEllipses(const std::vector<VideoEllipse>& ellipses, bool clipped)
+{
+	for (const VideoEllipse& ellipse : ellipses) {
+		DrawEllipse(ellipse.center.x, ellipse.center.y, ellipse.xr, ellipse.yr, ellipse.color, clipped);
+	}
+}
+
 void Video::BlitTiled(Region rgn, const Sprite2D* img, bool anchor)
 {
 	int xrep = ( rgn.w + img->Width - 1 ) / img->Width;
@@ -398,7 +467,7 @@ void Video::AddPolygonToSpriteCover(SpriteCover* sc, Wall_Polygon* poly)
 	int xoff = sc->worldx - sc->XPos;
 	int yoff = sc->worldy - sc->YPos;
 	
-	std::list<Trapezoid>::iterator iter;
+	std::vector<Trapezoid>::iterator iter;
 	for (iter = poly->trapezoids.begin(); iter != poly->trapezoids.end();
 		 ++iter)
 	{
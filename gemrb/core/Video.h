@@ -33,6 +33,8 @@
 #include "Polygon.h"
 #include "ScriptedAnimation.h"
 
+#include <vector>
+
 namespace GemRB {
 
 class EventMgr;
@@ -40,6 +42,13 @@ class Font;
 class Palette;
 class SpriteCover;
 
+/** one of a batch of ellipses for Video::DrawEllipses */
+struct VideoEllipse {
+	Point center;
+	unsigned short xr, yr;
+	Color color;
+};
+
 // Note: not all these flags make sense together. Specifically:
 // NOSHADOW overrides TRANSSHADOW, and BLIT_GREY overrides BLIT_SEPIA
 enum SpriteBlitFlags {
@@ -101,6 +110,13 @@ protected:
 	CursorType CursorIndex;
 	Point CursorPos;
 
+	/** screen regions changed since the last SwapBuffers */
+	std::vector<Region> dirtyRegions;
+	/** screen regions the cursor, tooltip and debug overlay were drawn over */
+	std::vector<Region> overlayRegions;
+	bool drawingOverlay;
+	bool drawDirtyRegions;
+
 	unsigned char Gamma10toGamma22[256];
 	unsigned char Gamma22toGamma10[256];
 	//subtitle specific variables
@@ -110,6 +126,8 @@ protected:
 	Color fadeColor;
 protected:
 	Region ClippedDrawingRect(const Region& target, const Region* clip = NULL) const;
+	/** merges rgn into regions, so the list stays short */
+	static void AddDirtyRegion(std::vector<Region>& regions, const Region& rgn);
 public:
 	Video(void);
 	virtual ~Video(void) {};
@@ -172,6 +190,8 @@ public:
 	/** Draws an ellipse */
 	virtual void DrawEllipse(short cx, short cy, unsigned short xr,
 		unsigned short yr, const Color& color, bool clipped = true) = 0;
+	/** Draws a batch of ellipses, the same as DrawEllipse on each */
+	virtual void DrawEllipses(const std::vector<VideoEllipse>& ellipses, bool clipped = true);
 	/** Draws a polygon on the screen */
 	virtual void DrawPolyline(Gem_Polygon* poly, const Color& color,
 		bool fill = false) = 0;
@@ -248,6 +268,14 @@ public:
 	void SetViewport(int x, int y, unsigned int w, unsigned int h);
 	void MoveViewportTo(int x, int y);
 
+	/** Marks a screen region as changed, only changed regions are presented by SwapBuffers.
+	 * Drawing done outside of windows and controls has to be reported here. */
+	void InvalidateRegion(const Region& rgn);
+	/** Marks the whole screen as changed */
+	void InvalidateAll();
+	/** Outlines the changed regions when presenting them, for debugging redraws */
+	void SetDrawDirtyRegions(bool draw) { drawDirtyRegions = draw; }
+
 	virtual void DrawBackgroundBuffer() = 0;
 	virtual void FreeBackgroundBuffer() = 0;
 	virtual void TakeBackgroundBuffer() = 0;
@@ -102,11 +102,18 @@ int ACMReader::read_samples(short* buffer, int count)
 			if (!make_new_samples())
 				break;
 		}
-		*buffer = ( short ) ( ( *values ) >> levels );
-		values++;
-		buffer++;
-		res += 1;
-		samples_ready--;
+		// copy as much of the decoded block as the caller has room for
+		int run = count - res;
+		if (run > samples_ready) {
+			run = samples_ready;
+		}
+		for (int i = 0; i < run; i++) {
+			buffer[i] = ( short ) ( values[i] >> levels );
+		}
+		values += run;
+		buffer += run;
+		res += run;
+		samples_ready -= run;
 	}
 	return res;
 }
@@ -22,9 +22,106 @@
 
 #include <cstdlib>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ACM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Rows 0 and 1 of a block whose row count is not a multiple of four:
+//   b0 = d0 + 2*d1 + r0, b1 = 2*r0 - d1 - r1
+// d0 and d1 are the two previous rows, which become r0 and r1.
+static void pair_step(int* d0, int* d1, int* b0, int* b1, int count)
+{
+	int i = 0;
+#ifdef ACM_SSE2
+	for (; i + 4 <= count; i += 4) {
+		__m128i m0 = _mm_loadu_si128((const __m128i *) (d0 + i));
+		__m128i m1 = _mm_loadu_si128((const __m128i *) (d1 + i));
+		__m128i r0 = _mm_loadu_si128((const __m128i *) (b0 + i));
+		__m128i r1 = _mm_loadu_si128((const __m128i *) (b1 + i));
+		__m128i o0 = _mm_add_epi32(_mm_add_epi32(m0, _mm_slli_epi32(m1, 1)), r0);
+		__m128i o1 = _mm_sub_epi32(_mm_sub_epi32(_mm_slli_epi32(r0, 1), m1), r1);
+		_mm_storeu_si128((__m128i *) (b0 + i), o0);
+		_mm_storeu_si128((__m128i *) (b1 + i), o1);
+		_mm_storeu_si128((__m128i *) (d0 + i), r0);
+		_mm_storeu_si128((__m128i *) (d1 + i), r1);
+	}
+#endif
+	for (; i < count; i++) {
+		int row_0 = b0[i], row_1 = b1[i];
+		b0[i] = d0[i] + 2 * d1[i] + row_0;
+		b1[i] = -d1[i] + 2 * row_0 - row_1;
+		d0[i] = row_0;
+		d1[i] = row_1;
+	}
+}
+
+// Four consecutive rows, sb_size apart; the last two become the new d0 and d1.
+static void quad_step(int* d0, int* d1, int* buffer, int sb_size, int count)
+{
+	int* b0 = buffer, * b1 = b0 + sb_size, * b2 = b1 + sb_size, * b3 = b2 + sb_size;
+	int i = 0;
+#ifdef ACM_SSE2
+	for (; i + 4 <= count; i += 4) {
+		__m128i m0 = _mm_loadu_si128((const __m128i *) (d0 + i));
+		__m128i m1 = _mm_loadu_si128((const __m128i *) (d1 + i));
+		__m128i r0 = _mm_loadu_si128((const __m128i *) (b0 + i));
+		__m128i r1 = _mm_loadu_si128((const __m128i *) (b1 + i));
+		__m128i r2 = _mm_loadu_si128((const __m128i *) (b2 + i));
+		__m128i r3 = _mm_loadu_si128((const __m128i *) (b3 + i));
+		__m128i o0 = _mm_add_epi32(_mm_add_epi32(m0, _mm_slli_epi32(m1, 1)), r0);
+		__m128i o1 = _mm_sub_epi32(_mm_sub_epi32(_mm_slli_epi32(r0, 1), m1), r1);
+		__m128i o2 = _mm_add_epi32(_mm_add_epi32(r0, _mm_slli_epi32(r1, 1)), r2);
+		__m128i o3 = _mm_sub_epi32(_mm_sub_epi32(_mm_slli_epi32(r2, 1), r1), r3);
+		_mm_storeu_si128((__m128i *) (b0 + i), o0);
+		_mm_storeu_si128((__m128i *) (b1 + i), o1);
+		_mm_storeu_si128((__m128i *) (b2 + i), o2);
+		_mm_storeu_si128((__m128i *) (b3 + i), o3);
+		_mm_storeu_si128((__m128i *) (d0 + i), r2);
+		_mm_storeu_si128((__m128i *) (d1 + i), r3);
+	}
+#endif
+	for (; i < count; i++) {
+		int row_0 = b0[i], row_1 = b1[i], row_2 = b2[i], row_3 = b3[i];
+		b0[i] = d0[i] + 2 * d1[i] + row_0;
+		b1[i] = -d1[i] + 2 * row_0 - row_1;
+		b2[i] = row_0 + 2 * row_1 + row_2;
+		b3[i] = -row_1 + 2 * row_2 - row_3;
+		d0[i] = row_2;
+		d1[i] = row_3;
+	}
+}
+
+// The same as above, for a single column of all the rows.
+static void pair_and_quads(int* d0, int* d1, int* buff_ptr, int sb_size, int blocks)
+{
+	int row_0, row_1, row_2, row_3, db_0 = *d0, db_1 = *d1;
+	if (( blocks >> 1 ) & 1) {
+		row_0 = buff_ptr[0];
+		row_1 = buff_ptr[sb_size];
+		buff_ptr[0] = db_0 + 2 * db_1 + row_0;
+		buff_ptr[sb_size] = -db_1 + 2 * row_0 - row_1;
+		buff_ptr += sb_size * 2;
+		db_0 = row_0;
+		db_1 = row_1;
+	}
+	for (int j = 0; j < blocks >> 2; j++) {
+		row_0 = buff_ptr[0];  buff_ptr[0] = db_0 + 2 * db_1 + row_0;  buff_ptr += sb_size;
+		row_1 = buff_ptr[0];  buff_ptr[0] = -db_1 + 2 * row_0 - row_1;  buff_ptr += sb_size;
+		row_2 = buff_ptr[0];  buff_ptr[0] = row_0 + 2 * row_1 + row_2;  buff_ptr += sb_size;
+		row_3 = buff_ptr[0];  buff_ptr[0] = -row_1 + 2 * row_2 - row_3;  buff_ptr += sb_size;
+		db_0 = row_2;
+		db_1 = row_3;
+	}
+	*d0 = db_0;
+	*d1 = db_1;
+}
+
 int CSubbandDecoder::init_decoder()
 {
-	int memory_size = ( levels == 0 ) ? 0 : ( 3 * ( block_size >> 1 ) - 2 );
+	// two rows of state for every level: block_size for the first one,
+	// block_size - 2 for all the smaller ones together
+	int memory_size = ( levels == 0 ) ? 0 : ( 2 * block_size - 2 );
 	if (memory_size) {
 		memory_buffer = ( int * ) calloc( memory_size, sizeof( int ) );
 		if (!memory_buffer)
@@ -42,8 +139,8 @@ void CSubbandDecoder::decode_data(int* buffer, int blocks)
 	int sb_size = block_size >> 1; // current subband size
 
 	blocks <<= 1;
-	sub_4d3fcc( ( short * ) mem_ptr, buff_ptr, sb_size, blocks );
-	mem_ptr += sb_size;
+	sub_4d3fcc( mem_ptr, buff_ptr, sb_size, blocks );
+	mem_ptr += sb_size << 1;
 
 	for (int i = 0; i < blocks; i++)
 		buff_ptr[i * sb_size]++;
@@ -58,120 +155,32 @@ void CSubbandDecoder::decode_data(int* buffer, int blocks)
 		blocks <<= 1;
 	}
 }
-void CSubbandDecoder::sub_4d3fcc(short* memory, int* buffer, int sb_size,
+void CSubbandDecoder::sub_4d3fcc(int* memory, int* buffer, int sb_size,
 	int blocks)
 {
-	int row_0, row_1, row_2 = 0, row_3 = 0, db_0, db_1;
-	int i;
-	int sb_size_2 = sb_size * 2, sb_size_3 = sb_size * 3;
-	if (blocks == 2) {
-		for (i = 0; i < sb_size; i++) {
-			row_0 = buffer[0];
-			row_1 = buffer[sb_size];
-			buffer[0] = buffer[0] + memory[0] + 2 * memory[1];
-			buffer[sb_size] = 2 * row_0 - memory[1] - buffer[sb_size];
-			memory[0] = ( short ) row_0;
-			memory[1] = ( short ) row_1;
-
-			memory += 2;
-			buffer++;
-		}
-	} else if (blocks == 4) {
-		for (i = 0; i < sb_size; i++) {
-			row_0 = buffer[0];
-			row_1 = buffer[sb_size];
-			row_2 = buffer[sb_size_2];
-			row_3 = buffer[sb_size_3];
-
-			buffer[0] = memory[0] + 2 * memory[1] + row_0;
-			buffer[sb_size] = -memory[1] + 2 * row_0 - row_1;
-			buffer[sb_size_2] = row_0 + 2 * row_1 + row_2;
-			buffer[sb_size_3] = -row_1 + 2 * row_2 - row_3;
-
-			memory[0] = ( short ) row_2;
-			memory[1] = ( short ) row_3;
-
-			memory += 2;
-			buffer++;
-		}
-	} else {
-		for (i = 0; i < sb_size; i++) {
-			int* buff_ptr = buffer;
-			if (( blocks >> 1 ) & 1) {
-				row_0 = buff_ptr[0];
-				row_1 = buff_ptr[sb_size];
-
-				buff_ptr[0] = memory[0] + 2 * memory[1] + row_0;
-				buff_ptr[sb_size] = -memory[1] + 2 * row_0 - row_1;
-				buff_ptr += sb_size_2;
-
-				db_0 = row_0;
-				db_1 = row_1;
-			} else {
-				db_0 = memory[0];
-				db_1 = memory[1];
-			}
-
-			for (int j = 0; j < blocks >> 2; j++) {
-				row_0 = buff_ptr[0];  buff_ptr[0] = db_0 + 2 * db_1 + row_0;  buff_ptr += sb_size;
-				row_1 = buff_ptr[0];  buff_ptr[0] = -db_1 + 2 * row_0 - row_1;  buff_ptr += sb_size;
-				row_2 = buff_ptr[0];  buff_ptr[0] = row_0 + 2 * row_1 + row_2;  buff_ptr += sb_size;
-				row_3 = buff_ptr[0];  buff_ptr[0] = -row_1 + 2 * row_2 -
-					row_3;  buff_ptr += sb_size;
-
-				db_0 = row_2;
-				db_1 = row_3;
-			}
-			memory[0] = ( short ) row_2;
-			memory[1] = ( short ) row_3;
-			memory += 2;
-			buffer++;
-		}
+	sub_4d420c( memory, buffer, sb_size, blocks );
+	// the first level only ever kept 16 bits of the last two rows
+	for (int i = 0; i < sb_size * 2; i++) {
+		memory[i] = ( short ) memory[i];
 	}
 }
 void CSubbandDecoder::sub_4d420c(int* memory, int* buffer, int sb_size,
 	int blocks)
 {
-	int row_0, row_1, row_2 = 0, row_3 = 0, db_0, db_1;
-	int i;
-	int sb_size_2 = sb_size * 2, sb_size_3 = sb_size * 3;
-	if (blocks == 4) {
-		for (i = 0; i < sb_size; i++) {
-			row_0 = buffer[0];
-			row_1 = buffer[sb_size];
-			row_2 = buffer[sb_size_2];
-			row_3 = buffer[sb_size_3];
-
-			buffer[0] = memory[0] + 2 * memory[1] + row_0;
-			buffer[sb_size] = -memory[1] + 2 * row_0 - row_1;
-			buffer[sb_size_2] = row_0 + 2 * row_1 + row_2;
-			buffer[sb_size_3] = -row_1 + 2 * row_2 - row_3;
-
-			memory[0] = row_2;
-			memory[1] = row_3;
-
-			memory += 2;
-			buffer++;
-		}
-	} else {
-		for (i = 0; i < sb_size; i++) {
-			int* buff_ptr = buffer;
-			db_0 = memory[0]; db_1 = memory[1];
-			for (int j = 0; j < blocks >> 2; j++) {
-				row_0 = buff_ptr[0];  buff_ptr[0] = db_0 + 2 * db_1 + row_0;  buff_ptr += sb_size;
-				row_1 = buff_ptr[0];  buff_ptr[0] = -db_1 + 2 * row_0 - row_1;  buff_ptr += sb_size;
-				row_2 = buff_ptr[0];  buff_ptr[0] = row_0 + 2 * row_1 + row_2;  buff_ptr += sb_size;
-				row_3 = buff_ptr[0];  buff_ptr[0] = -row_1 + 2 * row_2 -
-					row_3;  buff_ptr += sb_size;
-
-				db_0 = row_2;
-				db_1 = row_3;
-			}
-			memory[0] = row_2;
-			memory[1] = row_3;
-
-			memory += 2;
-			buffer++;
+	int* db_0 = memory, * db_1 = memory + sb_size;
+	if (sb_size < 4) {
+		// too narrow for whole rows to pay off, go down the columns instead
+		for (int i = 0; i < sb_size; i++) {
+			pair_and_quads( db_0 + i, db_1 + i, buffer + i, sb_size, blocks );
 		}
+		return;
+	}
+	if (( blocks >> 1 ) & 1) {
+		pair_step( db_0, db_1, buffer, buffer + sb_size, sb_size );
+		buffer += sb_size * 2;
+	}
+	for (int j = 0; j < blocks >> 2; j++) {
+		quad_step( db_0, db_1, buffer, sb_size, sb_size );
+		buffer += sb_size * 4;
 	}
 }
@@ -26,11 +26,15 @@
 #include <iostream>
 #endif
 
+// The reconstruction works on whole rows of a block at a time, so that the
+// same operation is applied to sb_size independent columns; every level keeps
+// the last two rows it saw in a pair of arrays, the first one truncated to
+// 16 bits like the original decoder did.
 class CSubbandDecoder {
 private:
 	int levels, block_size;
 	int* memory_buffer;
-	void sub_4d3fcc(short* memory, int* buffer, int sb_size, int blocks);
+	void sub_4d3fcc(int* memory, int* buffer, int sb_size, int blocks);
 	void sub_4d420c(int* memory, int* buffer, int sb_size, int blocks);
 public:
 	CSubbandDecoder(int lev_cnt)
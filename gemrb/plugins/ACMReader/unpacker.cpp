@@ -82,34 +82,53 @@ FillerProc Fillers[32] = {
 	& CValueUnpacker::return0, & CValueUnpacker::return0
 };
 
+void CValueUnpacker::refill_bits()
+{
+	unsigned char one_byte;
+	if (buffer_bit_offset == UNPACKER_BUFFER_SIZE) {
+		unsigned long remains = stream->Remains();
+		if (remains > UNPACKER_BUFFER_SIZE)
+			remains = UNPACKER_BUFFER_SIZE;
+		buffer_bit_offset = UNPACKER_BUFFER_SIZE - remains;
+		if (buffer_bit_offset != UNPACKER_BUFFER_SIZE)
+			stream->Read( bits_buffer + buffer_bit_offset, remains);
+	}
+	//our stream read returns -1 instead of 0 on failure
+	//comparing with 1 will solve annoying interface changes
+	if (buffer_bit_offset < UNPACKER_BUFFER_SIZE) {
+		one_byte = bits_buffer[buffer_bit_offset];
+		buffer_bit_offset++;
+	} else {
+		one_byte = 0;
+	}
+	next_bits |= ( ( unsigned long long ) one_byte << avail_bits );
+	avail_bits += 8;
+}
 inline void CValueUnpacker::prepare_bits(int bits)
 {
-	while (bits > avail_bits) {
-		unsigned char one_byte;
-		if (buffer_bit_offset == UNPACKER_BUFFER_SIZE) {
-			unsigned long remains = stream->Remains();
-			if (remains > UNPACKER_BUFFER_SIZE)
-				remains = UNPACKER_BUFFER_SIZE;
-			buffer_bit_offset = UNPACKER_BUFFER_SIZE - remains;
-			if (buffer_bit_offset != UNPACKER_BUFFER_SIZE)
-				stream->Read( bits_buffer + buffer_bit_offset, remains);
-		}
-		//our stream read returns -1 instead of 0 on failure
-		//comparing with 1 will solve annoying interface changes
-		if (buffer_bit_offset < UNPACKER_BUFFER_SIZE) {
-			one_byte = bits_buffer[buffer_bit_offset];
-			buffer_bit_offset++;
-		} else {
-			one_byte = 0;
+	if (bits <= avail_bits) {
+		return;
+	}
+	// take all the whole bytes that fit, so the next few requests
+	// are served straight from next_bits
+	if (buffer_bit_offset + 8 <= UNPACKER_BUFFER_SIZE) {
+		const unsigned char* src = bits_buffer + buffer_bit_offset;
+		int count = ( 64 - avail_bits ) >> 3;
+		for (int i = 0; i < count; i++) {
+			next_bits |= ( unsigned long long ) src[i] << avail_bits;
+			avail_bits += 8;
 		}
-		next_bits |= ( ( unsigned int ) one_byte << avail_bits );
-		avail_bits += 8;
+		buffer_bit_offset += count;
+		return;
+	}
+	while (bits > avail_bits) {
+		refill_bits();
 	}
 }
 int CValueUnpacker::get_bits(int bits)
 {
 	prepare_bits( bits );
-	int res = next_bits;
+	int res = ( int ) next_bits;
 	avail_bits -= bits;
 	next_bits >>= bits;
 	return res;
@@ -352,7 +371,7 @@ int CValueUnpacker::k3_5bits(int pass, int /*ind*/)
 				next_bits >>= 4;
 		} else {
 			avail_bits -= 5;
-			int val = ( next_bits & 0x18 ) >> 3;
+			int val = ( int ) ( next_bits & 0x18 ) >> 3;
 			next_bits >>= 5;
 			if (val >= 2)
 				val += 3;
@@ -378,7 +397,7 @@ int CValueUnpacker::k3_4bits(int pass, int /*ind*/)
 				buff_middle[-1];
 			next_bits >>= 3;
 		} else {
-			int val = ( next_bits &0xC ) >> 2;
+			int val = ( int ) ( next_bits & 0xC ) >> 2;
 			avail_bits -= 4;
 			next_bits >>= 4;
 			if (val >= 2)
@@ -407,7 +426,7 @@ int CValueUnpacker::k4_5bits(int pass, int /*ind*/)
 			next_bits >>= 2;
 			block_ptr[i * sb_size + pass] = 0;
 		} else {
-			int val = ( next_bits &0x1C ) >> 2;
+			int val = ( int ) ( next_bits & 0x1C ) >> 2;
 			if (val >= 4)
 				val++;
 			block_ptr[i * sb_size + pass] = buff_middle[-4 + val];
@@ -428,7 +447,7 @@ int CValueUnpacker::k4_4bits(int pass, int /*ind*/)
 			next_bits >>= 1;
 			block_ptr[i * sb_size + pass] = 0;
 		} else {
-			int val = ( next_bits &0xE ) >> 1;
+			int val = ( int ) ( next_bits & 0xE ) >> 1;
 			avail_bits -= 4;
 			next_bits >>= 4;
 			if (val >= 4)
@@ -33,8 +33,8 @@ private:
 	int levels, subblocks;
 	//FILE* file;
 	DataStream* stream;
-	// Bits
-	unsigned int next_bits; // new bits
+	// Bits, topped up a whole 64 bit word at a time
+	unsigned long long next_bits; // new bits
 	int avail_bits; // count of new bits
 	unsigned char bits_buffer[UNPACKER_BUFFER_SIZE];
 	unsigned int buffer_bit_offset;
@@ -44,6 +44,7 @@ private:
 	int* block_ptr;
 
 	// Reading routines
+	void refill_bits(); // slow path of prepare_bits, near the end of the buffer
 	void prepare_bits(int bits); // request bits
 	int get_bits(int bits); // request and return next bits
 public:
@@ -26,6 +26,7 @@
 
 #include "ActorMgr.h"
 #include "Ambient.h"
+#include "AreaDigest.h"
 #include "DataFileMgr.h"
 #include "DisplayMessage.h"
 #include "EffectMgr.h"
@@ -44,7 +45,12 @@
 #include "Scriptable/InfoPoint.h"
 #include "System/FileStream.h"
 #include "System/SlicedStream.h"
+#include "System/SpanReader.h"
+#include "System/WorkerPool.h"
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <stdlib.h>
 #ifdef ANDROID
 // android lacks mblen
@@ -79,12 +85,77 @@ Holder<DataFileMgr> INInote;
 ResRefToStrRef *tracks = NULL;
 int trackcount = 0;
 
+// loads the independent parts of areas while GetMap does the rest
+static WorkerPool* areaLoader = NULL;
+
 static void ReleaseMemory()
 {
 	INInote.release();
 
 	delete [] tracks;
 	tracks = NULL;
+
+	delete areaLoader;
+	areaLoader = NULL;
+}
+
+/**
+ * What GetMap hands to the workers before building the tilemap. Only
+ * the file reads and bitmap decoding run there, resource lookups are
+ * serialised by the ResourceManager. Sprites, creature parsing and
+ * everything else touching the game state stay on the main thread and
+ * in the original order, so the map comes out the same either way.
+ * The destructor is the join point, so early returns are safe.
+ */
+namespace GemRB {
+struct AreaPrefetch {
+	std::mutex lock;
+	std::condition_variable finished;
+	int pending;
+
+	Image* lightMap;
+	Bitmap* searchMap;
+	Bitmap* heightMap;
+	// by actor index, NULL for embedded creatures
+	std::vector<DataStream*> creFiles;
+
+	AreaPrefetch() : pending(0), lightMap(NULL), searchMap(NULL), heightMap(NULL) {}
+	~AreaPrefetch()
+	{
+		Join();
+		delete lightMap;
+		delete searchMap;
+		delete heightMap;
+		for (size_t i = 0; i < creFiles.size(); i++) {
+			delete creFiles[i];
+		}
+	}
+
+	void Post(const std::function<void()>& job)
+	{
+		if (!areaLoader) {
+			areaLoader = new WorkerPool(WorkerPool::DefaultThreads());
+		}
+		{
+			std::lock_guard<std::mutex> l(lock);
+			pending++;
+		}
+		areaLoader->Post([this, job]() {
+			job();
+			std::lock_guard<std::mutex> l(lock);
+			pending--;
+			finished.notify_all();
+		});
+	}
+
+	void Join()
+	{
+		std::unique_lock<std::mutex> l(lock);
+		while (pending) {
+			finished.wait(l);
+		}
+	}
+};
 }
 
 static void ReadAutonoteINI()
@@ -298,13 +369,12 @@ bool AREImporter::ChangeMap(Map *map, bool day_or_night)
 		return false;
 	}
 
-	// Small map for MapControl
-	ResourceHolder<ImageMgr> sm = GetResourceHolder<ImageMgr>(TmpResRef);
-
+	// Small map for MapControl, decoded once it is shown
 	// night small map is *optional*!
-	if (!sm) {
+	const char* sm = TmpResRef;
+	if (!gamedata->Exists(sm, &ImageMgr::ID, true)) {
 		//fall back to day minimap
-		sm = GetResourceHolder<ImageMgr>(map->WEDResRef);
+		sm = map->WEDResRef;
 	}
 
 	//the map state was altered, no need to hold this off for any later
@@ -324,7 +394,7 @@ bool AREImporter::ChangeMap(Map *map, bool day_or_night)
 	}
 
 	//alter the lightmap and the minimap (the tileset was already swapped)
-	map->ChangeTileMap(lm->GetImage(), sm?sm->GetSprite2D():NULL);
+	map->ChangeTileMap(lm->GetImage(), sm);
 
 	// update the tiles and tilecount (eg. door0304 in Edwin's Docks (ar0300) entrance
 	for (size_t i = 0; i < tm->GetDoorCount(); i++) {
@@ -364,6 +434,23 @@ inline ieDword FixIWD2DoorFlags(ieDword Flags, bool reverse)
 	return Flags = (Flags & ~maskOff) | maskOn;
 }
 
+// reads count vertices starting with the given one in a single go
+static Point* ReadVertices(DataStream* str, ieDword offset, ieDword first, ieDword count)
+{
+	str->Seek( offset + ( first * 4 ), GEM_STREAM_START );
+	SpanReader vertices(str, count * 4);
+	Point* points = ( Point* ) malloc( count * sizeof( Point ) );
+	for (ieDword x = 0; x < count; x++) {
+		ieWord tmp = 0;
+		vertices.ReadWord( &tmp );
+		points[x].x = tmp;
+		tmp = 0;
+		vertices.ReadWord( &tmp );
+		points[x].y = tmp;
+	}
+	return points;
+}
+
 static Ambient* SetupMainAmbients(Map *map, bool day_or_night) {
 	ieResRef *main1[2] = { &map->SongHeader.MainNightAmbient1, &map->SongHeader.MainDayAmbient1 };
 	ieResRef *main2[2] = { &map->SongHeader.MainNightAmbient2, &map->SongHeader.MainDayAmbient2 };
@@ -393,9 +480,72 @@ static Ambient* SetupMainAmbients(Map *map, bool day_or_night) {
 	return ambi;
 }
 
+#define AREA_ACTOR_SIZE 0x110
+#define AREA_ANIMATION_SIZE 0x4c
+
+// queues everything GetMap can use without the game state
+void AREImporter::PrefetchMap(AreaPrefetch& pf, bool day_or_night)
+{
+	ieResRef lightRef, searchRef, heightRef;
+	if (day_or_night) {
+		snprintf(lightRef, 9, "%.6sLM", WEDResRef);
+	} else {
+		snprintf(lightRef, 9, "%.6sLN", WEDResRef);
+	}
+	snprintf(searchRef, 9, "%.6sSR", WEDResRef);
+	snprintf(heightRef, 9, "%.6sHT", WEDResRef);
+
+	// the maps the area logic needs, digested in the cache after the first visit
+	std::string light = lightRef;
+	std::string search = searchRef;
+	std::string height = heightRef;
+	pf.Post([&pf, light, search, height]() {
+		AreaDigest digest;
+		digest.Load(light.c_str(), search.c_str(), height.c_str());
+		pf.lightMap = digest.lightMap;
+		pf.searchMap = digest.searchMap;
+		pf.heightMap = digest.heightMap;
+		digest.lightMap = NULL;
+		digest.searchMap = NULL;
+		digest.heightMap = NULL;
+	});
+
+	if (core->IsAvailable(IE_CRE_CLASS_ID)) {
+		pf.creFiles.resize(ActorCount, NULL);
+		for (unsigned int i = 0; i < ActorCount; i++) {
+			ieDword Flags, CreOffset;
+			ieResRef CreResRef;
+			str->Seek(ActorOffset + i * AREA_ACTOR_SIZE + 0x28, GEM_STREAM_START);
+			str->ReadDword(&Flags);
+			str->Seek(ActorOffset + i * AREA_ACTOR_SIZE + 0x80, GEM_STREAM_START);
+			str->ReadResRef(CreResRef);
+			str->ReadDword(&CreOffset);
+			// embedded ones are sliced from the area itself
+			if (CreOffset != 0 && !(Flags&1)) {
+				continue;
+			}
+			std::string cre = CreResRef;
+			DataStream** slot = &pf.creFiles[i];
+			// pulled into memory, so parsing it later won't wait on the disk
+			pf.Post([slot, cre]() {
+				*slot = gamedata->ReadResource(cre.c_str(), IE_CRE_CLASS_ID, true);
+			});
+		}
+	}
+
+	if (core->IsAvailable(IE_BAM_CLASS_ID)) {
+		for (unsigned int i = 0; i < AnimCount; i++) {
+			ieResRef BAM;
+			str->Seek(AnimOffset + i * AREA_ANIMATION_SIZE + 0x28, GEM_STREAM_START);
+			str->ReadResRef(BAM);
+			gamedata->PrefetchFactoryResource(BAM);
+		}
+	}
+}
+
 Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 {
-	unsigned int i,x;
+	unsigned int i;
 
 	// if this area does not have extended night, force it to day mode
 	if (!(AreaFlags & AT_EXTENDED_NIGHT))
@@ -437,13 +587,10 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		delete map;
 		return NULL;
 	}
-	ieResRef TmpResRef;
 
-	if (day_or_night) {
-		memcpy( TmpResRef, WEDResRef, 9);
-	} else {
-		snprintf( TmpResRef, 9, "%.7sN", WEDResRef);
-	}
+	// the bitmaps and creature files load while we build the tilemap
+	AreaPrefetch pf;
+	PrefetchMap(pf, day_or_night);
 
 	PluginHolder<TileMapMgr> tmm(IE_WED_CLASS_ID);
 	DataStream* wedfile = gamedata->GetResource( WEDResRef, IE_WED_CLASS_ID );
@@ -457,11 +604,16 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		return NULL;
 	}
 
-	// Small map for MapControl
-	ResourceHolder<ImageMgr> sm = GetResourceHolder<ImageMgr>(TmpResRef);
-	if (!sm) {
+	// Small map for MapControl, decoded once it is shown
+	ieResRef smallRef;
+	if (day_or_night) {
+		memcpy(smallRef, WEDResRef, 9);
+	} else {
+		snprintf(smallRef, 9, "%.7sN", WEDResRef);
+	}
+	if (!gamedata->Exists(smallRef, &ImageMgr::ID, true)) {
 		//fall back to day minimap
-		sm = GetResourceHolder<ImageMgr>(map->WEDResRef);
+		memcpy(smallRef, WEDResRef, 9);
 	}
 
 	//if the Script field is empty, the area name will be copied into it on first load
@@ -477,35 +629,24 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		map->Scripts[MAX_SCRIPTS-1] = new GameScript( Script, map );
 	}
 
-	if (day_or_night) {
-		snprintf( TmpResRef, 9, "%.6sLM", WEDResRef);
-	} else {
-		snprintf( TmpResRef, 9, "%.6sLN", WEDResRef);
-	}
-
-	ResourceHolder<ImageMgr> lm = GetResourceHolder<ImageMgr>(TmpResRef);
-	if (!lm) {
+	pf.Join();
+	if (!pf.lightMap) {
 		Log(ERROR, "AREImporter", "No lightmap available.");
 		return NULL;
 	}
-
-	snprintf( TmpResRef, 9, "%.6sSR", WEDResRef);
-
-	ResourceHolder<ImageMgr> sr = GetResourceHolder<ImageMgr>(TmpResRef);
-	if (!sr) {
+	if (!pf.searchMap) {
 		Log(ERROR, "AREImporter", "No searchmap available.");
 		return NULL;
 	}
-
-	snprintf( TmpResRef, 9, "%.6sHT", WEDResRef);
-
-	ResourceHolder<ImageMgr> hm = GetResourceHolder<ImageMgr>(TmpResRef);
-	if (!hm) {
+	if (!pf.heightMap) {
 		Log(ERROR, "AREImporter", "No heightmap available.");
 		return NULL;
 	}
 
-	map->AddTileMap( tm, lm->GetImage(), sr->GetBitmap(), sm ? sm->GetSprite2D() : NULL, hm->GetBitmap() );
+	map->AddTileMap( tm, pf.lightMap, pf.searchMap, smallRef, pf.heightMap );
+	pf.lightMap = NULL;
+	pf.searchMap = NULL;
+	pf.heightMap = NULL;
 
 	Log(DEBUG, "AREImporter", "Loading songs");
 	str->Seek( SongHeader, GEM_STREAM_START );
@@ -645,12 +786,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 			memset(DialogResRef, 0, sizeof(DialogResRef));
 		}
 
-		str->Seek( VerticesOffset + ( FirstVertex * 4 ), GEM_STREAM_START );
-		Point* points = ( Point* ) malloc( VertexCount*sizeof( Point ) );
-		for (x = 0; x < VertexCount; x++) {
-			str->ReadWord( (ieWord*) &points[x].x );
-			str->ReadWord( (ieWord*) &points[x].y );
-		}
+		Point* points = ReadVertices( str, VerticesOffset, FirstVertex, VertexCount );
 		Gem_Polygon* poly = new Gem_Polygon( points, VertexCount, &bbox);
 		free( points );
 		InfoPoint* ip = tm->AddInfoPoint( Name, Type, poly );
@@ -753,15 +889,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		str->Seek( 4, GEM_CURRENT_POS); //break difficulty
 		str->ReadDword( &OpenFail );
 
-		str->Seek( VerticesOffset + ( firstIndex * 4 ), GEM_STREAM_START );
-		Point* points = ( Point* ) malloc( vertCount*sizeof( Point ) );
-		for (x = 0; x < vertCount; x++) {
-			ieWord tmp;
-			str->ReadWord( &tmp );
-			points[x].x = tmp;
-			str->ReadWord( &tmp );
-			points[x].y = tmp;
-		}
+		Point* points = ReadVertices( str, VerticesOffset, firstIndex, vertCount );
 		if (vertCount == 0 && bbox.w == 0 && bbox.h == 0) {
 			/* piles have no polygons and no bounding box in some areas,
 			 * but bg2 gives them this bounding box at first load,
@@ -903,28 +1031,12 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		}
 
 		//Reading Open Polygon
-		str->Seek( VerticesOffset + ( OpenFirstVertex * 4 ), GEM_STREAM_START );
-		Point* points = ( Point* )
-			malloc( OpenVerticesCount*sizeof( Point ) );
-		for (x = 0; x < OpenVerticesCount; x++) {
-			str->ReadWord( &minX );
-			points[x].x = minX;
-			str->ReadWord( &minY );
-			points[x].y = minY;
-		}
+		Point* points = ReadVertices( str, VerticesOffset, OpenFirstVertex, OpenVerticesCount );
 		Gem_Polygon* open = new Gem_Polygon( points, OpenVerticesCount, &BBOpen );
 		free( points );
 
 		//Reading Closed Polygon
-		str->Seek( VerticesOffset + ( ClosedFirstVertex * 4 ),
-				GEM_STREAM_START );
-		points = ( Point * ) malloc( ClosedVerticesCount * sizeof( Point ) );
-		for (x = 0; x < ClosedVerticesCount; x++) {
-			str->ReadWord( &minX );
-			points[x].x = minX;
-			str->ReadWord( &minY );
-			points[x].y = minY;
-		}
+		points = ReadVertices( str, VerticesOffset, ClosedFirstVertex, ClosedVerticesCount );
 		Gem_Polygon* closed = new Gem_Polygon( points, ClosedVerticesCount, &BBClosed );
 		free( points );
 
@@ -943,28 +1055,12 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		tmm->SetupOpenDoor(door->open_wg_index, door->open_wg_count);
 
 		//Reading Open Impeded blocks
-		str->Seek( VerticesOffset + ( OpenFirstImpeded * 4 ),
-				GEM_STREAM_START );
-		points = ( Point * ) malloc( OpenImpededCount * sizeof( Point ) );
-		for (x = 0; x < OpenImpededCount; x++) {
-			str->ReadWord( &minX );
-			points[x].x = minX;
-			str->ReadWord( &minY );
-			points[x].y = minY;
-		}
+		points = ReadVertices( str, VerticesOffset, OpenFirstImpeded, OpenImpededCount );
 		door->open_ib = points;
 		door->oibcount = OpenImpededCount;
 
 		//Reading Closed Impeded blocks
-		str->Seek( VerticesOffset + ( ClosedFirstImpeded * 4 ),
-				GEM_STREAM_START );
-		points = ( Point * ) malloc( ClosedImpededCount * sizeof( Point ) );
-		for (x = 0; x < ClosedImpededCount; x++) {
-			str->ReadWord( &minX );
-			points[x].x = minX;
-			str->ReadWord( &minY );
-			points[x].y = minY;
-		}
+		points = ReadVertices( str, VerticesOffset, ClosedFirstImpeded, ClosedImpededCount );
 		door->closed_ib = points;
 		door->cibcount = ClosedImpededCount;
 		door->SetMap(map);
@@ -1129,6 +1225,9 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 			//is not loaded yet, so !(Flags&1) means it is embedded
 			if (CreOffset != 0 && !(Flags&1) ) {
 				crefile = SliceStream( str, CreOffset, CreSize, true );
+			} else if (pf.creFiles[i]) {
+				crefile = pf.creFiles[i];
+				pf.creFiles[i] = NULL;
 			} else {
 				crefile = gamedata->GetResource( CreResRef, IE_CRE_CLASS_ID );
 			}
@@ -1245,29 +1344,31 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 
 	Log(DEBUG, "AREImporter", "Loading entrances");
 	str->Seek( EntrancesOffset, GEM_STREAM_START );
+	SpanReader entrances(str, EntrancesCount * 104);
 	for (i = 0; i < EntrancesCount; i++) {
 		ieVariable Name;
 		ieWord XPos, YPos, Face;
-		str->Read( Name, 32 );
+		entrances.Read( Name, 32 );
 		Name[32] = 0;
-		str->ReadWord( &XPos );
-		str->ReadWord( &YPos );
-		str->ReadWord( &Face );
-		str->Seek( 66, GEM_CURRENT_POS );
+		entrances.ReadWord( &XPos );
+		entrances.ReadWord( &YPos );
+		entrances.ReadWord( &Face );
+		entrances.Skip( 66 );
 		map->AddEntrance( Name, XPos, YPos, Face );
 	}
 
 	Log(DEBUG, "AREImporter", "Loading variables");
 	map->locals->LoadInitialValues(ResRef);
 	str->Seek( VariablesOffset, GEM_STREAM_START );
+	SpanReader variables(str, VariablesCount * 84);
 	for (i = 0; i < VariablesCount; i++) {
 		ieVariable Name;
 		ieDword Value;
-		str->Read( Name, 32 );
+		variables.Read( Name, 32 );
 		Name[32] = 0;
-		str->Seek( 8, GEM_CURRENT_POS );
-		str->ReadDword( &Value );
-		str->Seek( 40, GEM_CURRENT_POS );
+		variables.Skip( 8 );
+		variables.ReadDword( &Value );
+		variables.Skip( 40 );
 		map->locals->SetAt( Name, Value );
 	}
 
@@ -31,6 +31,7 @@ namespace GemRB {
 class Animation;
 class AnimationFactory;
 class EffectQueue;
+struct AreaPrefetch;
 
 class AREImporter : public MapMgr {
 private:
@@ -70,6 +71,7 @@ public:
 	/* stores an area in the Cache (swaps it out) */
 	int PutArea(DataStream *stream, Map *map);
 private:
+	void PrefetchMap(AreaPrefetch& pf, bool day_or_night);
 	void AdjustPSTFlags(AreaAnimation*);
 	void ReadEffects(DataStream *ds, EffectQueue *fx, ieDword EffectsCount);
 	CREItem* GetItem();
@@ -50,6 +50,8 @@ BAMImporter::BAMImporter(void)
 	CyclesCount = 0;
 	CompressedColorIndex = DataStart = 0;
 	FramesOffset = PaletteOffset = FLTOffset = 0;
+	decoded = decodedCompressed = false;
+	frameData = NULL;
 }
 
 BAMImporter::~BAMImporter(void)
@@ -58,6 +60,7 @@ BAMImporter::~BAMImporter(void)
 	delete[] frames;
 	delete[] cycles;
 	gamedata->FreePalette(palette);
+	FreeDecoded();
 }
 
 bool BAMImporter::Open(DataStream* stream)
@@ -71,6 +74,7 @@ bool BAMImporter::Open(DataStream* stream)
 	delete[] frames;
 	delete[] cycles;
 	gamedata->FreePalette(palette);
+	FreeDecoded();
 
 	str = stream;
 	char Signature[8];
@@ -158,7 +162,8 @@ Sprite2D* BAMImporter::GetFrameInternal(unsigned short findex, unsigned char mod
 							   palette,
 							   CompressedColorIndex);
 	} else {
-		void* pixels = GetFramePixels(findex);
+		void* pixels = framePixels[findex];
+		framePixels[findex] = NULL;
 		spr = core->GetVideoDriver()->CreateSprite8(
 			frames[findex].Width, frames[findex].Height,
 			pixels, palette, true, 0 );
@@ -252,23 +257,58 @@ ieWord * BAMImporter::CacheFLT(unsigned int &count)
 	return FLT;
 }
 
+void BAMImporter::FreeDecoded()
+{
+	free(frameData);
+	frameData = NULL;
+	for (void* pixels : framePixels) {
+		free(pixels);
+	}
+	framePixels.clear();
+	decoded = false;
+}
+
+void BAMImporter::DecodeFrames(bool allowCompression)
+{
+	FreeDecoded();
+	decoded = true;
+	decodedCompressed = allowCompression;
+
+	if (allowCompression) {
+		str->Seek( DataStart, GEM_STREAM_START );
+		unsigned long length = str->Remains();
+		if (length == 0) return;
+		frameData = (unsigned char *) malloc(length);
+		str->Read( frameData, length );
+	} else {
+		framePixels.resize(FramesCount);
+		for (unsigned int i = 0; i < FramesCount; ++i) {
+			framePixels[i] = GetFramePixels(i);
+		}
+	}
+}
+
 AnimationFactory* BAMImporter::GetAnimationFactory(const char* ResRef, unsigned char mode, bool allowCompression)
 {
 	unsigned int i, count;
+	allowCompression = allowCompression && core->GetVideoDriver()->SupportsBAMSprites();
+	// a prefetch may have decoded them already
+	if (!decoded || decodedCompressed != allowCompression) {
+		DecodeFrames(allowCompression);
+	}
+
 	AnimationFactory* af = new AnimationFactory( ResRef );
 	ieWord *FLT = CacheFLT( count );
-
-	allowCompression = allowCompression && core->GetVideoDriver()->SupportsBAMSprites();
-	unsigned char* data = NULL;
+	unsigned char* data = frameData;
 
 	if (allowCompression) {
-		str->Seek( DataStart, GEM_STREAM_START );
-		unsigned long length = str->Remains();
-		if (length == 0) return af;
-		//data = new unsigned char[length];
-		data = (unsigned char *) malloc(length);
-		str->Read( data, length );
+		if (!data) {
+			free(FLT);
+			decoded = false;
+			return af;
+		}
 		af->SetFrameData(data);
+		frameData = NULL;
 	}
 
 	for (i = 0; i < FramesCount; ++i) {
@@ -276,6 +316,8 @@ AnimationFactory* BAMImporter::GetAnimationFactory(const char* ResRef, unsigned
 		assert(!allowCompression || frame->BAM);
 		af->AddFrame(frame);
 	}
+	framePixels.clear();
+	decoded = false;
 	for (i = 0; i < CyclesCount; ++i) {
 		af->AddCycle( cycles[i] );
 	}
@@ -26,6 +26,8 @@
 #include "RGBAColor.h"
 #include "globals.h"
 
+#include <vector>
+
 namespace GemRB {
 
 struct FrameEntry {
@@ -49,17 +51,23 @@ private:
 	ieByte CompressedColorIndex;
 	ieDword FramesOffset, PaletteOffset, FLTOffset;
 	unsigned long DataStart;
+	// decoded by DecodeFrames, the sprites take them over
+	bool decoded, decodedCompressed;
+	unsigned char* frameData;
+	std::vector<void*> framePixels;
 private:
 	Sprite2D* GetFrameInternal(unsigned short findex, unsigned char mode,
 							   bool BAMsprite, const unsigned char* data,
 							   AnimationFactory* datasrc);
 	void* GetFramePixels(unsigned short findex);
 	ieWord * CacheFLT(unsigned int &count);
+	void FreeDecoded();
 public:
 	BAMImporter(void);
 	~BAMImporter(void);
 	bool Open(DataStream* stream);
 	int GetCycleSize(unsigned char Cycle);
+	void DecodeFrames(bool allowCompression);
 	AnimationFactory* GetAnimationFactory(const char* ResRef,
 		unsigned char mode = IE_NORMAL, bool allowCompression = true);
 	/** Debug Function: Returns the Global Animation Palette as a Sprite2D Object.
@@ -29,6 +29,7 @@
 #include "System/SlicedStream.h"
 #include "System/FileStream.h"
 #include "System/MappedFileMemoryStream.h"
+#include "System/SpanReader.h"
 
 using namespace GemRB;
 
@@ -197,20 +198,22 @@ void BIFImporter::ReadBIF(void)
 	}
 	unsigned int i;
 
+	// both tables in one go
+	SpanReader table(stream, fentcount * 16 + tentcount * 20);
 	for (i=0;i<fentcount;i++) {
-		stream->ReadDword( &fentries[i].resLocator);
-		stream->ReadDword( &fentries[i].dataOffset);
-		stream->ReadDword( &fentries[i].fileSize);
-		stream->ReadWord( &fentries[i].type);
-		stream->ReadWord( &fentries[i].u1);
+		table.ReadDword( &fentries[i].resLocator);
+		table.ReadDword( &fentries[i].dataOffset);
+		table.ReadDword( &fentries[i].fileSize);
+		table.ReadWord( &fentries[i].type);
+		table.ReadWord( &fentries[i].u1);
 	}
 	for (i=0;i<tentcount;i++) {
-		stream->ReadDword( &tentries[i].resLocator);
-		stream->ReadDword( &tentries[i].dataOffset);
-		stream->ReadDword( &tentries[i].tilesCount);
-		stream->ReadDword( &tentries[i].tileSize);
-		stream->ReadWord( &tentries[i].type);
-		stream->ReadWord( &tentries[i].u1);
+		table.ReadDword( &tentries[i].resLocator);
+		table.ReadDword( &tentries[i].dataOffset);
+		table.ReadDword( &tentries[i].tilesCount);
+		table.ReadDword( &tentries[i].tileSize);
+		table.ReadWord( &tentries[i].type);
+		table.ReadWord( &tentries[i].u1);
 	}
 }
 
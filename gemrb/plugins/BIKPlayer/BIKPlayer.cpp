@@ -86,6 +86,8 @@ BIKPlayer::BIKPlayer(void)
 	video_rendered_frame = done = validVideo = s_audio = false;
 	s_channels = s_first = s_stream = s_root = 0;
 	s_bands = NULL;
+	decodeFrame = 0;
+	stopDecoding = decodingDone = false;
 }
 
 BIKPlayer::~BIKPlayer(void)
@@ -217,6 +219,25 @@ bool BIKPlayer::Open(DataStream* stream)
 	return false;
 }
 
+int BIKPlayer::Decode()
+{
+	if (!validVideo || !inbuff) {
+		return -1;
+	}
+	//no audio, no timing, no decoder thread, just the frames
+	s_stream = -1;
+	int ret = -1;
+	if (!video_init(header.width, header.height)) {
+		decodeFrame = 0;
+		ret = 0;
+		while (read_frame(NULL)) {
+			ret++;
+		}
+	}
+	EndVideo();
+	return ret;
+}
+
 void BIKPlayer::CallBackAtFrames(ieDword cnt, ieDword *arg, ieDword *arg2 )
 {
 	maxRow = cnt;
@@ -291,27 +312,168 @@ void BIKPlayer::timer_wait()
 	timer_start();
 }
 
-bool BIKPlayer::next_frame()
+static inline void release_buffer(AVFrame *p)
 {
-	if (timer_last_sec) {
-		timer_wait();
+	int i;
+
+	for(i=0;i<3;i++) {
+		av_freep((void **) &p->data[i]);
+	}
+}
+
+static inline void ff_fill_linesize(AVFrame *picture, int width)
+{
+	memset(picture->linesize, 0, sizeof(picture->linesize));
+	int w2 = (width + (1 << 1) - 1) >> 1;
+	picture->linesize[0] = width;
+	picture->linesize[1] = w2;
+	picture->linesize[2] = w2;
+}
+
+static inline void get_buffer(AVFrame *p, int width, int height)
+{
+	ff_fill_linesize(p, width);
+	//blocks cover whole 16 pixel rows, even past the picture
+	height = (height + 15) & ~15;
+	for(int plane=0;plane<3;plane++) {
+		p->data[plane] = (uint8_t *) av_malloc(p->linesize[plane]*height);
+		memset(p->data[plane], 0, p->linesize[plane]*height);
+	}
+}
+
+static inline void copy_buffer(AVFrame *dst, const AVFrame *src, int height)
+{
+	for(int plane=0;plane<3;plane++) {
+		int rows = plane ? (height + 1) >> 1 : height;
+		memcpy(dst->data[plane], src->data[plane], src->linesize[plane]*rows);
 	}
-	if(frameCount>=header.framecount) {
+}
+
+//reads and decodes the next frame, keeping a copy in out if there is one
+bool BIKPlayer::read_frame(DecodedFrame *out)
+{
+	if (decodeFrame >= header.framecount) {
 		return false;
 	}
-	binkframe frame = frames[frameCount++];
+	binkframe frame = frames[decodeFrame++];
 	str->Seek(frame.pos, GEM_STREAM_START);
 	ieDword audframesize;
 	str->ReadDword(&audframesize);
 	frame.size = str->Read( inbuff, frame.size - 4 );
-	if (s_stream > -1 && DecodeAudioFrame(inbuff, audframesize)) {
-		//buggy frame, we stop immediately
-		//return false;
+	if (out && s_stream > -1) {
+		//the bit reader may look a few bytes past the end
+		out->audio.assign(inbuff, inbuff + audframesize);
+		out->audio.resize(audframesize + BIK_AUDIO_PADDING, 0);
+		out->audioSize = audframesize;
 	}
 	if (DecodeVideoFrame(inbuff+audframesize, frame.size-audframesize)) {
 		//buggy frame, we stop immediately
 		return false;
 	}
+	if (out) {
+		copy_buffer(&out->pic, &c_last, header.height);
+	}
+	return true;
+}
+
+//runs on the decoder thread, staying up to BIK_DECODE_AHEAD frames ahead of playback
+void BIKPlayer::decode_ahead()
+{
+	while (true) {
+		DecodedFrame *frame;
+		{
+			std::unique_lock<std::mutex> lock(queueLock);
+			queueCond.wait(lock, [this] { return stopDecoding || decodedFrames.size() < BIK_DECODE_AHEAD; });
+			if (stopDecoding) {
+				return;
+			}
+			if (freeFrames.empty()) {
+				frame = new DecodedFrame();
+				get_buffer(&frame->pic, header.width, header.height);
+			} else {
+				frame = freeFrames.back();
+				freeFrames.pop_back();
+			}
+		}
+
+		bool decoded = read_frame(frame);
+
+		std::lock_guard<std::mutex> lock(queueLock);
+		if (!decoded) {
+			freeFrames.push_back(frame);
+			decodingDone = true;
+			queueCond.notify_all();
+			return;
+		}
+		decodedFrames.push_back(frame);
+		queueCond.notify_all();
+	}
+}
+
+void BIKPlayer::start_decoding()
+{
+	decodeFrame = 0;
+	stopDecoding = decodingDone = false;
+	decoder = std::thread(&BIKPlayer::decode_ahead, this);
+}
+
+void BIKPlayer::stop_decoding()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueLock);
+		stopDecoding = true;
+		queueCond.notify_all();
+	}
+	if (decoder.joinable()) {
+		decoder.join();
+	}
+	while (!decodedFrames.empty()) {
+		freeFrames.push_back(decodedFrames.front());
+		decodedFrames.pop_front();
+	}
+	for (DecodedFrame *frame : freeFrames) {
+		release_buffer(&frame->pic);
+		delete frame;
+	}
+	freeFrames.clear();
+}
+
+bool BIKPlayer::next_frame()
+{
+	if (timer_last_sec) {
+		timer_wait();
+	}
+
+	DecodedFrame *frame;
+	{
+		std::unique_lock<std::mutex> lock(queueLock);
+		queueCond.wait(lock, [this] { return decodingDone || !decodedFrames.empty(); });
+		if (decodedFrames.empty()) {
+			return false;
+		}
+		frame = decodedFrames.front();
+		decodedFrames.pop_front();
+		queueCond.notify_all();
+	}
+
+	frameCount++;
+	if (s_stream > -1 && DecodeAudioFrame(frame->audio.data(), frame->audioSize)) {
+		//buggy frame, we stop immediately
+		//return false;
+	}
+	if (video_frameskip) {
+		video_frameskip--;
+		video_skippedframes++;
+	} else {
+		unsigned int dest_x = (outputwidth - header.width) >> 1;
+		unsigned int dest_y = (outputheight - header.height) >> 1;
+		showFrame((ieByte **) frame->pic.data, (unsigned int *) frame->pic.linesize, header.width, header.height, header.width, header.height, dest_x, dest_y);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queueLock);
+		freeFrames.push_back(frame);
+	}
 	if (!timer_last_sec) {
 		timer_start();
 	}
@@ -343,9 +505,11 @@ int BIKPlayer::doPlay()
 		return 2;
 	}
 
+	start_decoding();
 	while (!done && next_frame()) {
 		done = video->PollMovieEvents();
 	}
+	stop_decoding();
 
 	video->DestroyMovieScreen();
 	return 0;
@@ -530,6 +694,10 @@ int BIKPlayer::video_init(int w, int h)
 		return 1;
 	}
 
+	//the two frames are swapped after each decoded frame
+	get_buffer(&c_pic, header.width, header.height);
+	get_buffer(&c_last, header.width, header.height);
+
 	ff_init_scantable(&c_scantable, bink_scan);
 
 	bw = (header.width  + 7) >> 3;
@@ -559,32 +727,6 @@ int BIKPlayer::EndAudio()
 	return 0;
 }
 
-static inline void release_buffer(AVFrame *p)
-{
-	int i;
-
-	for(i=0;i<3;i++) {
-		av_freep((void **) &p->data[i]);
-	}
-}
-
-static inline void ff_fill_linesize(AVFrame *picture, int width)
-{
-	memset(picture->linesize, 0, sizeof(picture->linesize));
-	int w2 = (width + (1 << 1) - 1) >> 1;
-	picture->linesize[0] = width;
-	picture->linesize[1] = w2;
-	picture->linesize[2] = w2;
-}
-
-static inline void get_buffer(AVFrame *p, int width, int height)
-{
-	ff_fill_linesize(p, width);
-	for(int plane=0;plane<3;plane++) {
-		p->data[plane] = (uint8_t *) av_malloc(p->linesize[plane]*height);
-	}
-}
-
 int BIKPlayer::EndVideo()
 {
 	int i;
@@ -1235,147 +1377,8 @@ inline int BIKPlayer::get_value(int bundle)
 	dst[(x)*2 +     ((y)*2 + 1) * stride] = \
 	dst[(x)*2 + 1 + ((y)*2 + 1) * stride] = pix;
 
-static void get_pixels(DCTELEM *block, const uint8_t *pixels, int line_size)
-{
-	int i;
-
-	/* read the pixels */
-	for(i=0;i<8;i++) {
-		block[0] = pixels[0];
-		block[1] = pixels[1];
-		block[2] = pixels[2];
-		block[3] = pixels[3];
-		block[4] = pixels[4];
-		block[5] = pixels[5];
-		block[6] = pixels[6];
-		block[7] = pixels[7];
-		pixels += line_size;
-		block += 8;
-	}
-}
-
-static void put_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
-{
-	int i;
-	/* read the pixels */
-	for(i=0;i<8;i++) {
-		pixels[0] = block[0];
-		pixels[1] = block[1];
-		pixels[2] = block[2];
-		pixels[3] = block[3];
-		pixels[4] = block[4];
-		pixels[5] = block[5];
-		pixels[6] = block[6];
-		pixels[7] = block[7];
-		pixels += line_size;
-		block += 8;
-	}
-}
-
-static void add_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
-{
-	int i;
-
-	/* read the pixels */
-	for(i=0;i<8;i++) {
-		pixels[0] += block[0];
-		pixels[1] += block[1];
-		pixels[2] += block[2];
-		pixels[3] += block[3];
-		pixels[4] += block[4];
-		pixels[5] += block[5];
-		pixels[6] += block[6];
-		pixels[7] += block[7];
-		pixels += line_size;
-		block += 8;
-	}
-}
-
-static inline void copy_block(DCTELEM block[64], const uint8_t *src, uint8_t *dst, int stride)
-{
-	get_pixels(block, src, stride);
-	put_pixels_nonclamped(block, dst, stride);
-}
-
 #define clear_block(block) memset( (block), 0, sizeof(DCTELEM)*64);
 
-//This replaces the j_rev_dct module
-static void bink_idct(DCTELEM *block)
-{
-	int i, t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, tA, tB, tC;
-	int tblock[64];
-
-	for (i = 0; i < 8; i++) {
-		t0 = block[i+ 0] + block[i+32];
-		t1 = block[i+ 0] - block[i+32];
-		t2 = block[i+16] + block[i+48];
-		t3 = block[i+16] - block[i+48];
-		t3 = ((t3 * 0xB50) >> 11) - t2;
-
-		t4 = t0 - t2;
-		t5 = t0 + t2;
-		t6 = t1 + t3;
-		t7 = t1 - t3;
-
-		t0 = block[i+40] + block[i+24];
-		t1 = block[i+40] - block[i+24];
-		t2 = block[i+ 8] + block[i+56];
-		t3 = block[i+ 8] - block[i+56];
-
-		t8 = t2 + t0;
-		t9 = t3 + t1;
-		t9 = (0xEC8 * t9) >> 11;
-		tA = ((-0x14E8 * t1) >> 11) + t9 - t8;
-		tB = t2 - t0;
-		tB = ((0xB50 * tB) >> 11) - tA;
-		tC = ((0x8A9 * t3) >> 11) + tB - t9;
-
-		tblock[i+ 0] = t5 + t8;
-		tblock[i+56] = t5 - t8;
-		tblock[i+ 8] = t6 + tA;
-		tblock[i+48] = t6 - tA;
-		tblock[i+16] = t7 + tB;
-		tblock[i+40] = t7 - tB;
-		tblock[i+32] = t4 + tC;
-		tblock[i+24] = t4 - tC;
-	}
-
-	for (i = 0; i < 64; i += 8) {
-		t0 = tblock[i+0] + tblock[i+4];
-		t1 = tblock[i+0] - tblock[i+4];
-		t2 = tblock[i+2] + tblock[i+6];
-		t3 = tblock[i+2] - tblock[i+6];
-		t3 = ((t3 * 0xB50) >> 11) - t2;
-
-		t4 = t0 - t2;
-		t5 = t0 + t2;
-		t6 = t1 + t3;
-		t7 = t1 - t3;
-
-		t0 = tblock[i+5] + tblock[i+3];
-		t1 = tblock[i+5] - tblock[i+3];
-		t2 = tblock[i+1] + tblock[i+7];
-		t3 = tblock[i+1] - tblock[i+7];
-
-		t8 = t2 + t0;
-		t9 = t3 + t1;
-		t9 = (0xEC8 * t9) >> 11;
-		tA = ((-0x14E8 * t1) >> 11) + t9 - t8;
-		tB = t2 - t0;
-		tB = ((0xB50 * tB) >> 11) - tA;
-		tC = ((0x8A9 * t3) >> 11) + tB - t9;
-
-		block[i+0] = (t5 + t8 + 0x7F) >> 8;
-		block[i+7] = (t5 - t8 + 0x7F) >> 8;
-		block[i+1] = (t6 + tA + 0x7F) >> 8;
-		block[i+6] = (t6 - tA + 0x7F) >> 8;
-		block[i+2] = (t7 + tB + 0x7F) >> 8;
-		block[i+5] = (t7 - tB + 0x7F) >> 8;
-		block[i+4] = (t4 + tC + 0x7F) >> 8;
-		block[i+3] = (t4 - tC + 0x7F) >> 8;
-	}
-}
-
 static void idct_put(uint8_t *dest, int line_size, DCTELEM *block)
 {
 	bink_idct(block);
@@ -1405,7 +1408,6 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 	//this is compatible only with the BIKi version
 	v_gb.skip_bits(32);
 
-	get_buffer(&c_pic, header.width, header.height);
 	//plane order is YUV
 	for (plane = 0; plane < 3; plane++) {
 		const int stride = c_pic.linesize[plane];
@@ -1458,7 +1460,7 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 				}
 				switch (blk) {
 				case SKIP_BLOCK:
-					copy_block(block, prev, dst, stride);
+					copy_pixels(prev, dst, stride);
 					break;
 				case SCALED_BLOCK:
 					blk = get_value(BINK_SRC_SUB_BLOCK_TYPES);
@@ -1532,7 +1534,7 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 				case MOTION_BLOCK:
 					xoff = get_value(BINK_SRC_X_OFF);
 					yoff = get_value(BINK_SRC_Y_OFF);
-					copy_block(block, prev + xoff + yoff*stride, dst, stride);
+					copy_pixels(prev + xoff + yoff*stride, dst, stride);
 					break;
 				case RUN_BLOCK:
 					scan = bink_patterns[v_gb.get_bits(4)];
@@ -1561,7 +1563,7 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 				case RESIDUE_BLOCK:
 					xoff = get_value(BINK_SRC_X_OFF);
 					yoff = get_value(BINK_SRC_Y_OFF);
-					copy_block(block, prev + xoff + yoff*stride, dst, stride);
+					copy_pixels(prev + xoff + yoff*stride, dst, stride);
 					clear_block(block);
 					v = v_gb.get_bits(7);
 					read_residue(block, v);
@@ -1582,7 +1584,7 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 				case INTER_BLOCK:
 					xoff = get_value(BINK_SRC_X_OFF);
 					yoff = get_value(BINK_SRC_Y_OFF);
-					copy_block(block, prev + xoff + yoff*stride, dst, stride);
+					copy_pixels(prev + xoff + yoff*stride, dst, stride);
 					clear_block(block);
 					block[0] = get_value(BINK_SRC_INTER_DC);
 					read_dct_coeffs(block, c_scantable.permutated,false);
@@ -1613,19 +1615,10 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 		v_gb.get_bits_align32();
 	}
 
-	if (video_frameskip) {
-		video_frameskip--;
-		video_skippedframes++;
-	} else {
-		unsigned int dest_x = (outputwidth - header.width) >> 1;
-		unsigned int dest_y = (outputheight - header.height) >> 1;
-		showFrame((ieByte **) c_pic.data, (unsigned int *) c_pic.linesize, header.width, header.height, header.width, header.height, dest_x, dest_y);
-	}
-
-	//release the old frame even when frame is skipped
-	release_buffer(&c_last);
-	memcpy(&c_last, &c_pic, sizeof(AVFrame));
-	memset(&c_pic, 0, sizeof(AVFrame));
+	//the new frame is the reference for the next one, its buffers get reused
+	AVFrame tmp = c_last;
+	c_last = c_pic;
+	c_pic = tmp;
 	return 0;
 }
 
@@ -28,6 +28,12 @@
 
 #include "Interface.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 // FIXME: This has to be included last, since it defines int*_t, which causes
 // mingw g++ 4.5.0 to choke.
 #include "GetBitContext.h"
@@ -40,6 +46,11 @@ namespace GemRB {
 #define BIK_SIGNATURE_LEN 4
 #define BIK_SIGNATURE_DATA "BIKi"
 
+//how many frames the decoder thread may get ahead of playback
+#define BIK_DECODE_AHEAD 4
+//zeroes after the audio data, so the bit reader can't run off
+#define BIK_AUDIO_PADDING 8
+
 #define MAX_CHANNELS 2
 #define BINK_BLOCK_MAX_SIZE (MAX_CHANNELS << 11)
 
@@ -213,11 +224,30 @@ private:
 	GetBitContext v_gb;
 	AVFrame c_pic, c_last;
 
+	//decoding ahead on another thread, while this one plays
+	struct DecodedFrame {
+		AVFrame pic;
+		std::vector<ieByte> audio;
+		ieDword audioSize = 0;
+	};
+	std::thread decoder;
+	std::mutex queueLock;
+	std::condition_variable queueCond;
+	std::deque<DecodedFrame*> decodedFrames;
+	std::vector<DecodedFrame*> freeFrames;
+	ieDword decodeFrame; //the next frame to decode
+	bool stopDecoding;
+	bool decodingDone;
+
 private:
 	void timer_start();
 	void timer_wait();
 	void segment_video_play();
 	bool next_frame();
+	bool read_frame(DecodedFrame *out);
+	void decode_ahead();
+	void start_decoding();
+	void stop_decoding();
 	int doPlay();
 	unsigned int fileRead(unsigned int pos, void* buf, unsigned int count);
 	void showFrame(unsigned char** buf, unsigned int *strides, unsigned int bufw,
@@ -256,6 +286,7 @@ public:
 	bool Open(DataStream* stream);
 	void CallBackAtFrames(ieDword cnt, ieDword *arg, ieDword *arg2);
 	int Play();	
+	int Decode();
 };
 
 }
@@ -0,0 +1,160 @@
+/*
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file libavcodec/binkdsp.c
+ * Bink IDCT and pixel block routines.
+ * The IDCT passes are plain loops over independent columns and rows, which
+ * compilers vectorize well on their own (SSE2, AVX2 and NEON alike), while
+ * hand written SSE2 intrinsics measured no faster. The pixel routines are
+ * not vectorized automatically, so they have SSE2 versions, which wrap
+ * around the same way as the C ones.
+ */
+
+#include "dsputil.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BINK_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// one pass of the idct over 8 values, step apart
+#define BINK_IDCT_1D(src, dst, step, dstep, munge) { \
+	int t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, tA, tB, tC; \
+	t0 = src[0*step] + src[4*step]; \
+	t1 = src[0*step] - src[4*step]; \
+	t2 = src[2*step] + src[6*step]; \
+	t3 = src[2*step] - src[6*step]; \
+	t3 = ((t3 * 0xB50) >> 11) - t2; \
+	\
+	t4 = t0 - t2; \
+	t5 = t0 + t2; \
+	t6 = t1 + t3; \
+	t7 = t1 - t3; \
+	\
+	t0 = src[5*step] + src[3*step]; \
+	t1 = src[5*step] - src[3*step]; \
+	t2 = src[1*step] + src[7*step]; \
+	t3 = src[1*step] - src[7*step]; \
+	\
+	t8 = t2 + t0; \
+	t9 = t3 + t1; \
+	t9 = (0xEC8 * t9) >> 11; \
+	tA = ((-0x14E8 * t1) >> 11) + t9 - t8; \
+	tB = t2 - t0; \
+	tB = ((0xB50 * tB) >> 11) - tA; \
+	tC = ((0x8A9 * t3) >> 11) + tB - t9; \
+	\
+	dst[0*dstep] = munge(t5 + t8); \
+	dst[7*dstep] = munge(t5 - t8); \
+	dst[1*dstep] = munge(t6 + tA); \
+	dst[6*dstep] = munge(t6 - tA); \
+	dst[2*dstep] = munge(t7 + tB); \
+	dst[5*dstep] = munge(t7 - tB); \
+	dst[4*dstep] = munge(t4 + tC); \
+	dst[3*dstep] = munge(t4 - tC); \
+}
+
+#define MUNGE_NONE(x) (x)
+#define MUNGE_ROW(x) (((x) + 0x7F) >> 8)
+
+//This replaces the j_rev_dct module
+void bink_idct(DCTELEM *block)
+{
+	int i;
+	int tblock[64];
+
+	for (i = 0; i < 8; i++) {
+		const DCTELEM *src = block + i;
+		int *dst = tblock + i;
+		BINK_IDCT_1D(src, dst, 8, 8, MUNGE_NONE);
+	}
+	for (i = 0; i < 64; i += 8) {
+		const int *src = tblock + i;
+		DCTELEM *dst = block + i;
+		BINK_IDCT_1D(src, dst, 1, 1, MUNGE_ROW);
+	}
+}
+
+#ifndef BINK_SSE2
+
+void put_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
+{
+	for (int i = 0; i < 8; i++) {
+		for (int j = 0; j < 8; j++) {
+			pixels[j] = (uint8_t) block[j];
+		}
+		pixels += line_size;
+		block += 8;
+	}
+}
+
+void add_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
+{
+	for (int i = 0; i < 8; i++) {
+		for (int j = 0; j < 8; j++) {
+			pixels[j] += block[j];
+		}
+		pixels += line_size;
+		block += 8;
+	}
+}
+
+#else
+
+void put_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
+{
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	for (int i = 0; i < 8; i += 2) {
+		__m128i a = _mm_and_si128(_mm_loadu_si128((const __m128i *) block), mask);
+		__m128i b = _mm_and_si128(_mm_loadu_si128((const __m128i *) (block + 8)), mask);
+		__m128i p = _mm_packus_epi16(a, b);
+		_mm_storel_epi64((__m128i *) pixels, p);
+		_mm_storel_epi64((__m128i *) (pixels + line_size), _mm_srli_si128(p, 8));
+		pixels += 2 * line_size;
+		block += 16;
+	}
+}
+
+void add_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
+{
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	const __m128i zero = _mm_setzero_si128();
+	for (int i = 0; i < 8; i++) {
+		__m128i p = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) pixels), zero);
+		p = _mm_add_epi16(p, _mm_loadu_si128((const __m128i *) block));
+		p = _mm_and_si128(p, mask);
+		_mm_storel_epi64((__m128i *) pixels, _mm_packus_epi16(p, p));
+		pixels += line_size;
+		block += 8;
+	}
+}
+
+#endif
+
+void copy_pixels(const uint8_t *src, uint8_t *dst, int line_size)
+{
+	for (int i = 0; i < 8; i++) {
+		memcpy(dst, src, 8);
+		src += line_size;
+		dst += line_size;
+	}
+}
@@ -227,4 +227,20 @@ int ff_dct_init(DCTContext *s, int nbits, int inverse);
 void ff_dct_calc(DCTContext *s, FFTSample *data);
 void ff_dct_end(DCTContext *s);
 
+/* Bink video */
+
+/**
+ * Inverse transforms a block of Bink DCT coefficients in place.
+ */
+void bink_idct(DCTELEM *block);
+/**
+ * Stores (or adds) an 8x8 block to the pixels, wrapping around instead of clamping.
+ */
+void put_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size);
+void add_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size);
+/**
+ * Copies an 8x8 block of pixels.
+ */
+void copy_pixels(const uint8_t *src, uint8_t *dst, int line_size);
+
 #endif /* AVCODEC_DSPUTIL_H */
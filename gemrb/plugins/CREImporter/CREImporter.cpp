@@ -31,6 +31,7 @@
 #include "RNG.h"
 #include "TableMgr.h"
 #include "GameScript/GameScript.h"
+#include "System/SpanReader.h"
 
 #include <cassert>
 #include <cmath>
@@ -825,23 +826,23 @@ bool CREImporter::SeekCreHeader(char *Signature)
 	return true;
 }
 
-CREMemorizedSpell* CREImporter::GetMemorizedSpell()
+CREMemorizedSpell* CREImporter::GetMemorizedSpell(SpanReader& table)
 {
 	CREMemorizedSpell* spl = new CREMemorizedSpell();
 
-	str->ReadResRef( spl->SpellResRef );
-	str->ReadDword( &spl->Flags );
+	table.ReadResRef( spl->SpellResRef );
+	table.ReadDword( &spl->Flags );
 
 	return spl;
 }
 
-CREKnownSpell* CREImporter::GetKnownSpell()
+CREKnownSpell* CREImporter::GetKnownSpell(SpanReader& table)
 {
 	CREKnownSpell* spl = new CREKnownSpell();
 
-	str->ReadResRef( spl->SpellResRef );
-	str->ReadWord( &spl->Level );
-	str->ReadWord( &spl->Type );
+	table.ReadResRef( spl->SpellResRef );
+	table.ReadWord( &spl->Level );
+	table.ReadWord( &spl->Type );
 
 	return spl;
 }
@@ -853,16 +854,16 @@ void CREImporter::ReadScript(Actor *act, int ScriptLevel)
 	act->SetScript( aScript, ScriptLevel, act->InParty!=0);
 }
 
-CRESpellMemorization* CREImporter::GetSpellMemorization(Actor *act)
+CRESpellMemorization* CREImporter::GetSpellMemorization(Actor *act, SpanReader& table)
 {
-	ieWord Level, Type, Number, Number2;
+	ieWord Level = 0, Type = 0, Number = 0, Number2 = 0;
 
-	str->ReadWord( &Level );
-	str->ReadWord( &Number );
-	str->ReadWord( &Number2 );
-	str->ReadWord( &Type );
-	str->ReadDword( &MemorizedIndex );
-	str->ReadDword( &MemorizedCount );
+	table.ReadWord( &Level );
+	table.ReadWord( &Number );
+	table.ReadWord( &Number2 );
+	table.ReadWord( &Type );
+	table.ReadDword( &MemorizedIndex );
+	table.ReadDword( &MemorizedCount );
 
 	CRESpellMemorization* spl = act->spellbook.GetSpellMemorization(Type, Level);
 	assert(spl && spl->SlotCount == 0 && spl->SlotCountWithBonus == 0); // unused
@@ -1258,8 +1259,9 @@ void CREImporter::ReadInventory(Actor *act, unsigned int Inventory_Size)
 	str->Seek( ItemSlotsOffset+CREOffset, GEM_STREAM_START );
 
 	//first read the indices
+	SpanReader slots(str, Inventory_Size * 2 + 4);
 	for (unsigned int i = 0; i < Inventory_Size; i++) {
-		str->ReadWord(indices+i);
+		slots.ReadWord(indices+i);
 	}
 	//this word contains the equipping info (which slot is selected)
 	// 0,1,2,3 - weapon slots
@@ -1267,9 +1269,9 @@ void CREImporter::ReadInventory(Actor *act, unsigned int Inventory_Size)
 	// -24,-23,-22,-21 - quiver
 	// -1 is one of the plain inventory slots, but creatures like belhif.cre have it set as the equipped slot; see below
 	//the equipping effects are delayed until the actor gets an area
-	str->ReadWordSigned(&eqslot);
+	slots.ReadWordSigned(&eqslot);
 	//the equipped slot's selected ability is stored here
-	str->ReadWord(&eqheader);
+	slots.ReadWord(&eqheader);
 	act->inventory.SetEquipped(eqslot, eqheader);
 
 	//read the item entries based on the previously read indices
@@ -1309,18 +1311,21 @@ void CREImporter::ReadInventory(Actor *act, unsigned int Inventory_Size)
 	CREMemorizedSpell **memorized_spells=(CREMemorizedSpell **) calloc(MemorizedSpellsCount, sizeof(CREMemorizedSpell *) );
 
 	str->Seek( KnownSpellsOffset+CREOffset, GEM_STREAM_START );
+	SpanReader knownTable(str, KnownSpellsCount * 12);
 	for (unsigned int i = 0; i < KnownSpellsCount; i++) {
-		known_spells[i]=GetKnownSpell();
+		known_spells[i]=GetKnownSpell(knownTable);
 	}
 
 	str->Seek( MemorizedSpellsOffset+CREOffset, GEM_STREAM_START );
+	SpanReader memorizedTable(str, MemorizedSpellsCount * 12);
 	for (unsigned int i = 0; i < MemorizedSpellsCount; i++) {
-		memorized_spells[i]=GetMemorizedSpell();
+		memorized_spells[i]=GetMemorizedSpell(memorizedTable);
 	}
 
 	str->Seek( SpellMemorizationOffset+CREOffset, GEM_STREAM_START );
+	SpanReader memorizationTable(str, SpellMemorizationCount * 16);
 	for (unsigned int i = 0; i < SpellMemorizationCount; i++) {
-		CRESpellMemorization* sm = GetSpellMemorization(act);
+		CRESpellMemorization* sm = GetSpellMemorization(act, memorizationTable);
 
 		unsigned int j = KnownSpellsCount;
 		while(j--) {
@@ -27,6 +27,7 @@
 namespace GemRB {
 
 class CREItem;
+class SpanReader;
 struct Effect;
 
 #define IE_CRE_GEMRB            0
@@ -96,9 +97,9 @@ private:
 	void GetEffect(Effect *fx);
 	void ReadScript(Actor *actor, int ScriptLevel);
 	void ReadDialog(Actor *actor);
-	CREKnownSpell* GetKnownSpell();
-	CRESpellMemorization* GetSpellMemorization(Actor *act);
-	CREMemorizedSpell* GetMemorizedSpell();
+	CREKnownSpell* GetKnownSpell(SpanReader& table);
+	CRESpellMemorization* GetSpellMemorization(Actor *act, SpanReader& table);
+	CREMemorizedSpell* GetMemorizedSpell(SpanReader& table);
 	CREItem* GetItem();
 	void SetupColor(ieDword&);
 	int GetHpAdjustment(Actor *actor);
@@ -26,6 +26,8 @@
 #include "GameScript/GameScript.h"
 #include "System/FileStream.h"
 
+#include <algorithm>
+
 using namespace GemRB;
 
 DLGImporter::DLGImporter(void)
@@ -93,16 +95,22 @@ Dialog* DLGImporter::GetDialog() const
 	Dialog* d = new Dialog();
 	d->Flags = Flags;
 	d->TopLevelCount = StatesCount;
-	d->Order = (unsigned int *) calloc (StatesCount, sizeof(unsigned int) );
 	d->initialStates = (DialogState **) calloc (StatesCount, sizeof(DialogState *) );
 	for (unsigned int i = 0; i < StatesCount; i++) {
-		DialogState* ds = GetDialogState( d, i );
+		DialogState* ds = GetDialogState( i );
 		d->initialStates[i] = ds;
+		if (ds->condition && ds->weight < StatesCount) {
+			d->Order.push_back(i);
+		}
 	}
+	// states are tried in the order of their triggers, not their own
+	std::stable_sort(d->Order.begin(), d->Order.end(), [d](unsigned int a, unsigned int b) {
+		return d->initialStates[a]->weight < d->initialStates[b]->weight;
+	});
 	return d;
 }
 
-DialogState* DLGImporter::GetDialogState(Dialog *d, unsigned int index) const
+DialogState* DLGImporter::GetDialogState(unsigned int index) const
 {
 	DialogState* ds = new DialogState();
 	//16 = sizeof(State)
@@ -115,8 +123,7 @@ DialogState* DLGImporter::GetDialogState(Dialog *d, unsigned int index) const
 	str->ReadDword( &TriggerIndex );
 	ds->condition = GetStateTrigger( TriggerIndex );
 	ds->transitions = GetTransitions( FirstTransitionIndex, ds->transitionsCount );
-	if (TriggerIndex<StatesCount)
-		d->Order[TriggerIndex] = index;
+	ds->weight = TriggerIndex;
 	return ds;
 }
 
@@ -75,7 +75,7 @@ public:
 	Dialog* GetDialog() const;
 	Condition* GetCondition(char *string) const;
 private:
-	DialogState* GetDialogState(Dialog *d, unsigned int index) const;
+	DialogState* GetDialogState(unsigned int index) const;
 	DialogTransition* GetTransition(unsigned int index) const;
 	Condition* GetStateTrigger(unsigned int index) const;
 	Condition* GetTransitionTrigger(unsigned int index) const;
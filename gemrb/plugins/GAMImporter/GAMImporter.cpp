@@ -31,6 +31,7 @@
 #include "TableMgr.h"
 #include "Scriptable/Actor.h"
 #include "System/SlicedStream.h"
+#include "System/SpanReader.h"
 
 #include <cassert>
 
@@ -228,12 +229,13 @@ Game* GAMImporter::LoadGame(Game *newGame, int ver_override)
 	ieVariable Name;
 	Name[32] = 0;
 	str->Seek( GlobalOffset, GEM_STREAM_START );
+	SpanReader globals(str, GlobalCount * 84);
 	for (i = 0; i < GlobalCount; i++) {
 		ieDword Value;
-		str->Read( Name, 32 );
-		str->Seek( 8, GEM_CURRENT_POS );
-		str->ReadDword( &Value );
-		str->Seek( 40, GEM_CURRENT_POS );
+		globals.Read( Name, 32 );
+		globals.Skip( 8 );
+		globals.ReadDword( &Value );
+		globals.Skip( 40 );
 		newGame->locals->SetAt( Name, Value );
 	}
 	if(core->HasFeature(GF_HAS_KAPUTZ) ) {
@@ -243,20 +245,22 @@ Game* GAMImporter::LoadGame(Game *newGame, int ver_override)
 		// load initial values from var.var
 		newGame->kaputz->LoadInitialValues("KAPUTZ");
 		str->Seek( KillVarsOffset, GEM_STREAM_START );
+		SpanReader killVars(str, KillVarsCount * 84);
 		for (i = 0; i < KillVarsCount; i++) {
 			ieDword Value;
-			str->Read( Name, 32 );
-			str->Seek( 8, GEM_CURRENT_POS );
-			str->ReadDword( &Value );
-			str->Seek( 40, GEM_CURRENT_POS );
+			killVars.Read( Name, 32 );
+			killVars.Skip( 8 );
+			killVars.ReadDword( &Value );
+			killVars.Skip( 40 );
 			newGame->kaputz->SetAt( Name, Value );
 		}
 	}
 
 	//Loading Journal entries
 	str->Seek( JournalOffset, GEM_STREAM_START );
+	SpanReader journal(str, JournalCount * 12);
 	for (i = 0; i < JournalCount; i++) {
-		GAMJournalEntry* je = GetJournalEntry();
+		GAMJournalEntry* je = GetJournalEntry(journal);
 		newGame->AddJournalEntry( je );
 	}
 
@@ -299,11 +303,12 @@ Game* GAMImporter::LoadGame(Game *newGame, int ver_override)
 		ieWord PosX, PosY;
 
 		str->Seek( SavedLocOffset, GEM_STREAM_START );
+		SpanReader locations(str, SavedLocCount * 12);
 		for (i=0; i<SavedLocCount; i++) {
 			GAMLocationEntry *gle = newGame->GetSavedLocationEntry(i);
-			str->ReadResRef( gle->AreaResRef );
-			str->ReadWord( &PosX );
-			str->ReadWord( &PosY );
+			locations.ReadResRef( gle->AreaResRef );
+			locations.ReadWord( &PosX );
+			locations.ReadWord( &PosY );
 			gle->Pos.x=PosX;
 			gle->Pos.y=PosY;
 		}
@@ -313,11 +318,12 @@ Game* GAMImporter::LoadGame(Game *newGame, int ver_override)
 		ieWord PosX, PosY;
 
 		str->Seek( PPLocOffset, GEM_STREAM_START );
+		SpanReader locations(str, PPLocCount * 12);
 		for (i=0; i<PPLocCount; i++) {
 			GAMLocationEntry *gle = newGame->GetPlaneLocationEntry(i);
-			str->ReadResRef( gle->AreaResRef );
-			str->ReadWord( &PosX );
-			str->ReadWord( &PosY );
+			locations.ReadResRef( gle->AreaResRef );
+			locations.ReadWord( &PosX );
+			locations.ReadWord( &PosY );
 			gle->Pos.x=PosX;
 			gle->Pos.y=PosY;
 		}
@@ -570,17 +576,17 @@ void GAMImporter::GetPCStats (PCStatsStruct *ps, bool extended)
 	}
 }
 
-GAMJournalEntry* GAMImporter::GetJournalEntry()
+GAMJournalEntry* GAMImporter::GetJournalEntry(SpanReader& table)
 {
 	GAMJournalEntry* j = new GAMJournalEntry();
 
-	str->ReadDword( &j->Text );
-	str->ReadDword( &j->GameTime );
+	table.ReadDword( &j->Text );
+	table.ReadDword( &j->GameTime );
 	//this could be wrong, most likely these are 2 words, or a dword
-	str->Read( &j->Chapter, 1 );
-	str->Read( &j->unknown09, 1 );
-	str->Read( &j->Section, 1 );
-	str->Read( &j->Group, 1 ); // this is a GemRB extension
+	table.Read( &j->Chapter, 1 );
+	table.Read( &j->unknown09, 1 );
+	table.Read( &j->Section, 1 );
+	table.Read( &j->Group, 1 ); // this is a GemRB extension
 
 	return j;
 }
@@ -27,6 +27,8 @@
 
 namespace GemRB {
 
+class SpanReader;
+
 #define GAM_VER_GEMRB  0 
 #define GAM_VER_BG  10   
 #define GAM_VER_IWD 11  
@@ -61,7 +63,7 @@ public:
 private:
 	Actor* GetActor(Holder<ActorMgr> aM, bool is_in_party );
 	void GetPCStats(PCStatsStruct* ps, bool extended);
-	GAMJournalEntry* GetJournalEntry();
+	GAMJournalEntry* GetJournalEntry(SpanReader& table);
 
 	int PutHeader(DataStream *stream, Game *game);
 	int PutActor(DataStream *stream, Actor *ac, ieDword CRESize, ieDword CREOffset, ieDword version);
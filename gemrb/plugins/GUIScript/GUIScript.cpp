@@ -23,6 +23,7 @@
 #include "PythonHelpers.h"
 
 #include "Audio.h"
+#include "Benchmark.h"
 #include "CharAnimations.h"
 #include "ControlAnimation.h"
 #include "DataFileMgr.h"
@@ -6178,6 +6179,24 @@ static PyObject* GemRB_DumpActor(PyObject * /*self*/, PyObject * args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_DumpCacheStats__doc,
+"===== DumpCacheStats =====\n\
+\n\
+**Prototype:** GemRB.DumpCacheStats ()\n\
+\n\
+**Description:** Prints how well the item, spell, effect and palette caches \n\
+are doing: their size, hit rate and evictions. Meant for the console.\n\
+\n\
+**Parameters:** N/A\n\
+\n\
+**Return value:** N/A"
+);
+static PyObject* GemRB_DumpCacheStats(PyObject * /*self*/, PyObject * /*args*/)
+{
+	gamedata->DumpCacheStats();
+	Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR( GemRB_SaveCharacter__doc,
 "===== SaveCharacter =====\n\
 \n\
@@ -10089,6 +10108,22 @@ static PyObject* GemRB_UpdateAmbientsVolume(PyObject * /*self*/, PyObject* /*arg
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_ProfileScripts__doc,
+			 "ProfileScripts(enable)\n\n"
+			 "Start or stop measuring the time spent in python. Stopping logs the time per frame and per function." );
+
+static PyObject* GemRB_ProfileScripts(PyObject * /*self*/, PyObject* args)
+{
+	int enable;
+	if (!PyArg_ParseTuple( args, "i", &enable )) {
+		return AttributeError( GemRB_ProfileScripts__doc );
+	}
+
+	gs->SetProfiling(enable != 0);
+
+	Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR( GemRB_MessageWindowDebug__doc,
 			 "MessageWindowDebug(log_level)\n\n"
 			 "Enable/Disable debug messages of log_level in the MessageWindow." );
@@ -15595,6 +15630,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(DrawWindows, METH_NOARGS),
 	METHOD(DropDraggedItem, METH_VARARGS),
 	METHOD(DumpActor, METH_VARARGS),
+	METHOD(DumpCacheStats, METH_NOARGS),
 	METHOD(EnableCheatKeys, METH_VARARGS),
 	METHOD(EndCutSceneMode, METH_NOARGS),
 	METHOD(EnterGame, METH_NOARGS),
@@ -15722,6 +15758,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(PlaySound, METH_VARARGS),
 	METHOD(PlayMovie, METH_VARARGS),
 	METHOD(PrepareSpontaneousCast, METH_VARARGS),
+	METHOD(ProfileScripts, METH_VARARGS),
 	METHOD(RemoveItem, METH_VARARGS),
 	METHOD(RemoveSpell, METH_VARARGS),
 	METHOD(RemoveEffects, METH_VARARGS),
@@ -15887,11 +15924,15 @@ GUIScript::GUIScript(void)
 	pModule = NULL; //should decref it
 	pMainDic = NULL; //borrowed, but used outside a function
 	pGUIClasses = NULL;
+	profiling = false;
+	profiledFrames = 0;
+	frameTime = totalFrameTime = worstFrameTime = 0.0;
 }
 
 GUIScript::~GUIScript(void)
 {
 	if (Py_IsInitialized()) {
+		ClearFunctionCache();
 		if (pModule) {
 			Py_DECREF( pModule );
 		}
@@ -16133,6 +16174,8 @@ bool GUIScript::LoadScript(const char* filename)
 	if (pModule) {
 		Py_DECREF( pModule );
 	}
+	// scripts may get reloaded, so resolve everything anew
+	ClearFunctionCache();
 
 	pModule = PyImport_Import( pName );
 	Py_DECREF( pName );
@@ -16150,11 +16193,70 @@ bool GUIScript::LoadScript(const char* filename)
 	return true;
 }
 
-/* Similar to RunFunction, but with parameters, and doesn't necessarily fail */
-PyObject *GUIScript::RunFunction(const char* moduleName, const char* functionName, PyObject* pArgs, bool report_error)
+static unsigned long FunctionHash(const char* moduleName, const char* functionName)
 {
-	if (!Py_IsInitialized()) {
-		return NULL;
+	// FNV-1a over "module.function"
+	unsigned long hash = 2166136261u;
+	if (moduleName) {
+		for (const char* c = moduleName; *c; c++) {
+			hash = (hash ^ (unsigned char) *c) * 16777619u;
+		}
+	}
+	hash = (hash ^ '.') * 16777619u;
+	for (const char* c = functionName; *c; c++) {
+		hash = (hash ^ (unsigned char) *c) * 16777619u;
+	}
+	return hash;
+}
+
+bool GUIScript::IsValid(const CachedFunction& entry) const
+{
+	// the module could have been reloaded or replaced in sys.modules
+	if (entry.moduleKey) {
+		if (PyDict_GetItem(PyImport_GetModuleDict(), entry.moduleKey) != entry.module) {
+			return false;
+		}
+	} else if (entry.module != pModule) {
+		return false;
+	}
+	// ... or the function redefined
+	return PyDict_GetItem(PyModule_GetDict(entry.module), entry.functionKey) == entry.function;
+}
+
+void GUIScript::ReleaseFunction(CachedFunction& entry)
+{
+	Py_XDECREF(entry.moduleKey);
+	Py_DECREF(entry.functionKey);
+	Py_DECREF(entry.module);
+	Py_DECREF(entry.function);
+}
+
+void GUIScript::ClearFunctionCache()
+{
+	std::multimap<unsigned long, CachedFunction>::iterator it;
+	for (it = functionCache.begin(); it != functionCache.end(); ++it) {
+		ReleaseFunction(it->second);
+	}
+	functionCache.clear();
+}
+
+/* returns a borrowed reference to the function, resolving it only on first use */
+PyObject* GUIScript::GetFunction(const char* moduleName, const char* functionName, bool report_error)
+{
+	unsigned long hash = FunctionHash(moduleName, functionName);
+	std::pair<std::multimap<unsigned long, CachedFunction>::iterator, std::multimap<unsigned long, CachedFunction>::iterator> range;
+	range = functionCache.equal_range(hash);
+	for (std::multimap<unsigned long, CachedFunction>::iterator it = range.first; it != range.second; ++it) {
+		CachedFunction& entry = it->second;
+		if (entry.functionName != functionName || entry.moduleName != (moduleName ? moduleName : "")) {
+			continue;
+		}
+		if (IsValid(entry)) {
+			return entry.function;
+		}
+		ReleaseFunction(entry);
+		functionCache.erase(it);
+		break;
 	}
 
 	PyObject *module;
@@ -16179,23 +16281,55 @@ PyObject *GUIScript::RunFunction(const char* moduleName, const char* functionNam
 		Py_DECREF(module);
 		return NULL;
 	}
+
+	CachedFunction entry;
+	entry.moduleName = moduleName ? moduleName : "";
+	entry.functionName = functionName;
+	entry.moduleKey = moduleName ? PyString_InternFromString(moduleName) : NULL;
+	entry.functionKey = PyString_InternFromString(functionName);
+	entry.module = module;
+	entry.function = pFunc;
+	Py_INCREF(pFunc);
+	functionCache.insert(std::make_pair(hash, entry));
+	return pFunc;
+}
+
+/* Similar to RunFunction, but with parameters, and doesn't necessarily fail */
+PyObject *GUIScript::RunFunction(const char* moduleName, const char* functionName, PyObject* pArgs, bool report_error)
+{
+	if (!Py_IsInitialized()) {
+		return NULL;
+	}
+
+	PyObject *pFunc = GetFunction(moduleName, functionName, report_error);
+	if (!pFunc) {
+		return NULL;
+	}
+	// the call could reload the module and drop the cached reference
+	Py_INCREF(pFunc);
+	BenchmarkTimer timer;
 	PyObject *pValue = PyObject_CallObject( pFunc, pArgs );
 	if (pValue == NULL) {
 		if (PyErr_Occurred()) {
 			PyErr_Print();
 		}
 	}
-	Py_DECREF(module);
+	if (profiling) {
+		ProfileCall(std::string(moduleName ? moduleName : "") + "." + functionName, timer.Elapsed());
+	}
+	Py_DECREF(pFunc);
 	return pValue;
 }
 
+// builds the argument tuples directly, skipping the Py_BuildValue format parsing
 bool GUIScript::RunFunction(const char *moduleName, const char* functionName, bool report_error, int intparam)
 {
 	PyObject *pArgs;
 	if (intparam == -1) {
 		pArgs = NULL;
 	} else {
-		pArgs = Py_BuildValue("(i)", intparam);
+		pArgs = PyTuple_New(1);
+		PyTuple_SET_ITEM(pArgs, 0, PyInt_FromLong(intparam));
 	}
 	PyObject *pValue = RunFunction(moduleName, functionName, pArgs, report_error);
 	Py_XDECREF(pArgs);
@@ -16211,7 +16345,9 @@ bool GUIScript::RunFunction(const char *moduleName, const char* functionName, bo
 
 bool GUIScript::RunFunction(const char *moduleName, const char* functionName, bool report_error, Point param)
 {
-	PyObject *pArgs = Py_BuildValue("(ii)", param.x, param.y);
+	PyObject *pArgs = PyTuple_New(2);
+	PyTuple_SET_ITEM(pArgs, 0, PyInt_FromLong(param.x));
+	PyTuple_SET_ITEM(pArgs, 1, PyInt_FromLong(param.y));
 	PyObject *pValue = RunFunction(moduleName, functionName, pArgs, report_error);
 	Py_XDECREF(pArgs);
 	if (pValue == NULL) {
@@ -16224,6 +16360,63 @@ bool GUIScript::RunFunction(const char *moduleName, const char* functionName, bo
 	return true;
 }
 
+void GUIScript::ProfileCall(const std::string& name, double elapsed)
+{
+	ScriptProfile& entry = profile[name];
+	entry.calls++;
+	entry.total += elapsed;
+	if (elapsed > entry.worst) {
+		entry.worst = elapsed;
+	}
+	frameTime += elapsed;
+}
+
+void GUIScript::EndFrame()
+{
+	if (!profiling) {
+		return;
+	}
+	profiledFrames++;
+	totalFrameTime += frameTime;
+	if (frameTime > worstFrameTime) {
+		worstFrameTime = frameTime;
+	}
+	frameTime = 0.0;
+}
+
+static bool ProfileTotalGreater(const std::pair<std::string, double>& a, const std::pair<std::string, double>& b)
+{
+	return a.second > b.second;
+}
+
+void GUIScript::SetProfiling(bool enable)
+{
+	if (enable == profiling) {
+		return;
+	}
+	profiling = enable;
+	if (enable) {
+		profile.clear();
+		profiledFrames = 0;
+		frameTime = totalFrameTime = worstFrameTime = 0.0;
+		return;
+	}
+
+	Log(MESSAGE, "GUIScript", "Python time over %lu frames: %.3fms per frame, worst frame %.3fms",
+		profiledFrames, profiledFrames ? totalFrameTime / profiledFrames : 0.0, worstFrameTime);
+	std::vector<std::pair<std::string, double> > totals;
+	std::map<std::string, ScriptProfile>::const_iterator it;
+	for (it = profile.begin(); it != profile.end(); ++it) {
+		totals.push_back(std::make_pair(it->first, it->second.total));
+	}
+	std::sort(totals.begin(), totals.end(), ProfileTotalGreater);
+	for (size_t i = 0; i < totals.size(); i++) {
+		const ScriptProfile& entry = profile[totals[i].first];
+		Log(MESSAGE, "GUIScript", "%s: %lu calls, %.3fms total, %.3fms average, %.3fms worst",
+			totals[i].first.c_str(), entry.calls, entry.total, entry.total / entry.calls, entry.worst);
+	}
+}
+
 void GUIScript::ExecFile(const char* file)
 {
 	FileStream fs;
@@ -27,6 +27,9 @@
 
 #include "ScriptEngine.h"
 
+#include <map>
+#include <string>
+
 namespace GemRB {
 
 enum {
@@ -43,6 +46,32 @@ public:
 	PyObject* pModule, * pDict;
 	PyObject* pMainDic;
 	PyObject* pGUIClasses;
+private:
+	/** a resolved module function, revalidated against the module dictionaries on use */
+	struct CachedFunction {
+		std::string moduleName;
+		std::string functionName;
+		PyObject* moduleKey; // interned module name, NULL for the loaded script
+		PyObject* functionKey; // interned function name
+		PyObject* module;
+		PyObject* function;
+	};
+	std::multimap<unsigned long, CachedFunction> functionCache;
+
+	struct ScriptProfile {
+		unsigned long calls;
+		double total;
+		double worst;
+	};
+	bool profiling;
+	std::map<std::string, ScriptProfile> profile;
+	unsigned long profiledFrames;
+	double frameTime, totalFrameTime, worstFrameTime;
+
+	PyObject* GetFunction(const char* moduleName, const char* functionName, bool report_error);
+	bool IsValid(const CachedFunction& entry) const;
+	void ReleaseFunction(CachedFunction& entry);
+	void ClearFunctionCache();
 public:
 	GUIScript(void);
 	~GUIScript(void);
@@ -63,6 +92,11 @@ public:
 	PyObject *RunFunction(const char* moduleName, const char* fname, PyObject* pArgs, bool report_error = true);
 	PyObject* ConstructObject(const char* classname, int arg);
 	PyObject* ConstructObject(const char* classname, PyObject* pArgs);
+	void EndFrame();
+	/** starts or stops measuring time spent in python, stopping logs the results */
+	void SetProfiling(bool enable);
+	bool IsProfiling() const { return profiling; }
+	void ProfileCall(const std::string& name, double elapsed);
 };
 
 extern GUIScript *gs;
@@ -19,6 +19,8 @@
  */
 
 #include "PythonHelpers.h"
+
+#include "Benchmark.h"
 #include "GUI/Window.h"
 
 using namespace GemRB;
@@ -58,10 +60,13 @@ bool PythonObjectCallback<Control>::operator() (Control* ctrl)
 	}
 
 	PyObject *args = NULL;
-	PyObject* func_code = PyObject_GetAttrString(Function, "func_code");
-	PyObject* co_argcount = PyObject_GetAttrString(func_code, "co_argcount");
-	const int count = PyInt_AsLong(co_argcount);
 	if (/*count*/ false) { // FIXME: this code is incomplete and would break things without being finished
+		// only look up the argument count here, it is too costly to do on every event
+		PyObject* func_code = PyObject_GetAttrString(Function, "func_code");
+		PyObject* co_argcount = PyObject_GetAttrString(func_code, "co_argcount");
+		const int count = PyInt_AsLong(co_argcount);
+		Py_DECREF(func_code);
+		Py_DECREF(co_argcount);
 		assert(count == 1);
 		const char* type = "Control";
 		switch(ctrl->ControlType) {
@@ -93,8 +98,6 @@ bool PythonObjectCallback<Control>::operator() (Control* ctrl)
 		Py_DECREF(ctrltuple);
 		args = Py_BuildValue("(i)", obj);
 	}
-	Py_DECREF(func_code);
-	Py_DECREF(co_argcount);
 	return CallPython(Function, args);
 }
 
@@ -112,20 +115,36 @@ bool PythonObjectCallback<WindowKeyPress>::operator() (WindowKeyPress *wkp) {
 	return result > 0;
 }
 
+static void ProfileCallback(PyObject *Function, double elapsed)
+{
+	std::string name = "<callback>";
+	PyObject* module = PyObject_GetAttrString(Function, "__module__");
+	PyObject* fname = PyObject_GetAttrString(Function, "__name__");
+	if (module && fname && PyString_Check(module) && PyString_Check(fname)) {
+		name = std::string(PyString_AsString(module)) + "." + PyString_AsString(fname);
+	}
+	Py_XDECREF(module);
+	Py_XDECREF(fname);
+	PyErr_Clear();
+	gs->ProfileCall(name, elapsed);
+}
+
 static PyObject* CallPythonObject(PyObject *Function, PyObject *args) {
 	if (!Function) {
 		return NULL;
 	}
 
+	BenchmarkTimer timer;
 	PyObject *ret = PyObject_CallObject(Function, args);
 	Py_XDECREF( args );
 	if (ret == NULL) {
 		if (PyErr_Occurred()) {
 			PyErr_Print();
 		}
-		return NULL;
 	}
-
+	if (gs->IsProfiling()) {
+		ProfileCallback(Function, timer.Elapsed());
+	}
 	return ret;
 }
 
@@ -26,9 +26,32 @@
 #include "FileCache.h"
 #include "Interface.h"
 #include "Video.h"
+#include "System/WorkerPool.h"
+
+#include <condition_variable>
+#include <mutex>
 
 using namespace GemRB;
 
+// images smaller than this are converted on the calling thread alone
+#define MOS_PARALLEL_PIXELS (256 * 256)
+
+// converts the block rows of big mos files side by side
+static WorkerPool* decoders = NULL;
+static int decoderCount = 0;
+
+static void CreateDecoders()
+{
+	decoderCount = WorkerPool::DefaultThreads();
+	decoders = new WorkerPool(decoderCount);
+}
+
+static void ReleaseMemory()
+{
+	delete decoders;
+	decoders = NULL;
+}
+
 static ieDword red_mask = 0x00ff0000;
 static ieDword green_mask = 0x0000ff00;
 static ieDword blue_mask = 0x000000ff;
@@ -70,64 +93,185 @@ bool MOSImporter::Open(DataStream* stream)
 	str->ReadWord( &Rows );
 	str->ReadDword( &BlockSize );
 	str->ReadDword( &PalOffset );
+
+	// the block palettes and offsets are read in one go each, they are
+	// little endian like the rest of the file
+	size_t blocks = Rows * Cols;
+	palettes.resize(blocks * 256);
+	std::vector<unsigned char> raw(blocks * 4);
+	str->Seek(PalOffset, GEM_STREAM_START);
+	if (str->Read(palettes.data(), blocks * 1024) != (int) (blocks * 1024) ||
+		str->Read(raw.data(), raw.size()) != (int) raw.size()) {
+		Log(WARNING, "MOSImporter", "Truncated MOS file.");
+		return false;
+	}
+	offsets.resize(blocks);
+	for (size_t i = 0; i < blocks; i++) {
+		const unsigned char* b = &raw[i * 4];
+		offsets[i] = b[0] | (b[1] << 8) | (b[2] << 16) | ((ieDword) b[3] << 24);
+	}
 	return true;
 }
 
+void MOSImporter::GetBlockSize(int x, int y, int& bw, int& bh) const
+{
+	bw = ( x == Cols - 1 ) ? ( ( Width % 64 ) == 0 ? 64 : Width % 64 ) : 64;
+	bh = ( y == Rows - 1 ) ? ( ( Height % 64 ) == 0 ? 64 : Height % 64 ) : 64;
+}
+
+// converts the part of rgn covered by the given blocks, pixels is the size of rgn
+void MOSImporter::DecodeBlocks(const std::vector<const unsigned char*>& blocks, int firstRow, int lastRow,
+	int firstCol, int lastCol, const Region& rgn, ieDword* pixels) const
+{
+	for (int y = firstRow; y <= lastRow; y++) {
+		for (int x = firstCol; x <= lastCol; x++) {
+			const unsigned char* block = blocks[y * Cols + x];
+			if (!block) {
+				continue;
+			}
+			int bw, bh;
+			GetBlockSize(x, y, bw, bh);
+			const ieDword* pal = &palettes[(y * Cols + x) * 256];
+			int left = std::max<int>(x * 64, rgn.x);
+			int right = std::min<int>(x * 64 + bw, rgn.x + rgn.w);
+			int top = std::max<int>(y * 64, rgn.y);
+			int bottom = std::min<int>(y * 64 + bh, rgn.y + rgn.h);
+			for (int h = top; h < bottom; h++) {
+				const unsigned char* bp = block + (h - y * 64) * bw + (left - x * 64);
+				ieDword* dest = pixels + (h - rgn.y) * rgn.w + (left - rgn.x);
+				for (int w = left; w < right; w++) {
+					*dest++ = pal[*bp++];
+				}
+			}
+		}
+	}
+}
+
+// splits the block rows of rgn between the decoders and the calling thread
+void MOSImporter::Decode(const std::vector<const unsigned char*>& blocks, const Region& rgn, ieDword* pixels) const
+{
+	if (rgn.w <= 0 || rgn.h <= 0) {
+		return;
+	}
+	// corrupt headers may have fewer blocks than their size needs
+	int firstRow = rgn.y / 64;
+	int lastRow = std::min((rgn.y + rgn.h - 1) / 64, Rows - 1);
+	int firstCol = rgn.x / 64;
+	int lastCol = std::min((rgn.x + rgn.w - 1) / 64, Cols - 1);
+	if (firstRow > lastRow || firstCol > lastCol) {
+		return;
+	}
+	int rows = lastRow - firstRow + 1;
+	int chunks = 1;
+	if (decoders && rgn.w * rgn.h >= MOS_PARALLEL_PIXELS) {
+		chunks = std::min(rows, decoderCount + 1);
+	}
+
+	std::mutex lock;
+	std::condition_variable finished;
+	int pending = chunks - 1;
+	for (int c = 1; c < chunks; c++) {
+		int first = firstRow + rows * c / chunks;
+		int last = firstRow + rows * (c + 1) / chunks - 1;
+		decoders->Post([&, first, last]() {
+			DecodeBlocks(blocks, first, last, firstCol, lastCol, rgn, pixels);
+			std::lock_guard<std::mutex> guard(lock);
+			if (!--pending) {
+				finished.notify_one();
+			}
+		});
+	}
+	DecodeBlocks(blocks, firstRow, firstRow + rows / chunks - 1, firstCol, lastCol, rgn, pixels);
+
+	std::unique_lock<std::mutex> guard(lock);
+	finished.wait(guard, [&pending]() { return pending == 0; });
+}
+
+// the pixels of all blocks follow the tables, so they are read in one go too
 Sprite2D* MOSImporter::GetSprite2D()
 {
-	RevColor RevCol[256];
-	unsigned char * pixels = ( unsigned char * ) malloc( Width * Height * 4 );
-	unsigned char * blockpixels = ( unsigned char * )
-		malloc( BlockSize * BlockSize );
-	ieDword blockoffset;
+	size_t blocks = Rows * Cols;
+	ieDword dataOffset = PalOffset + blocks * 1028;
+	size_t dataSize = 0;
 	for (int y = 0; y < Rows; y++) {
-		int bh = ( y == Rows - 1 ) ?
-			( ( Height % 64 ) == 0 ? 64 : Height % 64 ) :
-			64;
 		for (int x = 0; x < Cols; x++) {
-			int bw = ( x == Cols - 1 ) ?
-				( ( Width % 64 ) == 0 ? 64 : Width % 64 ) :
-				64;
-			str->Seek( PalOffset + ( y * Cols * 1024 ) +
-				( x * 1024 ), GEM_STREAM_START );
-			str->Read( &RevCol[0], 1024 );
-			str->Seek( PalOffset + ( Rows * Cols * 1024 ) +
-				( y * Cols * 4 ) + ( x * 4 ),
-				GEM_STREAM_START );
-			str->ReadDword( &blockoffset );
-			str->Seek( PalOffset + ( Rows * Cols * 1024 ) +
-				( Rows * Cols * 4 ) + blockoffset,
-				GEM_STREAM_START );
-			str->Read( blockpixels, bw * bh );
-			unsigned char * bp = blockpixels;
-			unsigned char * startpixel = pixels +
-				( ( Width * 4 * y ) * 64 ) +
-				( 4 * x * 64 );
-			for (int h = 0; h < bh; h++) {
-				for (int w = 0; w < bw; w++) {
-					*startpixel = RevCol[*bp].b;
-					startpixel++;
-					*startpixel = RevCol[*bp].g;
-					startpixel++;
-					*startpixel = RevCol[*bp].r;
-					startpixel++;
-					*startpixel = RevCol[*bp].a;
-					startpixel++;
-					bp++;
-				}
-				startpixel = startpixel + ( Width * 4 ) - ( 4 * bw );
+			int bw, bh;
+			GetBlockSize(x, y, bw, bh);
+			dataSize = std::max<size_t>(dataSize, size_t(offsets[y * Cols + x]) + bw * bh);
+		}
+	}
+	// a corrupt offset must not make us allocate more than the file has
+	size_t fileSize = str->Size();
+	dataSize = std::min<size_t>(dataSize, fileSize > dataOffset ? fileSize - dataOffset : 0);
+	std::vector<unsigned char> data(dataSize);
+	str->Seek(dataOffset, GEM_STREAM_START);
+	int got = dataSize ? str->Read(data.data(), dataSize) : 0;
+	size_t available = got > 0 ? got : 0;
+
+	std::vector<const unsigned char*> blockData(blocks, NULL);
+	for (int y = 0; y < Rows; y++) {
+		for (int x = 0; x < Cols; x++) {
+			int bw, bh;
+			GetBlockSize(x, y, bw, bh);
+			size_t offset = offsets[y * Cols + x];
+			if (offset + bw * bh <= available) {
+				blockData[y * Cols + x] = &data[offset];
 			}
 		}
 	}
-	free( blockpixels );
+
+	ieDword* pixels = (ieDword*) calloc(Width * Height, 4);
+	Decode(blockData, Region(0, 0, Width, Height), pixels);
 	Sprite2D* ret = core->GetVideoDriver()->CreateSprite( Width, Height, 32,
 		red_mask, green_mask, blue_mask, 0,
 		pixels, true, green_mask );
 	return ret;
 }
 
+// only the blocks rgn touches are read, so a view of a huge map can be
+// shown without going through all of it
+Sprite2D* MOSImporter::GetPartialSprite2D(const Region& part)
+{
+	Region rgn = part.Intersect(Region(0, 0, Width, Height));
+	if (rgn.w <= 0 || rgn.h <= 0) {
+		return NULL;
+	}
+
+	ieDword dataOffset = PalOffset + Rows * Cols * 1028;
+	std::vector<const unsigned char*> blockData(Rows * Cols, NULL);
+	std::vector<unsigned char> data;
+	std::vector<size_t> starts(Rows * Cols);
+	for (int y = rgn.y / 64; y <= std::min((rgn.y + rgn.h - 1) / 64, Rows - 1); y++) {
+		for (int x = rgn.x / 64; x <= std::min((rgn.x + rgn.w - 1) / 64, Cols - 1); x++) {
+			int bw, bh;
+			GetBlockSize(x, y, bw, bh);
+			size_t start = data.size();
+			data.resize(start + bw * bh);
+			str->Seek(dataOffset + offsets[y * Cols + x], GEM_STREAM_START);
+			if (str->Read(&data[start], bw * bh) == bw * bh) {
+				starts[y * Cols + x] = start + 1;
+			}
+		}
+	}
+	// only now that data is done growing
+	for (size_t i = 0; i < starts.size(); i++) {
+		if (starts[i]) {
+			blockData[i] = &data[starts[i] - 1];
+		}
+	}
+
+	ieDword* pixels = (ieDword*) calloc(rgn.w * rgn.h, 4);
+	Decode(blockData, rgn, pixels);
+	Sprite2D* ret = core->GetVideoDriver()->CreateSprite( rgn.w, rgn.h, 32,
+		red_mask, green_mask, blue_mask, 0,
+		pixels, true, green_mask );
+	return ret;
+}
+
 #include "plugindef.h"
 
 GEMRB_PLUGIN(0x167B73E, "MOS File Importer")
 PLUGIN_IE_RESOURCE(MOSImporter, "mos", (ieWord)IE_MOS_CLASS_ID)
+PLUGIN_INITIALIZER(CreateDecoders)
+PLUGIN_CLEANUP(ReleaseMemory)
 END_PLUGIN()
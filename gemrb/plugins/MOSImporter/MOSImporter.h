@@ -23,17 +23,28 @@
 
 #include "ImageMgr.h"
 
+#include <vector>
+
 namespace GemRB {
 
 class MOSImporter : public ImageMgr {
 private:
 	ieWord Width, Height, Cols, Rows;
 	ieDword BlockSize, PalOffset;
+	// every block's palette as finished pixels, and where its pixels start
+	std::vector<ieDword> palettes;
+	std::vector<ieDword> offsets;
+
+	void DecodeBlocks(const std::vector<const unsigned char*>& blocks, int firstRow, int lastRow,
+		int firstCol, int lastCol, const Region& rgn, ieDword* pixels) const;
+	void Decode(const std::vector<const unsigned char*>& blocks, const Region& rgn, ieDword* pixels) const;
+	void GetBlockSize(int x, int y, int& bw, int& bh) const;
 public:
 	MOSImporter(void);
 	~MOSImporter(void);
 	bool Open(DataStream* stream);
 	Sprite2D* GetSprite2D();
+	Sprite2D* GetPartialSprite2D(const Region& rgn);
 	int GetWidth() { return (int) Width; }
 	int GetHeight() { return (int) Height; }
 };
@@ -0,0 +1,134 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "NullSprite2D.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace GemRB {
+
+// scales a masked channel to 8 bits
+static unsigned char ChannelValue(ieDword pixel, ieDword mask)
+{
+	if (!mask) {
+		return 0;
+	}
+	int shift = 0;
+	while (!(mask & (1 << shift))) {
+		shift++;
+	}
+	ieDword max = mask >> shift;
+	return (unsigned char) ((((pixel & mask) >> shift) * 255) / max);
+}
+
+NullSprite2D::NullSprite2D(int Width, int Height, int Bpp, void* pixels,
+						   ieDword rMask, ieDword gMask, ieDword bMask, ieDword aMask)
+	: Sprite2D(Width, Height, Bpp, pixels), palette(NULL), colorKey(0),
+	rMask(rMask), gMask(gMask), bMask(bMask), aMask(aMask)
+{
+}
+
+NullSprite2D::NullSprite2D(const NullSprite2D &obj)
+	: Sprite2D(obj), palette(NULL), colorKey(obj.colorKey),
+	rMask(obj.rMask), gMask(obj.gMask), bMask(obj.bMask), aMask(obj.aMask)
+{
+	if (obj.pixels) {
+		size_t size = Width * Height * BytesPerPixel();
+		void* copy = malloc(size);
+		memcpy(copy, obj.pixels, size);
+		pixels = copy;
+		freePixels = true;
+	}
+	if (obj.palette) {
+		SetPalette(obj.palette->col);
+	}
+}
+
+NullSprite2D* NullSprite2D::copy() const
+{
+	return new NullSprite2D(*this);
+}
+
+NullSprite2D::~NullSprite2D()
+{
+	if (palette) {
+		palette->release();
+	}
+}
+
+/** Get the Palette of a Sprite */
+Palette* NullSprite2D::GetPalette() const
+{
+	if (!palette) {
+		return NULL;
+	}
+	// like the other drivers, the caller gets its own copy
+	return new Palette(palette->col, palette->alpha);
+}
+
+const Color* NullSprite2D::GetPaletteColors() const
+{
+	return palette ? palette->col : NULL;
+}
+
+void NullSprite2D::SetPalette(Palette* pal)
+{
+	SetPalette(pal->col);
+}
+
+void NullSprite2D::SetPalette(const Color* pal)
+{
+	if (!palette) {
+		palette = new Palette();
+	}
+	memcpy(palette->col, pal, sizeof(palette->col));
+}
+
+ieDword NullSprite2D::GetColorKey() const
+{
+	return colorKey;
+}
+
+void NullSprite2D::SetColorKey(ieDword ck)
+{
+	colorKey = ck;
+}
+
+Color NullSprite2D::GetPixel(unsigned short x, unsigned short y) const
+{
+	Color c = { 0, 0, 0, 0 };
+	if (x >= Width || y >= Height || !pixels) return c;
+
+	const unsigned char* src = (const unsigned char*) pixels + (y * Width + x) * BytesPerPixel();
+	if (palette) {
+		return palette->col[*src];
+	}
+
+	ieDword val = 0;
+	memcpy(&val, src, BytesPerPixel() > 4 ? 4 : BytesPerPixel());
+	c.r = ChannelValue(val, rMask);
+	c.g = ChannelValue(val, gMask);
+	c.b = ChannelValue(val, bMask);
+	c.a = aMask ? ChannelValue(val, aMask) : 0xff;
+	return c;
+}
+
+}
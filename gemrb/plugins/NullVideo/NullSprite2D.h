@@ -0,0 +1,55 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef NULLSPRITE2D_H
+#define NULLSPRITE2D_H
+
+#include "Sprite2D.h"
+
+namespace GemRB {
+
+// a sprite that only lives in memory, so the pixels can still be inspected
+class NullSprite2D : public Sprite2D {
+private:
+	Palette* palette; // only for paletted sprites
+	ieDword colorKey;
+	ieDword rMask, gMask, bMask, aMask;
+
+	int BytesPerPixel() const { return (Bpp < 8) ? 1 : Bpp / 8; }
+
+public:
+	NullSprite2D(int Width, int Height, int Bpp, void* pixels,
+				 ieDword rMask = 0, ieDword gMask = 0, ieDword bMask = 0, ieDword aMask = 0);
+	NullSprite2D(const NullSprite2D &obj);
+	NullSprite2D* copy() const;
+	~NullSprite2D();
+
+	Palette *GetPalette() const;
+	const Color* GetPaletteColors() const;
+	void SetPalette(Palette *pal);
+	void SetPalette(const Color* pal);
+	Color GetPixel(unsigned short x, unsigned short y) const;
+	ieDword GetColorKey() const;
+	void SetColorKey(ieDword);
+};
+
+}
+
+#endif
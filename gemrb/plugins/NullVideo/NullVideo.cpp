@@ -0,0 +1,270 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "NullVideo.h"
+
+#include "NullSprite2D.h"
+
+#include "Interface.h"
+
+using namespace GemRB;
+
+NullVideoDriver::NullVideoDriver(void)
+{
+	frames = 0;
+	blits = 0;
+	primitives = 0;
+}
+
+NullVideoDriver::~NullVideoDriver(void)
+{
+	Log(DEBUG, "NullVideo", "%lu frames, %lu blits, %lu primitives",
+		frames, blits, primitives);
+}
+
+int NullVideoDriver::Init(void)
+{
+	return GEM_OK;
+}
+
+int NullVideoDriver::CreateDisplay(int w, int h, int b, bool fs, const char* /*title*/)
+{
+	width = w;
+	height = h;
+	bpp = b;
+	fullscreen = fs;
+	Viewport.w = width;
+	Viewport.h = height;
+	SetScreenClip(NULL);
+	Log(MESSAGE, "NullVideo", "Headless display %dx%d@%dbpp", width, height, bpp);
+	return GEM_OK;
+}
+
+void NullVideoDriver::SetWindowTitle(const char* /*title*/)
+{
+}
+
+bool NullVideoDriver::SetFullscreenMode(bool set)
+{
+	fullscreen = set;
+	return true;
+}
+
+int NullVideoDriver::SwapBuffers(void)
+{
+	frames++;
+	dirtyRegions.clear();
+	return GEM_OK;
+}
+
+bool NullVideoDriver::ToggleGrabInput()
+{
+	return false;
+}
+
+Sprite2D* NullVideoDriver::CreateSprite(int w, int h, int bpp, ieDword rMask,
+	ieDword gMask, ieDword bMask, ieDword aMask, void* pixels, bool cK, int index)
+{
+	NullSprite2D* spr = new NullSprite2D(w, h, bpp, pixels, rMask, gMask, bMask, aMask);
+	if (cK) {
+		spr->SetColorKey(index);
+	}
+	return spr;
+}
+
+Sprite2D* NullVideoDriver::CreateSprite8(int w, int h, void* pixels,
+										 Palette* palette, bool cK, int index)
+{
+	return CreatePalettedSprite(w, h, 8, pixels, palette->col, cK, index);
+}
+
+Sprite2D* NullVideoDriver::CreatePalettedSprite(int w, int h, int bpp, void* pixels,
+												Color* palette, bool cK, int index)
+{
+	if (palette == NULL) return NULL;
+
+	NullSprite2D* spr = new NullSprite2D(w, h, bpp, pixels);
+	spr->SetPalette(palette);
+	if (cK) {
+		spr->SetColorKey(index);
+	}
+	return spr;
+}
+
+void NullVideoDriver::BlitTile(const Sprite2D* /*spr*/, const Sprite2D* /*mask*/, int /*x*/, int /*y*/,
+							   const Region* /*clip*/, unsigned int /*flags*/)
+{
+	blits++;
+}
+
+void NullVideoDriver::BlitSprite(const Sprite2D* /*spr*/, int /*x*/, int /*y*/, bool /*anchor*/,
+								 const Region* /*clip*/, Palette* /*palette*/)
+{
+	blits++;
+}
+
+void NullVideoDriver::BlitSprite(const Sprite2D* /*spr*/, const Region& /*src*/, const Region& /*dst*/,
+								 Palette* /*pal*/)
+{
+	blits++;
+}
+
+void NullVideoDriver::BlitGameSprite(const Sprite2D* /*spr*/, int /*x*/, int /*y*/,
+	unsigned int /*flags*/, Color /*tint*/, SpriteCover* /*cover*/, Palette* /*palette*/,
+	const Region* /*clip*/, bool /*anchor*/)
+{
+	blits++;
+}
+
+Sprite2D* NullVideoDriver::GetScreenshot(Region r)
+{
+	unsigned int w = r.w ? r.w : width - r.x;
+	unsigned int h = r.h ? r.h : height - r.y;
+
+	void* pixels = calloc(w * h, 4);
+	return CreateSprite(w, h, 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000, pixels);
+}
+
+void NullVideoDriver::DrawRect(const Region& /*rgn*/, const Color& /*color*/, bool /*fill*/, bool /*clipped*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::DrawRectSprite(const Region& /*rgn*/, const Color& /*color*/, const Sprite2D* /*sprite*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::SetPixel(short /*x*/, short /*y*/, const Color& /*color*/, bool /*clipped*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::GetPixel(short /*x*/, short /*y*/, Color& color)
+{
+	color.r = color.g = color.b = 0;
+	color.a = 0xff;
+}
+
+void NullVideoDriver::DrawCircle(short /*cx*/, short /*cy*/, unsigned short /*r*/, const Color& /*color*/, bool /*clipped*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::DrawEllipseSegment(short /*cx*/, short /*cy*/, unsigned short /*xr*/, unsigned short /*yr*/,
+	const Color& /*color*/, double /*anglefrom*/, double /*angleto*/, bool /*drawlines*/, bool /*clipped*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::DrawEllipse(short /*cx*/, short /*cy*/, unsigned short /*xr*/,
+	unsigned short /*yr*/, const Color& /*color*/, bool /*clipped*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::DrawPolyline(Gem_Polygon* /*poly*/, const Color& /*color*/, bool /*fill*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::DrawLine(short /*x1*/, short /*y1*/, short /*x2*/, short /*y2*/,
+	const Color& /*color*/, bool /*clipped*/)
+{
+	primitives++;
+}
+
+void NullVideoDriver::ConvertToGame(short& x, short& y)
+{
+	x += Viewport.x;
+	y += Viewport.y;
+}
+
+void NullVideoDriver::ConvertToScreen(short& x, short& y)
+{
+	x -= Viewport.x;
+	y -= Viewport.y;
+}
+
+void NullVideoDriver::SetFadeColor(int r, int g, int b)
+{
+	fadeColor.r = r;
+	fadeColor.g = g;
+	fadeColor.b = b;
+}
+
+void NullVideoDriver::SetFadePercent(int percent)
+{
+	fadeColor.a = (percent * 255) / 100;
+}
+
+void NullVideoDriver::ClickMouse(unsigned int /*button*/)
+{
+}
+
+void NullVideoDriver::MoveMouse(unsigned int x, unsigned int y)
+{
+	CursorPos.x = x;
+	CursorPos.y = y;
+}
+
+void NullVideoDriver::InitMovieScreen(int &w, int &h, bool /*yuv*/)
+{
+	w = width;
+	h = height;
+}
+
+void NullVideoDriver::showFrame(unsigned char* /*buf*/, unsigned int /*bufw*/,
+	unsigned int /*bufh*/, unsigned int /*sx*/, unsigned int /*sy*/,
+	unsigned int /*w*/, unsigned int /*h*/, unsigned int /*dstx*/,
+	unsigned int /*dsty*/, int /*truecolor*/, unsigned char* /*palette*/,
+	ieDword /*titleref*/)
+{
+	blits++;
+}
+
+void NullVideoDriver::showYUVFrame(unsigned char** /*buf*/, unsigned int* /*strides*/,
+	unsigned int /*bufw*/, unsigned int /*bufh*/,
+	unsigned int /*w*/, unsigned int /*h*/,
+	unsigned int /*dstx*/, unsigned int /*dsty*/,
+	ieDword /*titleref*/)
+{
+	blits++;
+}
+
+void NullVideoDriver::DrawMovieSubtitle(ieStrRef /*text*/)
+{
+}
+
+int NullVideoDriver::PollMovieEvents()
+{
+	// nobody can watch, so end the movie right away
+	return 1;
+}
+
+void NullVideoDriver::SetGamma(int /*brightness*/, int /*contrast*/)
+{
+}
+
+#include "plugindef.h"
+
+GEMRB_PLUGIN(0xDA2E1F3, "Null Video Driver")
+PLUGIN_DRIVER(NullVideoDriver, "none")
+END_PLUGIN()
@@ -0,0 +1,116 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2020 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef NULLVIDEO_H
+#define NULLVIDEO_H
+
+#include "Video.h"
+
+namespace GemRB {
+
+/**
+ * Video driver that draws nothing. Used for running the engine headless,
+ * eg. for benchmarks, so blits and primitives are only counted.
+ */
+class NullVideoDriver : public Video {
+private:
+	unsigned long frames;
+	unsigned long blits;
+	unsigned long primitives;
+
+public:
+	NullVideoDriver(void);
+	~NullVideoDriver(void);
+	int Init(void);
+	int CreateDisplay(int width, int height, int bpp, bool fullscreen, const char* title);
+	void SetWindowTitle(const char* title);
+	bool SetFullscreenMode(bool set);
+	int SwapBuffers(void);
+	bool ToggleGrabInput();
+	short GetWidth() { return width; }
+	short GetHeight() { return height; }
+	void ShowSoftKeyboard() {}
+	void HideSoftKeyboard() {}
+
+	Sprite2D* CreateSprite(int w, int h, int bpp, ieDword rMask,
+		ieDword gMask, ieDword bMask, ieDword aMask, void* pixels,
+		bool cK = false, int index = 0);
+	Sprite2D* CreateSprite8(int w, int h, void* pixels,
+							Palette* palette, bool cK = false, int index = 0);
+	Sprite2D* CreatePalettedSprite(int w, int h, int bpp, void* pixels,
+								   Color* palette, bool cK = false, int index = 0);
+
+	void BlitTile(const Sprite2D* spr, const Sprite2D* mask, int x, int y,
+				  const Region* clip, unsigned int flags);
+	void BlitSprite(const Sprite2D* spr, int x, int y, bool anchor = false,
+					const Region* clip = NULL, Palette* palette = NULL);
+	void BlitSprite(const Sprite2D* spr, const Region& src, const Region& dst,
+					Palette* pal = NULL);
+	void BlitGameSprite(const Sprite2D* spr, int x, int y,
+		unsigned int flags, Color tint,
+		SpriteCover* cover, Palette *palette = NULL,
+		const Region* clip = NULL, bool anchor = false);
+	Sprite2D* GetScreenshot(Region r);
+
+	void DrawRect(const Region& rgn, const Color& color, bool fill = true, bool clipped = false);
+	void DrawRectSprite(const Region& rgn, const Color& color, const Sprite2D* sprite);
+	void SetPixel(short x, short y, const Color& color, bool clipped = false);
+	void GetPixel(short x, short y, Color& color);
+	void DrawCircle(short cx, short cy, unsigned short r, const Color& color, bool clipped = true);
+	void DrawEllipseSegment(short cx, short cy, unsigned short xr, unsigned short yr, const Color& color,
+		double anglefrom, double angleto, bool drawlines = true, bool clipped = true);
+	void DrawEllipse(short cx, short cy, unsigned short xr,
+		unsigned short yr, const Color& color, bool clipped = true);
+	void DrawPolyline(Gem_Polygon* poly, const Color& color, bool fill = false);
+	void DrawLine(short x1, short y1, short x2, short y2,
+		const Color& color, bool clipped = false);
+
+	void ConvertToGame(short& x, short& y);
+	void ConvertToScreen(short& x, short& y);
+	void SetFadeColor(int r, int g, int b);
+	void SetFadePercent(int percent);
+	void ClickMouse(unsigned int button);
+	void MoveMouse(unsigned int x, unsigned int y);
+	bool TouchInputEnabled() const { return false; }
+
+	void InitMovieScreen(int &w, int &h, bool yuv=false);
+	void DestroyMovieScreen() {}
+	void showFrame(unsigned char* buf, unsigned int bufw,
+		unsigned int bufh, unsigned int sx, unsigned int sy,
+		unsigned int w, unsigned int h, unsigned int dstx,
+		unsigned int dsty, int truecolor, unsigned char *palette,
+		ieDword titleref);
+	void showYUVFrame(unsigned char** buf, unsigned int *strides,
+		unsigned int bufw, unsigned int bufh,
+		unsigned int w, unsigned int h,
+		unsigned int dstx, unsigned int dsty,
+		ieDword titleref);
+	void DrawMovieSubtitle(ieStrRef text);
+	int PollMovieEvents();
+	void SetGamma(int brightness, int contrast);
+
+	void DrawBackgroundBuffer() {}
+	void FreeBackgroundBuffer() {}
+	void TakeBackgroundBuffer() {}
+};
+
+}
+
+#endif
@@ -80,26 +80,25 @@ bool PLTImporter::Open(DataStream* str)
 
 Sprite2D* PLTImporter::GetSprite2D(unsigned int type, ieDword paletteIndex[8])
 {
-	Color Palettes[8][256];
+	// every gradient and intensity straight to its finished bgra pixel
+	ieDword table[8][256];
 	for (int i = 0; i < 8; i++) {
-		core->GetPalette( (paletteIndex[pperm[i]] >> (8*type)) & 0xFF, 256, Palettes[i] );
+		Color gradient[256];
+		core->GetPalette((paletteIndex[pperm[i]] >> (8*type)) & 0xFF, 256, gradient);
+		for (int intensity = 0; intensity < 256; intensity++) {
+			unsigned char bgra[4] = { gradient[intensity].b, gradient[intensity].g,
+				gradient[intensity].r, (unsigned char) (intensity == 0xff ? 0x00 : 0xff) };
+			memcpy(&table[i][intensity], bgra, 4);
+		}
 	}
-	unsigned char * p = ( unsigned char * ) malloc( Width * Height * 4 );
-	unsigned char * dest = p;
-	unsigned char * src = NULL;
+	ieDword* p = (ieDword*) malloc( Width * Height * 4 );
+	ieDword* dest = p;
 	for (int y = Height - 1; y >= 0; y--) {
-		src = ( unsigned char * ) pixels + ( y * Width * 2 );
+		const unsigned char* src = (const unsigned char*) pixels + (y * Width * 2);
 		for (unsigned int x = 0; x < Width; x++) {
-			unsigned char intensity = *src++;
-			unsigned char palindex = *src++;
-			*dest++ = Palettes[palindex][intensity].b;
-			*dest++ = Palettes[palindex][intensity].g;
-			*dest++ = Palettes[palindex][intensity].r;
-			if (intensity == 0xff)
-				*dest++ = 0x00;
-			else
-				*dest++ = 0xff;
+			dest[x] = table[src[2 * x + 1] & 7][src[2 * x]];
 		}
+		dest += Width;
 	}
 	Sprite2D* spr = core->GetVideoDriver()->CreateSprite( Width, Height, 32,
 		red_mask, green_mask, blue_mask, 0, p,
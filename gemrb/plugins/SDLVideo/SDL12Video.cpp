@@ -90,6 +90,7 @@ int SDL12VideoDriver::CreateDisplay(int w, int h, int b, bool fs, const char* ti
 	SDL_FillRect( extra, NULL, val );
 	SDL_UnlockSurface( extra );
 	SDL_FreeSurface( tmp );
+	InvalidateAll();
 
 	return GEM_OK;
 }
@@ -121,6 +122,8 @@ void SDL12VideoDriver::DestroyMovieScreen()
 		SDL_FreeYUVOverlay(overlay);
 		overlay = NULL;
 	}
+	// the movie drew straight to the display
+	InvalidateAll();
 }
 
 void SDL12VideoDriver::showFrame(unsigned char* buf, unsigned int bufw,
@@ -172,6 +175,7 @@ bool SDL12VideoDriver::SetFullscreenMode(bool set)
 		fullscreen=set;
 		// FIXME: SDL_WM_ToggleFullScreen only works on X11. use SDL_SetVideoMode()
 		SDL_WM_ToggleFullScreen( disp );
+		InvalidateAll();
 		//readjust mouse to original position
 		MoveMouse(CursorPos.x, CursorPos.y);
 		//synchronise internal variable
@@ -183,7 +187,19 @@ bool SDL12VideoDriver::SetFullscreenMode(bool set)
 
 int SDL12VideoDriver::SwapBuffers(void)
 {
-	SDL_BlitSurface( backBuf, NULL, disp, NULL );
+	if (fadeColor.a) {
+		// the fade is blended over disp, so it can't be applied piecewise
+		InvalidateAll();
+	}
+	// what changed, plus whatever the last overlays covered
+	std::vector<Region> present = dirtyRegions;
+	for (size_t i = 0; i < overlayRegions.size(); i++) {
+		AddDirtyRegion(present, overlayRegions[i]);
+	}
+	for (size_t i = 0; i < present.size(); i++) {
+		SDL_Rect rect = RectFromRegion(present[i]);
+		SDL_BlitSurface( backBuf, &rect, disp, &rect );
+	}
 	if (fadeColor.a) {
 		SDL_SetAlpha( extra, SDL_SRCALPHA, fadeColor.a );
 		SDL_Rect src = {
@@ -201,7 +217,18 @@ int SDL12VideoDriver::SwapBuffers(void)
 	int ret = SDLVideoDriver::SwapBuffers();
 	backBuf = tmp;
 
-	SDL_Flip( disp );
+	for (size_t i = 0; i < overlayRegions.size(); i++) {
+		AddDirtyRegion(present, overlayRegions[i]);
+	}
+	if (present.size() == 1 && present[0] == Region(0, 0, width, height)) {
+		SDL_Flip( disp );
+	} else if (!present.empty()) {
+		std::vector<SDL_Rect> rects(present.size());
+		for (size_t i = 0; i < present.size(); i++) {
+			rects[i] = RectFromRegion(present[i]);
+		}
+		SDL_UpdateRects( disp, (int) rects.size(), &rects[0] );
+	}
 	return ret;
 }
 
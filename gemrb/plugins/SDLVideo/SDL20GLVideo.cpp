@@ -699,7 +699,7 @@ void GLVideoDriver::DrawPolyline(Gem_Polygon* poly, const Color& color, bool fil
 		c.a = c.a/2;
 		// end of bad code
 		std::vector<Point> triangulation;
-		std::list<Trapezoid>::iterator iter;
+		std::vector<Trapezoid>::iterator iter;
 		for (iter = poly->trapezoids.begin(); iter != poly->trapezoids.end(); ++iter)
 		{
 			int y_top = iter->y1;
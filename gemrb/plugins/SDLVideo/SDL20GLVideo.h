@@ -69,6 +69,8 @@ namespace GemRB
 		void DrawLine(short x1, short y1, short x2, short y2, const Color& color, bool clipped = false);
 		void DrawPolyline(Gem_Polygon* poly, const Color& color, bool fill = false);
 		void DrawEllipse(short cx, short cy, unsigned short xr, unsigned short yr, const Color& color, bool clipped = true);
+		// the shader draws them one by one anyway
+		void DrawEllipses(const std::vector<VideoEllipse>& ellipses, bool clipped = true) { Video::DrawEllipses(ellipses, clipped); }
 		void DrawCircle(short cx, short cy, unsigned short r, const Color& color, bool clipped = true);
 		void SetPixel(short x, short y, const Color& color, bool clipped = true);
 		/*void DrawEllipseSegment(short cx, short cy, unsigned short xr, unsigned short yr, const Color& color, double anglefrom, double angleto, bool drawlines = true, bool clipped = true);*/
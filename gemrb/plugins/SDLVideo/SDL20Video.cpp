@@ -150,7 +150,7 @@ doneFormat:
 		width, height, SDL_GetPixelFormatName(format));
 	backBuf = SDL_CreateRGBSurface( 0, width, height,
 									bpp, r, g, b, a );
-	// tmpBuf is here as a truly ugly hack, so we can copy backBuf to tmpBuf before blitting cursors, and then back again after the screen is presented.
+	// tmpBuf gets the changed parts of backBuf and the overlays, see SwapBuffers
 	tmpBuf = SDL_CreateRGBSurface( 0, width, height, bpp, r, g, b, a );
 	this->bpp = bpp;
 
@@ -160,6 +160,7 @@ doneFormat:
 		return GEM_ERROR;
 	}
 	disp = backBuf;
+	InvalidateAll();
 
 	return GEM_OK;
 }
@@ -198,6 +199,8 @@ void SDL20VideoDriver::DestroyMovieScreen()
 	// destroy any events that took place during the movies
 	SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
 	SDL_RenderClear(renderer); // I guess the videos can potentially be a larger size then the game.
+	// the new texture has no content yet
+	InvalidateAll();
 }
 
 void SDL20VideoDriver::showFrame(unsigned char* buf, unsigned int bufw,
@@ -331,36 +334,32 @@ void SDL20VideoDriver::showYUVFrame(unsigned char** buf, unsigned int *strides,
 
 int SDL20VideoDriver::SwapBuffers(void)
 {
-	//this is not pretty. We make a complete copy of the backBuf into tmpBuf, then copy it back after SDLVideoDriver::SwapBuffers has blitted cursors and tooltips, and SDL_UpdateTexture has copied it to the screentexture.
-	if (Cursor[CursorIndex] && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
-		SDL_BlitSurface(backBuf, NULL, tmpBuf, NULL);
+	// backBuf keeps the frame without the overlays, tmpBuf is what gets presented
+	std::vector<Region> present = dirtyRegions;
+	for (size_t i = 0; i < overlayRegions.size(); i++) {
+		AddDirtyRegion(present, overlayRegions[i]);
+	}
+	for (size_t i = 0; i < present.size(); i++) {
+		SDL_Rect rect = RectFromRegion(present[i]);
+		SDL_BlitSurface(backBuf, &rect, tmpBuf, &rect);
 	}
-	int ret = SDLVideoDriver::SwapBuffers();
 
-	SDL_UpdateTexture(screenTexture, NULL, backBuf->pixels, backBuf->pitch);
-	if (Cursor[CursorIndex] && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
-		SDL_BlitSurface(tmpBuf, NULL, backBuf, NULL);
+	LimitFrameRate();
+	SDL_Surface* tmp = backBuf;
+	backBuf = tmpBuf;
+	DrawOverlays();
+	backBuf = tmp;
+	for (size_t i = 0; i < overlayRegions.size(); i++) {
+		AddDirtyRegion(present, overlayRegions[i]);
 	}
-	/*
-	 Commenting this out because I get better performance (on iOS) with SDL_UpdateTexture
-	 Don't know how universal it is yet so leaving this in commented out just in case
-
-	 void *pixels;
-	 int pitch;
-	 if(SDL_LockTexture(screenTexture, NULL, &pixels, &pitch) != GEM_OK) {
-	 Log(ERROR, "SDL 2 driver", "Unable to lock screen texture: %s", SDL_GetError());
-	 return GEM_ERROR;
-	 }
 
-	 ieByte* src = (ieByte*)backBuf->pixels;
-	 ieByte* dest = (ieByte*)pixels;
-	 for( int row = 0; row < height; row++ ) {
-	 memcpy(dest, src, width * backBuf->format->BytesPerPixel);
-	 dest += pitch;
-	 src += backBuf->pitch;
-	 }
-	 SDL_UnlockTexture(screenTexture);
-	 */
+	// the texture keeps its content, so only the changes are uploaded
+	int bytesPerPixel = tmpBuf->format->BytesPerPixel;
+	for (size_t i = 0; i < present.size(); i++) {
+		SDL_Rect rect = RectFromRegion(present[i]);
+		const Uint8* pixels = (const Uint8*) tmpBuf->pixels + rect.y * tmpBuf->pitch + rect.x * bytesPerPixel;
+		SDL_UpdateTexture(screenTexture, &rect, pixels, tmpBuf->pitch);
+	}
 
 	/*
 	 if (fadeColor.a) {
@@ -374,7 +373,7 @@ int SDL20VideoDriver::SwapBuffers(void)
 	SDL_RenderClear(renderer);
 	SDL_RenderCopy(renderer, screenTexture, NULL, NULL);
 	SDL_RenderPresent( renderer );
-	return ret;
+	return PollEvents();
 }
 
 int SDL20VideoDriver::PollEvents()
@@ -103,6 +103,13 @@ int SDLVideoDriver::Init(void)
 }
 
 int SDLVideoDriver::SwapBuffers(void)
+{
+	LimitFrameRate();
+	DrawOverlays();
+	return PollEvents();
+}
+
+void SDLVideoDriver::LimitFrameRate()
 {
 	unsigned long time;
 	time = GetTickCount();
@@ -113,15 +120,33 @@ int SDLVideoDriver::SwapBuffers(void)
 		time = GetTickCount();
 	}
 	lastTime = time;
+}
+
+// draws everything that isn't part of the frame proper, the drivers present
+// it but don't keep it in backBuf, so it is cleaned up next time
+void SDLVideoDriver::DrawOverlays()
+{
+	overlayRegions.clear();
+	drawingOverlay = true;
+	if (drawDirtyRegions) {
+		const Color outline = { 0xff, 0, 0xff, 0xff };
+		SetScreenClip(NULL);
+		for (size_t i = 0; i < dirtyRegions.size(); i++) {
+			DrawRect(dirtyRegions[i], outline, false);
+			InvalidateRegion(dirtyRegions[i]);
+		}
+	}
 
-	if (Cursor[CursorIndex] && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
+	Sprite2D* cursor = Cursor[CursorIndex];
+	if (cursor && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
 		
 		if (MouseFlags&MOUSE_GRAYED) {
 			//used for greyscale blitting, fadeColor is unused
-			BlitGameSprite(Cursor[CursorIndex], CursorPos.x, CursorPos.y, BLIT_GREY, fadeColor, NULL, NULL, NULL, true);
+			BlitGameSprite(cursor, CursorPos.x, CursorPos.y, BLIT_GREY, fadeColor, NULL, NULL, NULL, true);
 		} else {
-			BlitSprite(Cursor[CursorIndex], CursorPos.x, CursorPos.y, true);
+			BlitSprite(cursor, CursorPos.x, CursorPos.y, true);
 		}
+		InvalidateRegion(Region(CursorPos.x - cursor->XPos, CursorPos.y - cursor->YPos, cursor->Width, cursor->Height));
 	}
 	if (!(MouseFlags & MOUSE_NO_TOOLTIPS)) {
 		//handle tooltips
@@ -138,8 +163,8 @@ int SDLVideoDriver::SwapBuffers(void)
 			core->DrawTooltip();
 		}
 	}
-
-	return PollEvents();
+	drawingOverlay = false;
+	dirtyRegions.clear();
 }
 
 int SDLVideoDriver::PollEvents()
@@ -1191,12 +1216,36 @@ void SDLVideoDriver::DrawEllipseSegment(short cx, short cy, unsigned short xr,
 void SDLVideoDriver::DrawEllipse(short cx, short cy, unsigned short xr,
 	unsigned short yr, const Color& color, bool clipped)
 {
-	//Uses Bresenham's Ellipse Algorithm
-	long x, y, xc, yc, ee, tas, tbs, sx, sy;
+	if (SDL_MUSTLOCK( disp )) {
+		SDL_LockSurface( disp );
+	}
+	PlotEllipse(cx, cy, xr, yr, color, clipped);
+	if (SDL_MUSTLOCK( disp )) {
+		SDL_UnlockSurface( disp );
+	}
+}
 
+// the display is only locked once for the whole batch
+void SDLVideoDriver::DrawEllipses(const std::vector<VideoEllipse>& ellipses, bool clipped)
+{
 	if (SDL_MUSTLOCK( disp )) {
 		SDL_LockSurface( disp );
 	}
+	for (const VideoEllipse& ellipse : ellipses) {
+		PlotEllipse(ellipse.center.x, ellipse.center.y, ellipse.xr, ellipse.yr, ellipse.color, clipped);
+	}
+	if (SDL_MUSTLOCK( disp )) {
+		SDL_UnlockSurface( disp );
+	}
+}
+
+// the display has to be locked already
+void SDLVideoDriver::PlotEllipse(short cx, short cy, unsigned short xr,
+	unsigned short yr, const Color& color, bool clipped)
+{
+	//Uses Bresenham's Ellipse Algorithm
+	long x, y, xc, yc, ee, tas, tbs, sx, sy;
+
 	tas = 2 * xr * xr;
 	tbs = 2 * yr * yr;
 	x = xr;
@@ -1248,9 +1297,6 @@ void SDLVideoDriver::DrawEllipse(short cx, short cy, unsigned short xr,
 			yc += tas;
 		}
 	}
-	if (SDL_MUSTLOCK( disp )) {
-		SDL_UnlockSurface( disp );
-	}
 }
 
 void SDLVideoDriver::DrawPolyline(Gem_Polygon* poly, const Color& color, bool fill)
@@ -1276,7 +1322,7 @@ void SDLVideoDriver::DrawPolyline(Gem_Polygon* poly, const Color& color, bool fi
 		Uint16 mask16 = (Uint16)mask32;
 
 		SDL_LockSurface(backBuf);
-		std::list<Trapezoid>::iterator iter;
+		std::vector<Trapezoid>::iterator iter;
 		for (iter = poly->trapezoids.begin(); iter != poly->trapezoids.end();
 			++iter)
 		{
@@ -1374,7 +1420,11 @@ void SDLVideoDriver::SetFadePercent(int percent)
 {
 	if (percent>100) percent = 100;
 	else if (percent<0) percent = 0;
-	fadeColor.a = (255 * percent ) / 100;
+	Uint8 alpha = (255 * percent) / 100;
+	if (alpha != fadeColor.a) {
+		InvalidateAll();
+	}
+	fadeColor.a = alpha;
 }
 
 void SDLVideoDriver::MouseMovement(int x, int y)
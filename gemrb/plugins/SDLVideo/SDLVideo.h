@@ -55,10 +55,9 @@ class SDLVideoDriver : public Video {
 protected:
 	SDL_Surface* disp;
 	SDL_Surface* backBuf;
-	// tmpBuf is here as a truly ugly hack, so we can copy backBuf to tmpBuf before blitting cursors, and then back again after the screen is presented. Only applies for SDL2.
+	// tmpBuf holds the presented frame: backBuf plus the cursor, tooltip and other overlays. Only applies for SDL2.
 	SDL_Surface* tmpBuf;
 	SDL_Surface* extra;
-	std::vector< Region> upd;//Regions of the Screen to Update in the next SwapBuffer operation.
 	unsigned long lastTime;
 	unsigned long lastMouseMoveTime;
 	unsigned long lastMouseDownTime;
@@ -124,6 +123,7 @@ public:
 	/** This functions Draws an Ellipse */
 	virtual void DrawEllipse(short cx, short cy, unsigned short xr, unsigned short yr,
 		const Color& color, bool clipped = true);
+	virtual void DrawEllipses(const std::vector<VideoEllipse>& ellipses, bool clipped = true);
 	/** This function Draws a Polygon on the Screen */
 	virtual void DrawPolyline(Gem_Polygon* poly, const Color& color, bool fill = false);
 	virtual void DrawHLine(short x1, short y, short x2, const Color& color, bool clipped = false);
@@ -172,6 +172,11 @@ protected:
 	virtual bool SetSurfaceAlpha(SDL_Surface* surface, unsigned short alpha)=0;
 	/* used to process the SDL events dequeued by PollEvents or an arbitraty event from another source.*/
 	virtual int ProcessEvent(const SDL_Event & event);
+	/* the parts of SwapBuffers shared by all drivers */
+	void LimitFrameRate();
+	void DrawOverlays();
+	void PlotEllipse(short cx, short cy, unsigned short xr, unsigned short yr,
+		const Color& color, bool clipped);
 
 public:
 	// static functions for manipulating surfaces
@@ -24,6 +24,7 @@
 #include "win32def.h"
 
 #include "Interface.h"
+#include "Palette.h"
 #include "Sprite2D.h"
 #include "Video.h"
 
@@ -38,6 +39,10 @@ TISImporter::TISImporter(void)
 TISImporter::~TISImporter(void)
 {
 	delete str;
+	std::map<std::string, TilePalette>::iterator it;
+	for (it = palettes.begin(); it != palettes.end(); ++it) {
+		it->second.pal->release();
+	}
 }
 
 bool TISImporter::Open(DataStream* stream)
@@ -65,30 +70,43 @@ bool TISImporter::Open(DataStream* stream)
 	return true;
 }
 
-Tile* TISImporter::GetTile(unsigned short* indexes, int count,
-	unsigned short* secondary)
+// converts a palette the first time it is seen, later tiles just share it
+const TISImporter::TilePalette& TISImporter::GetPalette(const char* raw)
 {
-	Animation* ani = new Animation( count );
-	//pause key stops animation
-	ani->gameAnimation = true;
-	//the turning crystal in ar3202 (bg1) requires animations to be synced
-	ani->pos = 0;
-	for (int i = 0; i < count; i++) {
-		ani->AddFrame( GetTile( indexes[i] ), i );
+	std::string key(raw, 1024);
+	std::map<std::string, TilePalette>::iterator it = palettes.find(key);
+	if (it != palettes.end()) {
+		return it->second;
 	}
-	if (secondary) {
-		Animation* sec = new Animation( count );
-		for (int i = 0; i < count; i++) {
-			sec->AddFrame( GetTile( secondary[i] ), i );
+
+	const RevColor* RevCol = (const RevColor*) raw;
+	Color colors[256];
+	int transindex = 0;
+	bool transparent = false;
+	for (int i = 0; i < 256; i++) {
+		colors[i].r = RevCol[i].r;
+		colors[i].g = RevCol[i].g;
+		colors[i].b = RevCol[i].b;
+		colors[i].a = RevCol[i].a;
+		if (colors[i].g==255 && !colors[i].r && !colors[i].b) {
+			if (transparent) {
+				Log(ERROR, "TISImporter", "Tile has two green (transparent) palette entries");
+			} else {
+				transparent = true;
+				transindex = i;
+			}
 		}
-		return new Tile( ani, sec );
 	}
-	return new Tile( ani );
+	TilePalette& tp = palettes[key];
+	tp.pal = new Palette(colors);
+	tp.transparent = transparent;
+	tp.transindex = transindex;
+	return tp;
 }
 
 Sprite2D* TISImporter::GetTile(int index)
 {
-	RevColor RevCol[256];
+	char RevCol[1024];
 	Color Palette[256];
 	void* pixels = malloc( 4096 );
 	unsigned long pos = index *(1024+4096) + headerShift;
@@ -113,29 +131,23 @@ Sprite2D* TISImporter::GetTile(int index)
 		return spr;
 	}
 	str->Seek( pos, GEM_STREAM_START );
-	str->Read( &RevCol, 1024 );
-	int transindex = 0;
-	bool transparent = false;
-	for (int i = 0; i < 256; i++) {
-		Palette[i].r = RevCol[i].r;
-		Palette[i].g = RevCol[i].g;
-		Palette[i].b = RevCol[i].b;
-		Palette[i].a = RevCol[i].a;
-		if (Palette[i].g==255 && !Palette[i].r && !Palette[i].b) {
-			if (transparent) {
-				Log(ERROR, "TISImporter", "Tile has two green (transparent) palette entries");
-			} else {
-				transparent = true;
-				transindex = i;
-			}
-		}
-	}
+	str->Read( RevCol, 1024 );
+	const TilePalette& tp = GetPalette( RevCol );
 	str->Read( pixels, 4096 );
-	Sprite2D* spr = core->GetVideoDriver()->CreatePalettedSprite( 64, 64, 8, pixels, Palette, transparent, transindex );
+	Sprite2D* spr = core->GetVideoDriver()->CreateSprite8( 64, 64, pixels, tp.pal, tp.transparent, tp.transindex );
 	spr->XPos = spr->YPos = 0;
 	return spr;
 }
 
+// not TilesCount, original PS:T areas claim more than they have
+int TISImporter::GetTileCount()
+{
+	if (!str || str->Size() < headerShift) {
+		return 0;
+	}
+	return (int) ((str->Size() - headerShift) / (1024 + 4096));
+}
+
 #include "plugindef.h"
 
 GEMRB_PLUGIN(0x19F91578, "TIS File Importer")
@@ -23,20 +23,34 @@
 
 #include "TileSetMgr.h"
 
+#include <map>
+#include <string>
+
 namespace GemRB {
 
+class Palette;
+
 class TISImporter : public TileSetMgr {
 private:
+	struct TilePalette {
+		Palette* pal;
+		bool transparent;
+		int transindex;
+	};
+
 	DataStream* str;
 	ieDword headerShift;
 	ieDword TilesCount, TilesSectionLen, TileSize;
+	// most tiles of a set share a handful of palettes, by their raw bytes
+	std::map<std::string, TilePalette> palettes;
+
+	const TilePalette& GetPalette(const char* raw);
 public:
 	TISImporter(void);
 	~TISImporter(void);
 	bool Open(DataStream* stream);
-	Tile* GetTile(unsigned short* indexes, int count,
-		unsigned short* secondary = NULL);
 	Sprite2D* GetTile(int index);
+	int GetTileCount();
 public:
 };
 
@@ -43,7 +43,44 @@ struct gt_type
 };
 static Variables gtmap;
 
+// how many decoded untagged strings to keep around
+#define STRING_CACHE_SIZE 2048
+
+DecodedStringCache::DecodedStringCache(size_t capacity)
+	: capacity(capacity)
+{
+}
+
+const String* DecodedStringCache::Lookup(ieStrRef strref)
+{
+	auto it = index.find(strref);
+	if (it == index.end()) {
+		return NULL;
+	}
+	// move it to the front, so it is evicted last
+	entries.splice(entries.begin(), entries, it->second);
+	return &it->second->second;
+}
+
+const String* DecodedStringCache::Add(ieStrRef strref, const String& string)
+{
+	if (entries.size() >= capacity) {
+		index.erase(entries.back().first);
+		entries.pop_back();
+	}
+	entries.emplace_front(strref, string);
+	index[strref] = entries.begin();
+	return &entries.front().second;
+}
+
+void DecodedStringCache::Clear()
+{
+	entries.clear();
+	index.clear();
+}
+
 TLKImporter::TLKImporter(void)
+	: stringCache(STRING_CACHE_SIZE)
 {
 	int gtcount;
 
@@ -131,9 +168,50 @@ bool TLKImporter::Open(DataStream* stream)
 		Log(ERROR, "TLKImporter", "Too many strings (%d), increase STRREF_START.", StrRefCount);
 		return false;
 	}
+
+	// read the whole entry table up front, so lookups don't need to seek twice
+	stringCache.Clear();
+	entries.resize(StrRefCount);
+	for (ieDword i = 0; i < StrRefCount; i++) {
+		TLKEntry& entry = entries[i];
+		ieDword Volume, Pitch;
+		str->ReadWord(&entry.Type);
+		str->ReadResRef(entry.SoundResRef);
+		// volume and pitch variance fields are known to be unused at minimum in bg1
+		str->ReadDword(&Volume);
+		str->ReadDword(&Pitch);
+		str->ReadDword(&entry.Offset);
+		str->ReadDword(&entry.Length);
+		if (entry.Length > 65535) {
+			entry.Length = 65535; //safety limit, it could be a dword actually
+		}
+		entry.Tagged = false;
+	}
+
+	// flag the strings that need token resolution, so the rest can skip it
+	std::vector<char> text;
+	for (ieDword i = 0; i < StrRefCount; i++) {
+		TLKEntry& entry = entries[i];
+		if (!(entry.Type & 1) || !entry.Length) {
+			continue;
+		}
+		text.resize(entry.Length);
+		if (str->Seek(entry.Offset + Offset, GEM_STREAM_START) == GEM_ERROR ||
+			str->Read(&text[0], entry.Length) == GEM_ERROR) {
+			// leave it to the slow path
+			entry.Tagged = true;
+			continue;
+		}
+		entry.Tagged = memchr(&text[0], '<', entry.Length) || memchr(&text[0], '[', entry.Length);
+	}
 	return true;
 }
 
+ieDword TLKImporter::GetStrRefCount() const
+{
+	return StrRefCount;
+}
+
 //when copying the token, skip spaces
 inline const char* mystrncpy(char* dest, const char* source, int maxlength,
 	char delim)
@@ -418,8 +496,76 @@ ieStrRef TLKImporter::UpdateString(ieStrRef strref, const char *newvalue)
 	return OverrideTLK->UpdateString(strref, newvalue);
 }
 
+const TLKEntry* TLKImporter::GetCacheableEntry(ieStrRef strref, ieDword flags) const
+{
+	if (!(flags&IE_STR_ALLOW_ZERO) && !strref) {
+		return NULL;
+	}
+	if (strref >= StrRefCount || (strref >= BIO_START && strref <= BIO_END)) {
+		return NULL;
+	}
+	// these modify the text, so they are not worth caching
+	if (flags & (IE_STR_STRREFON|IE_STR_REMOVE_NEWLINE)) {
+		return NULL;
+	}
+	const TLKEntry& entry = entries[strref];
+	if (entry.Tagged && (core->HasFeature(GF_ALL_STRINGS_TAGGED) || (entry.Type & 4))) {
+		return NULL;
+	}
+	return &entry;
+}
+
+char* TLKImporter::ReadEntryText(const TLKEntry& entry, int& Length)
+{
+	char* string;
+
+	if (entry.Type & 1) {
+		Length = entry.Length;
+		string = (char *) malloc(Length + 1);
+		if (str->Seek(entry.Offset + Offset, GEM_STREAM_START) == GEM_ERROR ||
+			str->Read(string, Length) == GEM_ERROR) {
+			Length = 0;
+		}
+	} else {
+		Length = 0;
+		string = (char *) malloc(1);
+	}
+	string[Length] = 0;
+	return string;
+}
+
+void TLKImporter::PlayEntrySound(ieWord type, const ieResRef SoundResRef, ieDword flags) const
+{
+	if (( type & 2 ) && ( flags & IE_STR_SOUND )) {
+		//if flags&IE_STR_SOUND play soundresref
+		if (SoundResRef[0] != 0) {
+			int xpos = 0;
+			int ypos = 0;
+			unsigned int flag = GEM_SND_RELATIVE | (flags&(GEM_SND_SPEECH|GEM_SND_QUEUE));
+			//IE_STR_SPEECH will stop the previous sound source
+			core->GetAudioDrv()->Play(SoundResRef, SFX_CHAN_DIALOG, xpos, ypos, flag);
+		}
+	}
+}
+
 String* TLKImporter::GetString(ieStrRef strref, ieDword flags)
 {
+	// fast path: untagged strings don't depend on game state, so their decoded form can be reused
+	const TLKEntry* entry = GetCacheableEntry(strref, flags);
+	if (entry) {
+		const String* cached = stringCache.Lookup(strref);
+		if (!cached) {
+			int Length;
+			char* cstr = ReadEntryText(*entry, Length);
+			String* string = StringFromCString(cstr);
+			free(cstr);
+			cached = stringCache.Add(strref, *string);
+			delete string;
+		}
+		PlayEntrySound(entry->Type, entry->SoundResRef, flags);
+		return new String(*cached);
+	}
+
 	char* cstr = GetCString(strref, flags);
 	String* string = StringFromCString(cstr);
 	free(cstr);
@@ -436,6 +582,7 @@ char* TLKImporter::GetCString(ieStrRef strref, ieDword flags)
 	ieWord type;
 	int Length;
 	ieResRef SoundResRef;
+	bool tagged;
 
 	if((strref>=STRREF_START) || (strref>=BIO_START && strref<=BIO_END) ) {
 empty:
@@ -448,39 +595,20 @@ empty:
 		}
 		type = 0;
 		SoundResRef[0]=0;
+		tagged = true;
 	} else {
-		ieDword Volume, Pitch, StrOffset;
-		ieDword l;
-		if (str->Seek( 18 + ( strref * 0x1A ), GEM_STREAM_START ) == GEM_ERROR) {
+		if (strref >= StrRefCount) {
 			return strdup("");
 		}
-		str->ReadWord( &type );
-		str->ReadResRef( SoundResRef );
-		// volume and pitch variance fields are known to be unused at minimum in bg1
-		str->ReadDword( &Volume );
-		str->ReadDword( &Pitch );
-		str->ReadDword( &StrOffset );
-		str->ReadDword( &l );
-		if (l > 65535) {
-			Length = 65535; //safety limit, it could be a dword actually
-		}
-		else {
-			Length = l;
-		}
-		
-		if (type & 1) {
-			str->Seek( StrOffset + Offset, GEM_STREAM_START );
-			string = ( char * ) malloc( Length + 1 );
-			str->Read( string, Length );
-		} else {
-			Length = 0;
-			string = ( char * ) malloc( 1 );
-		}
-		string[Length] = 0; 
+		const TLKEntry& entry = entries[strref];
+		type = entry.Type;
+		CopyResRef(SoundResRef, entry.SoundResRef);
+		tagged = entry.Tagged;
+		string = ReadEntryText(entry, Length);
 	}
 
 	//tagged text, bg1 and iwd don't mark them specifically, all entries are tagged
-	if (core->HasFeature( GF_ALL_STRINGS_TAGGED ) || ( type & 4 )) {
+	if (tagged && (core->HasFeature( GF_ALL_STRINGS_TAGGED ) || ( type & 4 ))) {
 		//GetNewStringLength will look in string and return true
 		//if the new Length will change due to tokens
 		//if there is no new length, we are done
@@ -492,16 +620,7 @@ empty:
 			string = string2;
 		}
 	}
-	if (( type & 2 ) && ( flags & IE_STR_SOUND )) {
-		//if flags&IE_STR_SOUND play soundresref
-		if (SoundResRef[0] != 0) {
-			int xpos = 0;
-			int ypos = 0;
-			unsigned int flag = GEM_SND_RELATIVE | (flags&(GEM_SND_SPEECH|GEM_SND_QUEUE));
-			//IE_STR_SPEECH will stop the previous sound source
-			core->GetAudioDrv()->Play(SoundResRef, SFX_CHAN_DIALOG, xpos, ypos, flag);
-		}
-	}
+	PlayEntrySound(type, SoundResRef, flags);
 	if (flags & IE_STR_STRREFON) {
 		char* string2 = ( char* ) malloc( Length + 13 );
 		sprintf( string2, "%u: %s", strref, string );
@@ -530,12 +649,7 @@ StringBlock TLKImporter::GetStringBlock(ieStrRef strref, unsigned int flags)
 empty:
 		return StringBlock();
 	}
-	ieWord type;
-	str->Seek( 18 + ( strref * 0x1A ), GEM_STREAM_START );
-	str->ReadWord( &type );
-	ieResRef soundRef;
-	str->ReadResRef( soundRef );
-	return StringBlock(GetString( strref, flags ), soundRef);
+	return StringBlock(GetString( strref, flags ), entries[strref].SoundResRef);
 }
 
 #include "plugindef.h"
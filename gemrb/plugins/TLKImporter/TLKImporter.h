@@ -25,8 +25,36 @@
 
 #include "TlkOverride.h"
 
+#include <list>
+#include <unordered_map>
+#include <vector>
+
 namespace GemRB {
 
+struct TLKEntry {
+	ieDword Offset;
+	ieDword Length;
+	ieWord Type;
+	// the text contains tokens or voice actor directives
+	bool Tagged;
+	ieResRef SoundResRef;
+};
+
+// keeps the decoded text of the most recently used untagged strings
+class DecodedStringCache {
+private:
+	typedef std::list<std::pair<ieStrRef, String> > EntryList;
+	EntryList entries;
+	std::unordered_map<ieStrRef, EntryList::iterator> index;
+	size_t capacity;
+
+public:
+	explicit DecodedStringCache(size_t capacity);
+	const String* Lookup(ieStrRef strref);
+	const String* Add(ieStrRef strref, const String& string);
+	void Clear();
+};
+
 class TLKImporter : public StringMgr {
 private:
 	DataStream* str;
@@ -35,6 +63,8 @@ private:
 	ieWord Language;
 	ieDword StrRefCount, Offset;
 	CTlkOverride *OverrideTLK;
+	std::vector<TLKEntry> entries;
+	DecodedStringCache stringCache;
 
 public:
 	TLKImporter(void);
@@ -52,7 +82,13 @@ public:
 	StringBlock GetStringBlock(ieStrRef strref, unsigned int flags = 0);
 	void FreeString(char *str);
 	bool HasAltTLK() const;
+	ieDword GetStrRefCount() const;
 private:
+	/** returns the table entry of strref, if it can be served from the string cache */
+	const TLKEntry* GetCacheableEntry(ieStrRef strref, ieDword flags) const;
+	/** reads the raw text of an entry, the caller has to free it */
+	char* ReadEntryText(const TLKEntry& entry, int& Length);
+	void PlayEntrySound(ieWord type, const ieResRef SoundResRef, ieDword flags) const;
 	/** resolves day and monthname tokens */
 	void GetMonthName(int dayandmonth);
 	/** replaces tags in dest, don't exceed Length */
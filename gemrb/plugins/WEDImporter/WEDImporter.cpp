@@ -22,6 +22,7 @@
 
 #include "win32def.h"
 
+#include "Animation.h"
 #include "GameData.h"
 #include "Interface.h"
 #include "PluginMgr.h"
@@ -140,7 +141,8 @@ int WEDImporter::AddOverlay(TileMap *tm, Overlay *overlays, bool rain)
 	}
 	PluginHolder<TileSetMgr> tis(IE_TIS_CLASS_ID);
 	tis->Open( tisfile );
-	TileOverlay *over = new TileOverlay( overlays->Width, overlays->Height );
+	// the tiles are only decoded once drawn, so the overlay keeps the tileset
+	TileOverlay *over = new TileOverlay( overlays->Width, overlays->Height, tis );
 	for (int y = 0; y < overlays->Height; y++) {
 		for (int x = 0; x < overlays->Width; x++) {
 			str->Seek( overlays->TilemapOffset +
@@ -166,12 +168,11 @@ int WEDImporter::AddOverlay(TileMap *tm, Overlay *overlays, bool rain)
 			}
 			Tile* tile;
 			if (secondary == 0xffff) {
-				tile = tis->GetTile( indices, count );
+				tile = new Tile( indices, count );
 			} else {
-				tile = tis->GetTile( indices, 1, &secondary );
-				tile->anim[1]->fps = animspeed;
+				tile = new Tile( indices, 1, &secondary );
 			}
-			tile->anim[0]->fps = animspeed;
+			tile->fps = animspeed;
 			tile->om = overlaymask;
 			usedoverlays |= overlaymask;
 			over->AddTile( tile );